@@ -0,0 +1,104 @@
+// Compares the bias addition and activation of a convolution output with the
+// four element kernel against the kernel selected for the processor, which
+// uses eight element AVX vectors and fused multiply-adds if supported. The
+// output has a row per channel, as passed by MlasConv to MlasActivation.
+//
+// usage: bench_activation [channels] [height] [width] [iterations]
+
+#include <cstdint>
+#include <vector>
+
+#include "mlasi.h"
+#include "bench_util.h"
+
+template <typename Fn>
+static double best_time_us(long iterations, Fn fn) {
+  fn();
+
+  double best = 1e30;
+
+  for (long i = 0; i < iterations; ++i) {
+    double start = now_us();
+    fn();
+    best = std::min(best, now_us() - start);
+  }
+
+  return best;
+}
+
+int main(int argc, char** argv) {
+  long channels = arg_or(argc, argv, 1, 64);
+  long height = arg_or(argc, argv, 2, 112);
+  long width = arg_or(argc, argv, 3, 112);
+  long iterations = arg_or(argc, argv, 4, 50);
+
+  const size_t output_size = size_t(height) * size_t(width);
+
+  std::vector<float> output(size_t(channels) * output_size);
+  std::vector<float> bias(channels);
+
+  for (size_t i = 0; i < output.size(); ++i) output[i] = float(int(i % 83) - 41) * 0.1f;
+  for (size_t i = 0; i < bias.size(); ++i) bias[i] = float(i % 5) - 2.0f;
+
+  std::vector<float> buffer(output.size());
+
+  struct {
+    const char* name;
+    MLAS_ACTIVATION_KIND kind;
+  } kinds[] = {
+      {"identity + bias", MlasIdentityActivation},
+      {"relu", MlasReluActivation},
+      {"leaky relu", MlasLeakyReluActivation},
+      {"tanh", MlasTanhActivation},
+      {"logistic", MlasLogisticActivation},
+      {"clip", MlasClipActivation},
+      {"hard sigmoid", MlasHardSigmoidActivation},
+      {"gelu erf", MlasGeluErfActivation},
+      {"gelu tanh", MlasGeluTanhActivation},
+      {"silu", MlasSiluActivation},
+      {"mish", MlasMishActivation},
+      {"hard swish", MlasHardSwishActivation},
+  };
+
+  MLAS_ACTIVATION_FLOAT_KERNEL* kernel = GetMlasPlatform().ActivationFloatKernel;
+
+  std::printf("output %ld x %ld x %ld, %s kernel\n", channels, height, width,
+              kernel == MlasActivationFloatKernelFma3 ? "fma3"
+              : kernel == MlasActivationFloatKernelAvx ? "avx"
+                                                         : "4-wide");
+  std::printf("%-16s %12s %12s %8s\n", "activation", "4-wide us", "dispatch us", "speedup");
+
+  for (const auto& k : kinds) {
+    MLAS_ACTIVATION activation;
+    activation.ActivationKind = k.kind;
+    activation.Parameters.Values[0] = 0.2f;
+    activation.Parameters.Values[1] = 0.5f;
+
+    if (k.kind == MlasClipActivation) {
+      activation.Parameters.Clip.minimum = -1.0f;
+      activation.Parameters.Clip.maximum = 6.0f;
+    }
+
+    // restore the output before each run so that the activations see the
+    // same range of values
+    double baseline = best_time_us(iterations, [&]() {
+      std::copy(output.begin(), output.end(), buffer.begin());
+      MlasActivationFloatKernel(&activation, buffer.data(), bias.data(), size_t(channels), output_size, output_size);
+    });
+
+    double dispatched = best_time_us(iterations, [&]() {
+      std::copy(output.begin(), output.end(), buffer.begin());
+      kernel(&activation, buffer.data(), bias.data(), size_t(channels), output_size, output_size);
+    });
+
+    double copy = best_time_us(iterations, [&]() { std::copy(output.begin(), output.end(), buffer.begin()); });
+
+    baseline = std::max(baseline - copy, 0.0);
+    dispatched = std::max(dispatched - copy, 0.0);
+
+    std::printf("%-16s %12.1f %12.1f %7.2fx\n", k.name, baseline, dispatched,
+                dispatched > 0.0 ? baseline / dispatched : 0.0);
+  }
+
+  return 0;
+}
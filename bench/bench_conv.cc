@@ -0,0 +1,198 @@
+// Compares the implicit GEMM convolution, which gathers the convolution
+// patches directly into the packed buffers of the GEMM, against expanding the
+// whole input with im2col (2D) or vol2col (3D) and then invoking the GEMM, and
+// against the algorithm selected by MlasConvPrepare, with the filter as is and
+// with the filter packed by MlasConvPackFilter, and against the convolution of
+// the same tensors in the NHWC format. The convolution uses 3x3 (or 3x3x3)
+// kernels with padding 1.
+//
+// usage: bench_conv [threads] [dimensions] [channels] [filters] [size] [iterations]
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "bench_util.h"
+
+static const char* algorithm_name(MLAS_CONV_ALGORITHM algorithm) {
+  switch (algorithm) {
+    case MlasConvAlgorithmGemmDirect:
+      return "gemm direct";
+    case MlasConvAlgorithmExpandThenGemm:
+      return "expand then gemm";
+    case MlasConvAlgorithmExpandThenGemmSegmented:
+      return "expand then gemm segmented";
+    case MlasConvAlgorithmImplicitGemm:
+      return "implicit gemm";
+    case MlasConvAlgorithmWinograd:
+      return "winograd";
+    case MlasConvAlgorithmNhwcGemm:
+      return "nhwc gemm";
+    default:
+      return "other";
+  }
+}
+
+template <typename Fn>
+static double best_time_us(long iterations, Fn fn) {
+  fn();
+
+  double best = 1e30;
+
+  for (long i = 0; i < iterations; ++i) {
+    double start = now_us();
+    fn();
+    best = std::min(best, now_us() - start);
+  }
+
+  return best;
+}
+
+int main(int argc, char** argv) {
+  long threads = arg_or(argc, argv, 1, 4);
+  long dimensions = arg_or(argc, argv, 2, 2);
+  long channels = arg_or(argc, argv, 3, 64);
+  long filters = arg_or(argc, argv, 4, 128);
+  long size = arg_or(argc, argv, 5, 56);
+  long iterations = arg_or(argc, argv, 6, 10);
+
+  if (dimensions != 2 && dimensions != 3) {
+    std::fprintf(stderr, "dimensions must be 2 or 3\n");
+    return 1;
+  }
+
+  int64_t input_shape[3];
+  int64_t kernel_shape[3];
+  int64_t dilation_shape[3];
+  int64_t padding[6];
+  int64_t stride_shape[3];
+
+  size_t spatial = 1;
+
+  for (long dim = 0; dim < dimensions; ++dim) {
+    input_shape[dim] = size;
+    kernel_shape[dim] = 3;
+    dilation_shape[dim] = 1;
+    padding[dim] = 1;
+    padding[dim + dimensions] = 1;
+    stride_shape[dim] = 1;
+    spatial *= size_t(size);
+  }
+
+  std::vector<float> input(size_t(channels) * spatial);
+  std::vector<float> filter(size_t(filters) * channels * (dimensions == 2 ? 9 : 27));
+  std::vector<float> bias(filters);
+  std::vector<float> reference(size_t(filters) * spatial);
+  std::vector<float> output(size_t(filters) * spatial);
+
+  for (size_t i = 0; i < input.size(); ++i) input[i] = float(i % 13) / 13 - 0.5f;
+  for (size_t i = 0; i < filter.size(); ++i) filter[i] = float(i % 7) / 7 - 0.5f;
+  for (size_t i = 0; i < bias.size(); ++i) bias[i] = float(i % 3) / 3;
+
+  MLAS_THREADPOOL* tp = MlasCreateThreadPool(size_t(threads));
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+
+  MLAS_CONV_PARAMETERS parameters;
+  size_t working_buffer_size;
+
+  MlasConvPrepare(&parameters, size_t(dimensions), 1, 1, size_t(channels), input_shape, kernel_shape, dilation_shape,
+                  padding, stride_shape, input_shape, size_t(filters), &activation, &working_buffer_size, 0.0f, tp);
+
+  const double flops = 2.0 * double(filters) * double(parameters.OutputSize) * double(parameters.K);
+
+  std::printf("%ldD, channels %ld, filters %ld, size %ld, threads %ld, K %zu, N %zu\n", dimensions, channels,
+              filters, size, threads, parameters.K, parameters.OutputSize);
+
+  std::vector<float> packed_filter(MlasConvPackFilterSize(&parameters) / sizeof(float));
+  MlasConvPackFilter(&parameters, filter.data(), packed_filter.data());
+
+  auto run = [&](const char* name, MLAS_CONV_ALGORITHM algorithm, size_t buffer_size, float* result,
+                 bool packed = false) {
+    MLAS_CONV_PARAMETERS p = parameters;
+    p.Algorithm = algorithm;
+    p.FilterIsPacked = packed;
+
+    std::vector<float> working_buffer(buffer_size);
+    const float* conv_filter = packed ? packed_filter.data() : filter.data();
+
+    double elapsed = best_time_us(iterations, [&]() {
+      MlasConv(&p, input.data(), conv_filter, bias.data(), working_buffer.data(), result, tp);
+    });
+
+    float diff = 0;
+    for (size_t i = 0; i < output.size(); ++i) diff = std::max(diff, std::fabs(result[i] - reference[i]));
+
+    std::printf("%-36s %10.1f ms  %8.2f GFLOPS  buffer %8.2f MB  diff %g\n", name, elapsed / 1000.0,
+                flops / (elapsed * 1000.0), double(buffer_size * sizeof(float)) / (1024 * 1024), diff);
+  };
+
+  const char* expand_name = (dimensions == 2) ? "im2col then gemm" : "vol2col then gemm";
+
+  run(expand_name, MlasConvAlgorithmExpandThenGemm, parameters.OutputSize * parameters.K, reference.data());
+  run("implicit gemm", MlasConvAlgorithmImplicitGemm, 0, output.data());
+
+  if (parameters.Algorithm != MlasConvAlgorithmExpandThenGemm &&
+      parameters.Algorithm != MlasConvAlgorithmImplicitGemm) {
+    std::string name = std::string("prepared: ") + algorithm_name(parameters.Algorithm);
+    run(name.c_str(), parameters.Algorithm, working_buffer_size, output.data());
+  }
+
+  std::string name = std::string("prepared, packed: ") + algorithm_name(parameters.Algorithm);
+  run(name.c_str(), parameters.Algorithm, working_buffer_size, output.data(), true);
+
+  //
+  // Convolve the input transposed to NHWC, without converting the layout as
+  // part of the convolution.
+  //
+
+  MLAS_CONV_PARAMETERS nhwc_parameters;
+  size_t nhwc_working_buffer_size;
+
+  MlasConvPrepare(&nhwc_parameters, size_t(dimensions), 1, 1, size_t(channels), input_shape, kernel_shape,
+                  dilation_shape, padding, stride_shape, input_shape, size_t(filters), &activation,
+                  &nhwc_working_buffer_size, 0.0f, tp, true);
+
+  std::vector<float> nhwc_input(input.size());
+  std::vector<float> nhwc_output(output.size());
+
+  for (size_t c = 0; c < size_t(channels); ++c) {
+    for (size_t i = 0; i < spatial; ++i) nhwc_input[i * channels + c] = input[c * spatial + i];
+  }
+
+  const size_t alignment = MlasGetPreferredBufferAlignment();
+  std::vector<uint8_t> nhwc_packed_buffer(MlasConvPackFilterSize(&nhwc_parameters) + alignment);
+  float* nhwc_packed =
+      reinterpret_cast<float*>((uintptr_t(nhwc_packed_buffer.data()) + alignment - 1) & ~(alignment - 1));
+  MlasConvPackFilter(&nhwc_parameters, filter.data(), nhwc_packed);
+
+  for (bool packed : {false, true}) {
+    MLAS_CONV_PARAMETERS p = nhwc_parameters;
+    p.FilterIsPacked = packed;
+
+    std::vector<float> working_buffer(nhwc_working_buffer_size);
+    const float* conv_filter = packed ? nhwc_packed : filter.data();
+
+    double elapsed = best_time_us(iterations, [&]() {
+      MlasConv(&p, nhwc_input.data(), conv_filter, bias.data(), working_buffer.data(), nhwc_output.data(), tp);
+    });
+
+    float diff = 0;
+    for (size_t f = 0; f < size_t(filters); ++f) {
+      for (size_t i = 0; i < spatial; ++i) {
+        diff = std::max(diff, std::fabs(nhwc_output[i * filters + f] - reference[f * spatial + i]));
+      }
+    }
+
+    std::printf("%-36s %10.1f ms  %8.2f GFLOPS  buffer %8.2f MB  diff %g\n",
+                packed ? "nhwc, packed" : "nhwc", elapsed / 1000.0, flops / (elapsed * 1000.0),
+                double(nhwc_working_buffer_size * sizeof(float)) / (1024 * 1024), diff);
+  }
+
+  MlasDestroyThreadPool(tp);
+
+  return 0;
+}
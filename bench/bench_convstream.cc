@@ -0,0 +1,112 @@
+// Compares the per-frame cost of a streaming causal convolution, which keeps
+// the history of the stream and convolves only the new frame, against running
+// MlasConv over a window of the last frames for each new frame. The
+// convolution is over time and frequency with channels in and out, as in
+// test_conv2d, with the frequency dimension padded to keep its size.
+//
+// usage: bench_convstream [threads] [channels] [width] [kernel_time] [window] [iterations]
+
+#include <cstdint>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "bench_util.h"
+
+template <typename Fn>
+static double best_time_us(long iterations, Fn fn) {
+  fn();
+
+  double best = 1e30;
+
+  for (long i = 0; i < iterations; ++i) {
+    double start = now_us();
+    fn();
+    best = std::min(best, now_us() - start);
+  }
+
+  return best;
+}
+
+int main(int argc, char** argv) {
+  long threads = arg_or(argc, argv, 1, 1);
+  long channels = arg_or(argc, argv, 2, 48);
+  long width = arg_or(argc, argv, 3, 40);
+  long kernel_time = arg_or(argc, argv, 4, 2);
+  long window = arg_or(argc, argv, 5, 40);
+  long iterations = arg_or(argc, argv, 6, 100);
+
+  const int64_t kernel_shape[] = {kernel_time, 3};
+  const int64_t dilation_shape[] = {1, 1};
+  const int64_t stride_shape[] = {1, 1};
+
+  std::vector<float> filter(size_t(channels) * channels * kernel_time * 3);
+  std::vector<float> bias(channels);
+
+  for (size_t i = 0; i < filter.size(); ++i) filter[i] = float(i % 7) / 7 - 0.5f;
+  for (size_t i = 0; i < bias.size(); ++i) bias[i] = float(i % 3) / 3;
+
+  MLAS_THREADPOOL* tp = MlasCreateThreadPool(size_t(threads));
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+
+  std::printf("channels %ld, width %ld, kernel time %ld, window %ld, threads %ld\n", channels, width, kernel_time,
+              window, threads);
+
+  //
+  // Convolve a window of the last frames, with causal padding, and keep the
+  // output of the last frame.
+  //
+
+  const int64_t window_shape[] = {window, width};
+  const int64_t window_padding[] = {kernel_time - 1, 1, 0, 1};
+
+  MLAS_CONV_PARAMETERS parameters;
+  size_t working_buffer_size;
+
+  MlasConvPrepare(&parameters, 2, 1, 1, size_t(channels), window_shape, kernel_shape, dilation_shape, window_padding,
+                  stride_shape, window_shape, size_t(channels), &activation, &working_buffer_size, 0.0f, tp);
+
+  std::vector<float> window_input(size_t(channels) * window * width, 0.5f);
+  std::vector<float> window_output(window_input.size());
+  std::vector<float> working_buffer(working_buffer_size);
+
+  double window_us = best_time_us(iterations, [&]() {
+    MlasConv(&parameters, window_input.data(), filter.data(), bias.data(), working_buffer.data(),
+             window_output.data(), tp);
+  });
+
+  //
+  // Convolve only the new frame against the history of the stream.
+  //
+
+  const int64_t frame_shape[] = {1, width};
+  const int64_t frame_padding[] = {0, 1, 0, 1};
+
+  MLAS_CONV_STREAM_PARAMETERS stream_parameters;
+  size_t state_size;
+  size_t stream_working_buffer_size;
+
+  MlasConvStreamPrepare(&stream_parameters, 2, 1, size_t(channels), frame_shape, kernel_shape, dilation_shape,
+                        frame_padding, stride_shape, size_t(channels), &activation, &state_size,
+                        &stream_working_buffer_size, tp);
+
+  std::vector<float> state(state_size);
+  std::vector<float> frame_input(size_t(channels) * width, 0.5f);
+  std::vector<float> frame_output(frame_input.size());
+  std::vector<float> stream_working_buffer(stream_working_buffer_size);
+
+  MlasConvStreamReset(&stream_parameters, state.data());
+
+  double stream_us = best_time_us(iterations, [&]() {
+    MlasConvStream(&stream_parameters, frame_input.data(), filter.data(), bias.data(), state.data(),
+                   stream_working_buffer.data(), frame_output.data(), tp);
+  });
+
+  std::printf("%-24s %10.1f us/frame\n", "window", window_us);
+  std::printf("%-24s %10.1f us/frame  speedup %.1fx\n", "stream", stream_us, window_us / stream_us);
+
+  MlasDestroyThreadPool(tp);
+
+  return 0;
+}
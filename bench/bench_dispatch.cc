@@ -0,0 +1,73 @@
+// Measures the fixed cost of dispatching tiny SGEMMs through the threading
+// layer: the time and the number of heap allocations per call.
+//
+// usage: bench_dispatch [threads] [calls]
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "bench_util.h"
+
+static std::atomic<size_t> allocations{0};
+
+void* operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+static void run(MLAS_THREADPOOL* tp, size_t m, size_t n, size_t k, size_t batch, long calls) {
+  std::vector<float> A(batch * m * k, 0.5f);
+  std::vector<float> B(batch * k * n, 0.25f);
+  std::vector<float> C(batch * m * n);
+
+  std::vector<MLAS_SGEMM_DATA_PARAMS> data(batch);
+
+  for (size_t b = 0; b < batch; ++b) {
+    data[b].A = &A[b * m * k];
+    data[b].lda = k;
+    data[b].B = &B[b * k * n];
+    data[b].ldb = n;
+    data[b].C = &C[b * m * n];
+    data[b].ldc = n;
+  }
+
+  for (int i = 0; i < 100; ++i) MlasGemmBatch(CblasNoTrans, CblasNoTrans, m, n, k, data.data(), batch, tp);
+
+  size_t allocations_before = allocations.load();
+  double start = now_us();
+
+  for (long i = 0; i < calls; ++i) MlasGemmBatch(CblasNoTrans, CblasNoTrans, m, n, k, data.data(), batch, tp);
+
+  double elapsed = now_us() - start;
+  size_t allocated = allocations.load() - allocations_before;
+
+  std::printf("sgemm %3zux%3zux%3zu batch %2zu: %8.1f ns/call, %.2f allocations/call\n",
+              m, n, k, batch, elapsed * 1000.0 / double(calls), double(allocated) / double(calls));
+}
+
+int main(int argc, char** argv) {
+  long threads = arg_or(argc, argv, 1, 4);
+  long calls = arg_or(argc, argv, 2, 100000);
+
+  MLAS_THREADPOOL* tp = MlasCreateThreadPool(size_t(threads));
+
+  std::printf("threads %ld, calls %ld\n", threads, calls);
+
+  run(tp, 1, 16, 16, 1, calls);
+  run(tp, 4, 4, 4, 1, calls);
+  run(tp, 16, 16, 16, 1, calls);
+  run(tp, 32, 32, 32, 1, calls);
+  run(tp, 4, 4, 4, 8, calls / 4);
+  run(tp, 16, 16, 16, 8, calls / 4);
+
+  MlasDestroyThreadPool(tp);
+
+  return 0;
+}
@@ -0,0 +1,85 @@
+// Measures the fork/join overhead of small multithreaded SGEMMs for each
+// thread pool wait policy. The single threaded time of the same GEMM is
+// reported as a reference. Optionally, the calling thread does other work
+// between GEMMs, as in batch 1 inference where GEMMs are separated by other
+// operators.
+//
+// usage: bench_forkjoin [threads] [runs] [gap_us] [spin_us]
+
+#include <thread>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "bench_util.h"
+
+static void busy_wait_us(double us) {
+  double end = now_us() + us;
+  while (now_us() < end) {
+  }
+}
+
+static latency_stats run(MLAS_THREADPOOL* tp, size_t m, size_t n, size_t k, long runs, double gap_us) {
+  std::vector<float> A(m * k, 0.5f);
+  std::vector<float> B(k * n, 0.25f);
+  std::vector<float> C(m * n);
+
+  auto gemm = [&]() {
+    MlasGemm(CblasNoTrans, CblasNoTrans, m, n, k, 1.0f, A.data(), k, B.data(), n, 0.0f, C.data(), n, tp);
+  };
+
+  for (int i = 0; i < 20; ++i) gemm();
+
+  std::vector<double> samples;
+  samples.reserve(runs);
+
+  for (long i = 0; i < runs; ++i) {
+    if (gap_us > 0) busy_wait_us(gap_us);
+    double start = now_us();
+    gemm();
+    samples.push_back(now_us() - start);
+  }
+
+  return summarize(samples);
+}
+
+int main(int argc, char** argv) {
+  long hardware_threads = long(std::thread::hardware_concurrency());
+  if (hardware_threads < 1) hardware_threads = 1;
+
+  long threads = arg_or(argc, argv, 1, hardware_threads);
+  long runs = arg_or(argc, argv, 2, 2000);
+  double gap_us = double(arg_or(argc, argv, 3, 0));
+  uint32_t spin_us = uint32_t(arg_or(argc, argv, 4, 50));
+
+  std::printf("threads %ld, runs %ld, gap %.0f us, spin %u us\n", threads, runs, gap_us, spin_us);
+
+  MLAS_THREADPOOL* serial = MlasCreateThreadPool(1);
+  MLAS_THREADPOOL* tp = MlasCreateThreadPool(size_t(threads));
+
+  const size_t shapes[][3] = {{32, 64, 64}, {64, 64, 64}, {64, 128, 128}, {128, 128, 128}};
+
+  const struct {
+    const char* name;
+    MLAS_THREADPOOL_WAIT_POLICY policy;
+  } policies[] = {
+      {"block", MlasThreadPoolWaitBlock},
+      {"spin then yield", MlasThreadPoolWaitSpinThenYield},
+      {"spin", MlasThreadPoolWaitSpin},
+  };
+
+  for (const auto& shape : shapes) {
+    std::printf("\nsgemm %zux%zux%zu\n", shape[0], shape[1], shape[2]);
+
+    print_stats("single thread", run(serial, shape[0], shape[1], shape[2], runs, gap_us));
+
+    for (const auto& policy : policies) {
+      MlasSetThreadPoolWaitPolicy(tp, policy.policy, spin_us);
+      print_stats(policy.name, run(tp, shape[0], shape[1], shape[2], runs, gap_us));
+    }
+  }
+
+  MlasDestroyThreadPool(tp);
+  MlasDestroyThreadPool(serial);
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+// Measures the latency distribution of a multithreaded SGEMM while other
+// threads compete for the same cores, comparing the static and the work
+// stealing thread pool schedules.
+//
+// usage: bench_oversubscription [threads] [busy_threads] [runs] [size]
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "bench_util.h"
+
+static latency_stats run(MLAS_THREADPOOL* tp, MLAS_THREADPOOL_SCHEDULE schedule, size_t size, long runs) {
+  std::vector<float> A(size * size, 0.5f);
+  std::vector<float> B(size * size, 0.25f);
+  std::vector<float> C(size * size);
+
+  MlasSetThreadPoolSchedule(tp, schedule);
+
+  auto gemm = [&]() {
+    MlasGemm(CblasNoTrans, CblasNoTrans, size, size, size, 1.0f, A.data(), size, B.data(), size,
+             0.0f, C.data(), size, tp);
+  };
+
+  for (int i = 0; i < 5; ++i) gemm();
+
+  std::vector<double> samples;
+  samples.reserve(runs);
+
+  for (long i = 0; i < runs; ++i) {
+    double start = now_us();
+    gemm();
+    samples.push_back(now_us() - start);
+  }
+
+  return summarize(samples);
+}
+
+int main(int argc, char** argv) {
+  long hardware_threads = long(std::thread::hardware_concurrency());
+  if (hardware_threads < 1) hardware_threads = 1;
+
+  long threads = arg_or(argc, argv, 1, hardware_threads);
+  long busy_threads = arg_or(argc, argv, 2, (threads + 1) / 2);
+  long runs = arg_or(argc, argv, 3, 200);
+  size_t size = size_t(arg_or(argc, argv, 4, 384));
+
+  std::printf("threads %ld, busy threads %ld, runs %ld, sgemm %zux%zux%zu\n",
+              threads, busy_threads, runs, size, size, size);
+
+  MLAS_THREADPOOL* tp = MlasCreateThreadPool(size_t(threads));
+
+  // Other tenants of the machine: threads that keep cores busy so that some
+  // pool threads are preempted during each GEMM.
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> busy;
+
+  for (long i = 0; i < busy_threads; ++i) {
+    busy.emplace_back([&stop]() {
+      volatile unsigned counter = 0;
+      while (!stop.load(std::memory_order_relaxed)) counter = counter + 1;
+    });
+  }
+
+  print_stats("static", run(tp, MlasThreadPoolScheduleStatic, size, runs));
+  print_stats("work stealing", run(tp, MlasThreadPoolScheduleWorkStealing, size, runs));
+
+  stop = true;
+  for (auto& thread : busy) thread.join();
+
+  MlasDestroyThreadPool(tp);
+
+  return 0;
+}
@@ -0,0 +1,76 @@
+// Measures the bandwidth of packing a large SGEMM weight matrix, single
+// threaded and on the thread pool, against the bandwidth of memcpy of the same
+// number of bytes. Bandwidth counts the bytes read plus the bytes written.
+//
+// usage: bench_packb [threads] [K] [N] [iterations]
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "bench_util.h"
+
+template <typename Fn>
+static double best_time_us(long iterations, Fn fn) {
+  fn();
+
+  double best = 1e30;
+
+  for (long i = 0; i < iterations; ++i) {
+    double start = now_us();
+    fn();
+    best = std::min(best, now_us() - start);
+  }
+
+  return best;
+}
+
+static void report(const char* name, size_t bytes, double elapsed_us) {
+  std::printf("%-24s %10.1f ms  %8.2f GB/s\n", name, elapsed_us / 1000.0,
+              2.0 * double(bytes) / (elapsed_us * 1000.0));
+}
+
+int main(int argc, char** argv) {
+  long threads = arg_or(argc, argv, 1, 4);
+  size_t K = size_t(arg_or(argc, argv, 2, 4096));
+  size_t N = size_t(arg_or(argc, argv, 3, 16384));
+  long iterations = arg_or(argc, argv, 4, 5);
+
+  const size_t alignment = MlasGetPreferredBufferAlignment();
+  const size_t bytes = K * N * sizeof(float);
+
+  std::vector<float> B(K * N);
+  for (size_t i = 0; i < B.size(); ++i) B[i] = float(i % 17) - 8.0f;
+
+  std::vector<uint8_t> packed_buffer(MlasGemmPackBSize(N, K) + alignment);
+  void* packed = reinterpret_cast<void*>((uintptr_t(packed_buffer.data()) + alignment - 1) & ~(alignment - 1));
+
+  std::vector<float> copy(K * N);
+
+  MLAS_THREADPOOL* tp = MlasCreateThreadPool(size_t(threads));
+
+  std::printf("K %zu, N %zu, threads %ld, %.1f MB\n", K, N, threads, double(bytes) / (1024 * 1024));
+
+  report("memcpy", bytes, best_time_us(iterations, [&]() { std::memcpy(copy.data(), B.data(), bytes); }));
+
+  report("pack", bytes, best_time_us(iterations, [&]() {
+    MlasGemmPackB(CblasNoTrans, N, K, B.data(), N, packed);
+  }));
+
+  report("pack threaded", bytes, best_time_us(iterations, [&]() {
+    MlasGemmPackB(CblasNoTrans, N, K, B.data(), N, packed, tp);
+  }));
+
+  report("pack trans", bytes, best_time_us(iterations, [&]() {
+    MlasGemmPackB(CblasTrans, N, K, B.data(), K, packed);
+  }));
+
+  report("pack trans threaded", bytes, best_time_us(iterations, [&]() {
+    MlasGemmPackB(CblasTrans, N, K, B.data(), K, packed, tp);
+  }));
+
+  MlasDestroyThreadPool(tp);
+
+  return 0;
+}
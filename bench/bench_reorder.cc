@@ -0,0 +1,98 @@
+// Measures the bandwidth of the NCHW and NHWC to/from NCHWc buffer reordering
+// routines, single threaded and on the thread pool, against the bandwidth of
+// memcpy of the same number of bytes. Bandwidth counts the bytes read plus the
+// bytes written.
+//
+// usage: bench_reorder [threads] [batch] [channels] [size] [iterations]
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "bench_util.h"
+
+template <typename Fn>
+static double best_time_us(long iterations, Fn fn) {
+  fn();
+
+  double best = 1e30;
+
+  for (long i = 0; i < iterations; ++i) {
+    double start = now_us();
+    fn();
+    best = std::min(best, now_us() - start);
+  }
+
+  return best;
+}
+
+static void report(const char* name, size_t bytes, double elapsed_us) {
+  std::printf("%-24s %10.2f ms  %8.2f GB/s\n", name, elapsed_us / 1000.0,
+              2.0 * double(bytes) / (elapsed_us * 1000.0));
+}
+
+int main(int argc, char** argv) {
+  long threads = arg_or(argc, argv, 1, 4);
+  long batch = arg_or(argc, argv, 2, 1);
+  long channels = arg_or(argc, argv, 3, 256);
+  long size = arg_or(argc, argv, 4, 112);
+  long iterations = arg_or(argc, argv, 5, 20);
+
+  const size_t block_size = MlasNchwcGetBlockSize();
+  const size_t blocked_channels = (size_t(channels) + block_size - 1) / block_size * block_size;
+  const size_t spatial = size_t(size) * size_t(size);
+  const size_t elements = size_t(batch) * size_t(channels) * spatial;
+  const size_t bytes = elements * sizeof(float);
+
+  std::vector<float> source(elements);
+  for (size_t i = 0; i < source.size(); ++i) source[i] = float(i % 17) - 8.0f;
+
+  std::vector<float> blocked(size_t(batch) * blocked_channels * spatial);
+  std::vector<float> output(elements);
+
+  const int64_t shape[] = {batch, channels, size, size};
+
+  MLAS_THREADPOOL* tp = MlasCreateThreadPool(size_t(threads));
+
+  std::printf("batch %ld, channels %ld, size %ld, threads %ld, block %zu, %.1f MB\n", batch, channels, size, threads,
+              block_size, double(bytes) / (1024 * 1024));
+
+  report("memcpy", bytes, best_time_us(iterations, [&]() { std::memcpy(output.data(), source.data(), bytes); }));
+
+  report("nchw to nchwc", bytes, best_time_us(iterations, [&]() {
+    MlasReorderInputNchw(shape, source.data(), blocked.data(), nullptr);
+  }));
+
+  report("nchw to nchwc threaded", bytes, best_time_us(iterations, [&]() {
+    MlasReorderInputNchw(shape, source.data(), blocked.data(), tp);
+  }));
+
+  report("nchwc to nchw", bytes, best_time_us(iterations, [&]() {
+    MlasReorderOutputNchw(shape, blocked.data(), output.data(), nullptr);
+  }));
+
+  report("nchwc to nchw threaded", bytes, best_time_us(iterations, [&]() {
+    MlasReorderOutputNchw(shape, blocked.data(), output.data(), tp);
+  }));
+
+  report("nchwc to nhwc", bytes, best_time_us(iterations, [&]() {
+    MlasReorderOutputNhwc(shape, blocked.data(), output.data(), nullptr);
+  }));
+
+  report("nchwc to nhwc threaded", bytes, best_time_us(iterations, [&]() {
+    MlasReorderOutputNhwc(shape, blocked.data(), output.data(), tp);
+  }));
+
+  report("nhwc to nchwc", bytes, best_time_us(iterations, [&]() {
+    for (long n = 0; n < batch; ++n) {
+      MlasReorderInputNhwc(output.data() + size_t(n) * channels * spatial,
+                           blocked.data() + size_t(n) * blocked_channels * spatial, size_t(channels), spatial,
+                           spatial);
+    }
+  }));
+
+  MlasDestroyThreadPool(tp);
+
+  return 0;
+}
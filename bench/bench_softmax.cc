@@ -0,0 +1,93 @@
+// Compares the softmax and log softmax of MlasComputeSoftmax against a
+// scalar loop over libm that makes three passes over each row, on one thread
+// and on a thread pool. The default shape is a batch of rows over a large
+// vocabulary; a single row is split across the threads.
+//
+// usage: bench_softmax [rows] [columns] [iterations] [threads]
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "bench_util.h"
+
+template <typename Fn>
+static double best_time_us(long iterations, Fn fn) {
+  fn();
+
+  double best = 1e30;
+
+  for (long i = 0; i < iterations; ++i) {
+    double start = now_us();
+    fn();
+    best = std::min(best, now_us() - start);
+  }
+
+  return best;
+}
+
+static void scalar_softmax(const float* input, float* output, size_t n, size_t d, bool log_softmax) {
+  for (size_t i = 0; i < n; ++i) {
+    const float* x = input + i * d;
+    float* y = output + i * d;
+
+    float maximum = *std::max_element(x, x + d);
+
+    float sum = 0.0f;
+    for (size_t j = 0; j < d; ++j) {
+      float e = std::exp(x[j] - maximum);
+      if (!log_softmax) y[j] = e;
+      sum += e;
+    }
+
+    if (log_softmax) {
+      float logarithm = std::log(sum);
+      for (size_t j = 0; j < d; ++j) y[j] = x[j] - maximum - logarithm;
+    } else {
+      float scale = 1.0f / sum;
+      for (size_t j = 0; j < d; ++j) y[j] *= scale;
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  long rows = arg_or(argc, argv, 1, 8);
+  long columns = arg_or(argc, argv, 2, 50257);
+  long iterations = arg_or(argc, argv, 3, 20);
+  long threads = arg_or(argc, argv, 4, 4);
+
+  std::vector<float> input(size_t(rows) * size_t(columns));
+  std::vector<float> output(input.size());
+
+  for (size_t i = 0; i < input.size(); ++i) input[i] = float(int((i * 7919) % 4001) - 2000) * 0.01f;
+
+  MLAS_THREADPOOL* single_tp = MlasCreateThreadPool(1);
+  MLAS_THREADPOOL* tp = MlasCreateThreadPool(size_t(threads));
+
+  std::printf("%ld x %ld, %ld threads\n", rows, columns, threads);
+  std::printf("%-12s %10s %10s %10s %12s %10s\n", "function", "scalar us", "mlas us", "speedup", "threaded us",
+              "speedup");
+
+  for (bool log_softmax : {false, true}) {
+    double scalar = best_time_us(iterations, [&]() {
+      scalar_softmax(input.data(), output.data(), size_t(rows), size_t(columns), log_softmax);
+    });
+
+    double single = best_time_us(iterations, [&]() {
+      MlasComputeSoftmax(input.data(), output.data(), size_t(rows), size_t(columns), log_softmax, single_tp);
+    });
+
+    double threaded = best_time_us(iterations, [&]() {
+      MlasComputeSoftmax(input.data(), output.data(), size_t(rows), size_t(columns), log_softmax, tp);
+    });
+
+    std::printf("%-12s %10.1f %10.1f %9.2fx %12.1f %9.2fx\n", log_softmax ? "log softmax" : "softmax", scalar,
+                single, scalar / single, threaded, single / threaded);
+  }
+
+  MlasDestroyThreadPool(tp);
+  MlasDestroyThreadPool(single_tp);
+
+  return 0;
+}
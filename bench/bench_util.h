@@ -0,0 +1,56 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Returns the current time in microseconds.
+static inline double now_us() {
+  using clock = std::chrono::steady_clock;
+  return std::chrono::duration<double, std::micro>(clock::now().time_since_epoch()).count();
+}
+
+// Reads an integer command line argument, else returns the default value.
+static inline long arg_or(int argc, char** argv, int index, long value) {
+  return (argc > index) ? std::atol(argv[index]) : value;
+}
+
+// Latency summary of a set of samples, in microseconds.
+struct latency_stats {
+  double mean;
+  double p50;
+  double p90;
+  double p99;
+  double max;
+};
+
+static inline latency_stats summarize(std::vector<double> samples) {
+  latency_stats stats{};
+
+  if (samples.empty()) return stats;
+
+  std::sort(samples.begin(), samples.end());
+
+  auto percentile = [&samples](double p) {
+    size_t index = size_t(p * double(samples.size() - 1) + 0.5);
+    return samples[index];
+  };
+
+  double sum = 0;
+  for (double sample : samples) sum += sample;
+
+  stats.mean = sum / double(samples.size());
+  stats.p50 = percentile(0.50);
+  stats.p90 = percentile(0.90);
+  stats.p99 = percentile(0.99);
+  stats.max = samples.back();
+
+  return stats;
+}
+
+static inline void print_stats(const char* name, const latency_stats& stats) {
+  std::printf("%-24s mean %10.1f  p50 %10.1f  p90 %10.1f  p99 %10.1f  max %10.1f us\n",
+              name, stats.mean, stats.p50, stats.p90, stats.p99, stats.max);
+}
@@ -132,6 +132,140 @@ bool
 
 #endif
 
+#if defined(BUILD_MLAS_NO_ONNXRUNTIME)
+
+//
+// Thread pool routines.
+//
+// N.B. These routines are only available when building MLAS outside of the
+// ONNX Runtime source tree. In this configuration, passing nullptr as the
+// thread pool to any routine selects a process wide default thread pool that
+// is sized from the MLAS_NUM_THREADS environment variable, else from the
+// number of hardware threads.
+//
+
+/**
+ * @brief Create a thread pool object
+ *
+ * @param ThreadCount   Supplies the number of threads that participate in a
+ *                      parallel operation, including the calling thread. Zero
+ *                      selects the number of hardware threads.
+ * @return  The thread pool object, to be released by MlasDestroyThreadPool.
+ */
+MLAS_THREADPOOL*
+    MLASCALL
+    MlasCreateThreadPool(
+        size_t ThreadCount);
+
+void
+    MLASCALL
+    MlasDestroyThreadPool(
+        MLAS_THREADPOOL* ThreadPool);
+
+enum MLAS_THREADPOOL_SCHEDULE {
+  MlasThreadPoolScheduleWorkStealing,
+  MlasThreadPoolScheduleStatic,
+};
+
+/**
+ * @brief Select how a thread pool distributes the iterations of a parallel
+ *        operation. The default is MlasThreadPoolScheduleWorkStealing, where
+ *        threads that finish early take work from threads that fall behind,
+ *        for example because they were preempted. With
+ *        MlasThreadPoolScheduleStatic, each thread only executes its initial
+ *        equal share of the work.
+ *
+ * @param ThreadPool    Supplies the thread pool object, or nullptr to select
+ *                      the default thread pool.
+ * @param Schedule      Supplies the schedule for subsequent operations.
+ */
+void
+    MLASCALL
+    MlasSetThreadPoolSchedule(
+        MLAS_THREADPOOL* ThreadPool,
+        MLAS_THREADPOOL_SCHEDULE Schedule);
+
+enum MLAS_THREADPOOL_WAIT_POLICY {
+  MlasThreadPoolWaitSpin,
+  MlasThreadPoolWaitSpinThenYield,
+  MlasThreadPoolWaitBlock,
+};
+
+/**
+ * @brief Select how idle threads of a thread pool wait for work and how the
+ *        calling thread waits for a parallel operation to complete.
+ *
+ *        MlasThreadPoolWaitSpin busy waits for up to the spin duration before
+ *        sleeping. MlasThreadPoolWaitSpinThenYield busy waits briefly, then
+ *        yields the processor between polls until the spin duration expires
+ *        before sleeping (the default). MlasThreadPoolWaitBlock sleeps
+ *        immediately. Spinning avoids the latency of waking a sleeping thread
+ *        for operations that are submitted back to back, at the cost of
+ *        processor time.
+ *
+ *        The defaults of every thread pool can be set with the
+ *        MLAS_WAIT_POLICY (spin, yield or block) and MLAS_SPIN_DURATION_US
+ *        environment variables.
+ *
+ * @param ThreadPool                Supplies the thread pool object, or nullptr
+ *                                  to select the default thread pool.
+ * @param WaitPolicy                Supplies the wait policy.
+ * @param SpinDurationMicroseconds  Supplies the time to spin before sleeping.
+ */
+void
+    MLASCALL
+    MlasSetThreadPoolWaitPolicy(
+        MLAS_THREADPOOL* ThreadPool,
+        MLAS_THREADPOOL_WAIT_POLICY WaitPolicy,
+        uint32_t SpinDurationMicroseconds);
+
+//
+// Asynchronous operation routines.
+//
+// N.B. An asynchronous operation is executed by a dispatcher thread of the
+// thread pool, which submits the parallel work of the operation to the pool
+// in place of the caller. Operations submitted to the same thread pool
+// execute in submission order. The caller must keep the buffers and
+// parameters referenced by the operation valid until the operation has
+// completed.
+//
+
+struct MLAS_TASK;
+
+/**
+ * @brief Wait for an asynchronous operation to complete
+ *
+ * @param Task  Supplies the handle of the operation.
+ */
+void
+    MLASCALL
+    MlasWaitTask(
+        MLAS_TASK* Task);
+
+/**
+ * @brief Return whether an asynchronous operation has completed, without
+ *        waiting
+ *
+ * @param Task  Supplies the handle of the operation.
+ */
+bool
+    MLASCALL
+    MlasIsTaskComplete(
+        const MLAS_TASK* Task);
+
+/**
+ * @brief Release the handle of an asynchronous operation. Releasing the handle
+ *        does not cancel the operation.
+ *
+ * @param Task  Supplies the handle of the operation.
+ */
+void
+    MLASCALL
+    MlasReleaseTask(
+        MLAS_TASK* Task);
+
+#endif
+
 //
 // Activation routines.
 //
@@ -144,6 +278,11 @@ enum MLAS_ACTIVATION_KIND {
   MlasLogisticActivation,
   MlasClipActivation,
   MlasHardSigmoidActivation,
+  MlasGeluErfActivation,   /**< x * (1 + erf(x / sqrt(2))) / 2, absolute error below 1e-6 * max(1, |x|) */
+  MlasGeluTanhActivation,  /**< x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))) / 2, same bound */
+  MlasSiluActivation,      /**< x * logistic(x), relative error below 1e-6 for |x| <= 80 */
+  MlasMishActivation,      /**< x * tanh(ln(1 + exp(x))), relative error below 1e-6 for |x| <= 80 */
+  MlasHardSwishActivation, /**< x * max(0, min(1, x / 6 + 1 / 2)) as in ONNX HardSwish */
 };
 
 struct MLAS_ACTIVATION {
@@ -180,6 +319,37 @@ void
 // op(X) = X or op(X) = transpose(X) or op(X) = conjg(transpose(X))
 //
 
+/**
+ * @brief Placement of a packed B buffer on the memory of NUMA nodes
+ */
+enum MLAS_NUMA_PLACEMENT {
+  MlasNumaPlacementDefault,    /**< Pages are placed by the thread that first touches them */
+  MlasNumaPlacementInterleave, /**< Pages are interleaved across the NUMA nodes */
+  MlasNumaPlacementReplicate,  /**< A copy is placed on each NUMA node and used by the threads of that node */
+};
+
+/**
+ * @brief Orientation of the bias vector of a SGEMM epilogue
+ */
+enum MLAS_SGEMM_BIAS_KIND {
+  MlasSgemmBiasPerRow,    /**< The bias vector has M elements, one per row of matrix C */
+  MlasSgemmBiasPerColumn, /**< The bias vector has N elements, one per column of matrix C */
+};
+
+/**
+ * @brief Supply the operations that are fused into a single precision gemm
+ *        function and applied to each tile of matrix C once it is complete:
+ *
+ *        C := Activation(alpha * op(A) * op(B) + beta * C + Bias + Residual)
+ */
+struct MLAS_SGEMM_EPILOGUE {
+  const float* Bias = nullptr;                       /**< Optionally supplies the bias vector */
+  MLAS_SGEMM_BIAS_KIND BiasKind = MlasSgemmBiasPerRow; /**< Supplies the orientation of the bias vector */
+  const MLAS_ACTIVATION* Activation = nullptr;       /**< Optionally supplies the activation, else identity */
+  const float* Residual = nullptr;                   /**< Optionally supplies a M x N matrix to add to matrix C */
+  size_t ldr = 0;                                    /**< Supplies the first dimension of the residual matrix */
+};
+
 /**
  * @brief Supply matrices data information to single precision gemm functions
  */
@@ -193,6 +363,9 @@ struct MLAS_SGEMM_DATA_PARAMS {
   float alpha = 1.0f;       /**< Supplies the scalar alpha multiplier (see SGEMM definition) */
   float beta = 0.0f;        /**< Supplies the scalar beta multiplier (see SGEMM definition) */
   bool BIsPacked = false;   /**< Whether B is pre-packed */
+  bool AIsPacked = false;   /**< Whether A is pre-packed by MlasGemmPackA, which applies TransA and replaces lda */
+  MLAS_NUMA_PLACEMENT BNumaPlacement = MlasNumaPlacementDefault; /**< Placement that pre-packed B was packed with */
+  const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr; /**< Optionally supplies the operations fused after the multiply */
 };
 
 /**
@@ -221,6 +394,43 @@ void
         size_t BatchSize,
         MLAS_THREADPOOL* ThreadPool);
 
+#if defined(BUILD_MLAS_NO_ONNXRUNTIME)
+
+/**
+ * @brief  Asynchronous batched single precision matrix/matrix multiply
+ *         operation (SGEMM). The data parameters are copied, but the matrices
+ *         and the epilogue, with its activation, bias and residual, must
+ *         remain valid until the operation has completed.
+ *
+ * @param TransA       Supplies the transpose operation for matrix A.
+ * @param TransB       Supplies the transpose operation for matrix B.
+ * @param M            Supplies the number of rows of matrix A and matrix C.
+ * @param N            Supplies the number of columns of matrix B and matrix C.
+ * @param K            Supplies the number of columns of matrix A and the number
+                       of rows of matrix B.
+ * @param Data         A array of matrices data parameters
+ * @param BatchSize    Supplies number of multiplications in this batch
+ * @param ThreadPool   Supplies the thread pool object to use, else nullptr to
+                       select the default thread pool.
+ * @param Predecessor  Optionally supplies the handle of an operation that must
+                       complete before this operation starts.
+ * @return  The handle of the operation, to be released by MlasReleaseTask.
+ */
+MLAS_TASK*
+    MLASCALL
+    MlasGemmBatchAsync(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        const MLAS_SGEMM_DATA_PARAMS* Data,
+        size_t BatchSize,
+        MLAS_THREADPOOL* ThreadPool,
+        MLAS_TASK* Predecessor = nullptr);
+
+#endif
+
 /**
  * @brief  Single precision matrix/matrix multiply operation (SGEMM)
  *
@@ -647,6 +857,95 @@ void
         size_t ldb,
         void* PackedB);
 
+/**
+ * @brief Pack matrix B using a thread pool. Slices of matrix B along the K
+ *        dimension and ranges of columns are packed in parallel, producing the
+ *        same buffer as the single threaded routine.
+ *
+ * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
+                     base library threading support should be used.
+ */
+void
+    MLASCALL
+    MlasGemmPackB(
+        CBLAS_TRANSPOSE TransB,
+        size_t N,
+        size_t K,
+        const float* B,
+        size_t ldb,
+        void* PackedB,
+        MLAS_THREADPOOL* ThreadPool);
+
+/**
+ * @brief Compute the size of a packed B buffer with a NUMA placement. A
+ *        replicated buffer holds a page aligned copy for each NUMA node.
+ */
+size_t
+    MLASCALL
+    MlasGemmPackBSize(
+        size_t N,
+        size_t K,
+        MLAS_NUMA_PLACEMENT Placement);
+
+/**
+ * @brief Pack matrix B and place the buffer on the NUMA nodes. The buffer is
+ *        sized by MlasGemmPackBSize with the same placement, and the placement
+ *        must be passed as MLAS_SGEMM_DATA_PARAMS::BNumaPlacement to use it.
+ *
+ *        On Linux, the pages are placed with the mbind system call. Pages of
+ *        the buffer that are already present are migrated.
+ *
+ *        The buffer is packed using the thread pool, else nullptr if the base
+ *        library threading support should be used.
+ */
+void
+    MLASCALL
+    MlasGemmPackB(
+        CBLAS_TRANSPOSE TransB,
+        size_t N,
+        size_t K,
+        const float* B,
+        size_t ldb,
+        void* PackedB,
+        MLAS_NUMA_PLACEMENT Placement,
+        MLAS_THREADPOOL* ThreadPool = nullptr);
+
+/**
+ * @brief Compute the size of a packed A buffer
+ *
+ * @param M  Supplies the number of rows of op(A).
+ * @param K  Supplies the number of columns of op(A).
+ */
+size_t
+    MLASCALL
+    MlasGemmPackASize(
+        size_t M,
+        size_t K);
+
+/**
+ * @brief Pack matrix A, such as constant weights that are the left operand of
+ *        a multiply. The transpose operation is applied while packing, so the
+ *        packed buffer is used with MLAS_SGEMM_DATA_PARAMS::AIsPacked and any
+ *        TransA.
+ *
+ * @param TransA   Supplies the transpose operation for matrix A.
+ * @param M        Supplies the number of rows of op(A).
+ * @param K        Supplies the number of columns of op(A).
+ * @param A        Supplies the address of matrix A.
+ * @param lda      Supplies the first dimension of matrix A.
+ * @param PackedA  Supplies the address of the packed buffer, sized by
+ *                 MlasGemmPackASize.
+ */
+void
+    MLASCALL
+    MlasGemmPackA(
+        CBLAS_TRANSPOSE TransA,
+        size_t M,
+        size_t K,
+        const float* A,
+        size_t lda,
+        void* PackedA);
+
 size_t
     MLASCALL
     MlasGemmPackBSize(
@@ -701,7 +1000,10 @@ enum MLAS_CONV_ALGORITHM {
   MlasConvAlgorithmGemmDirect,
   MlasConvAlgorithmExpandThenGemm,
   MlasConvAlgorithmExpandThenGemmSegmented,
-#if defined(MLAS_TARGET_WASM_SCALAR)
+  MlasConvAlgorithmImplicitGemm,
+  MlasConvAlgorithmWinograd,
+  MlasConvAlgorithmNhwcGemm,
+#if defined(MLAS_TARGET_WASM_SCALAR) || defined(MLAS_TARGET_AMD64)
   MlasConvAlgorithmDepthwise,
 #endif
 };
@@ -723,6 +1025,8 @@ struct MLAS_CONV_PARAMETERS {
   size_t OutputSize;
   size_t K;
   float Beta;
+  bool FilterIsPacked; /**< Whether the filter is packed by MlasConvPackFilter, set by the caller */
+  bool ChannelsLast;   /**< Whether the input and output tensors are NHWC */
   MLAS_CONV_ALGORITHM Algorithm;
   ptrdiff_t ThreadCount;
   union {
@@ -732,7 +1036,18 @@ struct MLAS_CONV_PARAMETERS {
     } GemmDirect;
     struct {
       size_t ThreadStrideN;
+      size_t WorkingBufferCount;
     } ExpandThenGemmSegmented;
+    struct {
+      size_t TileBlockSize;
+      size_t WorkingBufferCount;
+    } Winograd;
+    struct {
+      size_t BlockRows;
+      ptrdiff_t ThreadCountM;
+      ptrdiff_t ThreadCountN;
+      bool ExpandInput;
+    } NhwcGemm;
   } u;
 };
 
@@ -752,7 +1067,38 @@ MlasConvPrepare(MLAS_CONV_PARAMETERS* Parameters,
                 const MLAS_ACTIVATION* Activation,
                 size_t* WorkingBufferSize,
                 float Beta,
-                MLAS_THREADPOOL* ThreadPool);
+                MLAS_THREADPOOL* ThreadPool,
+                bool ChannelsLast = false);
+
+/**
+ * @brief Compute the size of a packed filter buffer for a convolution
+ *        prepared by MlasConvPrepare.
+ */
+size_t
+    MLASCALL
+    MlasConvPackFilterSize(
+        const MLAS_CONV_PARAMETERS* Parameters);
+
+/**
+ * @brief Pack the filter of a convolution, so the constant weights are laid
+ *        out for the GEMM kernels, or transformed for the Winograd
+ *        algorithm, once instead of on every inference. Set
+ *        MLAS_CONV_PARAMETERS::FilterIsPacked and pass the packed buffer as
+ *        the filter of MlasConv to use it. The filter of a NHWC convolution
+ *        is packed with MlasGemmPackB, so the buffer must be aligned to
+ *        MlasGetPreferredBufferAlignment.
+ *
+ * @param Parameters    Supplies the parameters from MlasConvPrepare.
+ * @param Filter        Supplies the filter tensor.
+ * @param PackedFilter  Supplies the packed buffer, sized by
+ *                      MlasConvPackFilterSize.
+ */
+void
+    MLASCALL
+    MlasConvPackFilter(
+        const MLAS_CONV_PARAMETERS* Parameters,
+        const float* Filter,
+        void* PackedFilter);
 
 void
     MLASCALL
@@ -765,6 +1111,185 @@ void
         float* Output,
         MLAS_THREADPOOL* ThreadPool);
 
+#if defined(BUILD_MLAS_NO_ONNXRUNTIME)
+
+/**
+ * @brief  Asynchronous convolution operation. The convolution parameters are
+ *         copied, but the activation and buffers must remain valid until the
+ *         operation has completed.
+ *
+ * @param Parameters     Supplies the parameters from MlasConvPrepare.
+ * @param Input          Supplies the input tensor.
+ * @param Filter         Supplies the filter tensor.
+ * @param Bias           Optionally supplies the bias vector.
+ * @param WorkingBuffer  Supplies a working buffer sized by MlasConvPrepare.
+ * @param Output         Supplies the output tensor.
+ * @param ThreadPool     Supplies the thread pool object to use, else nullptr to
+                         select the default thread pool.
+ * @param Predecessor    Optionally supplies the handle of an operation that
+                         must complete before this operation starts, such as
+                         the operation that produces the input.
+ * @return  The handle of the operation, to be released by MlasReleaseTask.
+ */
+MLAS_TASK*
+    MLASCALL
+    MlasConvAsync(
+        const MLAS_CONV_PARAMETERS* Parameters,
+        const float* Input,
+        const float* Filter,
+        const float* Bias,
+        float* WorkingBuffer,
+        float* Output,
+        MLAS_THREADPOOL* ThreadPool,
+        MLAS_TASK* Predecessor = nullptr);
+
+#endif
+
+/**
+ * @brief Parameters of a streaming causal convolution, where the first
+ *        spatial dimension is time and each call supplies the next frames of
+ *        the input tensor. The state of a stream keeps the last
+ *        (kernel - 1) * dilation input frames, so each call only computes the
+ *        output frames of the new input frames.
+ */
+struct MLAS_CONV_STREAM_PARAMETERS {
+  MLAS_CONV_PARAMETERS Conv; /**< Parameters of the convolution of the history and new frames */
+  size_t HistoryFrames;      /**< Number of past input frames kept in the state */
+  size_t FrameCount;         /**< Number of input and output frames of a call */
+  size_t InputFrameSize;     /**< Number of input elements of a frame of a channel */
+  size_t OutputFrameSize;    /**< Number of output elements of a frame of a filter */
+};
+
+/**
+ * @brief Prepare a streaming causal convolution. The shapes are those of the
+ *        input tensor of a call, and the padding and stride along the time
+ *        dimension are ignored: the start of the time dimension is zero
+ *        padded and the stride is one. The filter may be packed with
+ *        MlasConvPackFilter using MLAS_CONV_STREAM_PARAMETERS::Conv.
+ *
+ * @param StateSize          Receives the number of elements of the state of a
+ *                           stream.
+ * @param WorkingBufferSize  Receives the number of elements of the working
+ *                           buffer.
+ */
+void
+    MLASCALL
+    MlasConvStreamPrepare(
+        MLAS_CONV_STREAM_PARAMETERS* Parameters,
+        size_t Dimensions,
+        size_t GroupCount,
+        size_t InputChannels,
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* DilationShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        size_t FilterCount,
+        const MLAS_ACTIVATION* Activation,
+        size_t* StateSize,
+        size_t* WorkingBufferSize,
+        MLAS_THREADPOOL* ThreadPool,
+        bool ChannelsLast = false);
+
+/**
+ * @brief Reset the state of a stream to the start of the time dimension.
+ */
+void
+    MLASCALL
+    MlasConvStreamReset(
+        const MLAS_CONV_STREAM_PARAMETERS* Parameters,
+        float* State);
+
+/**
+ * @brief Convolve the next frames of a stream and update its state.
+ *
+ * @param Input   Supplies the FrameCount new frames of the input tensor.
+ * @param State   Supplies the state of the stream, reset by
+ *                MlasConvStreamReset before the first call.
+ * @param Output  Supplies the FrameCount output frames.
+ */
+void
+    MLASCALL
+    MlasConvStream(
+        const MLAS_CONV_STREAM_PARAMETERS* Parameters,
+        const float* Input,
+        const float* Filter,
+        const float* Bias,
+        float* State,
+        float* WorkingBuffer,
+        float* Output,
+        MLAS_THREADPOOL* ThreadPool);
+
+/**
+ * @brief Parameters of a transposed convolution, computed as the product of
+ *        the transposed filter and the input tensor followed by a col2im
+ *        accumulation to the output tensor.
+ */
+struct MLAS_CONV_TRANSPOSE_PARAMETERS {
+  const MLAS_ACTIVATION* Activation;
+  size_t Dimensions;
+  size_t BatchCount;
+  size_t GroupCount;
+  size_t InputChannels; /**< Number of input channels per group */
+  size_t InputShape[3];
+  size_t KernelShape[3];
+  size_t DilationShape[3];
+  size_t Padding[6];
+  size_t StrideShape[3];
+  size_t FilterCount; /**< Number of output channels per group */
+  size_t OutputShape[3];
+  size_t InputSize;
+  size_t OutputSize;
+  size_t KernelSize;
+  ptrdiff_t ThreadCount;
+};
+
+/**
+ * @brief Prepare a transposed convolution. The output shape is supplied by
+ *        the caller and includes any output padding.
+ *
+ * @param Padding            Supplies the number of elements removed from the
+ *                           start and end of each output dimension.
+ * @param FilterCount        Supplies the number of output channels per group.
+ * @param WorkingBufferSize  Receives the number of elements of the working
+ *                           buffer.
+ */
+void
+    MLASCALL
+    MlasConvTransposePrepare(
+        MLAS_CONV_TRANSPOSE_PARAMETERS* Parameters,
+        size_t Dimensions,
+        size_t BatchCount,
+        size_t GroupCount,
+        size_t InputChannels,
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* DilationShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const int64_t* OutputShape,
+        size_t FilterCount,
+        const MLAS_ACTIVATION* Activation,
+        size_t* WorkingBufferSize,
+        MLAS_THREADPOOL* ThreadPool);
+
+/**
+ * @brief Compute a transposed convolution.
+ *
+ * @param Filter  Supplies the filter tensor in the ONNX ConvTranspose layout
+ *                [GroupCount * InputChannels][FilterCount][kernel...].
+ */
+void
+    MLASCALL
+    MlasConvTranspose(
+        const MLAS_CONV_TRANSPOSE_PARAMETERS* Parameters,
+        const float* Input,
+        const float* Filter,
+        const float* Bias,
+        float* WorkingBuffer,
+        float* Output,
+        MLAS_THREADPOOL* ThreadPool);
+
 void
     MLASCALL
     MlasConvDepthwise(
@@ -909,28 +1434,57 @@ void
 //
 // Miscellaneous compute routines.
 //
+// The elementwise routines split buffers of 128K elements or more across the
+// thread pool, with at least 64K elements per thread. The input and output
+// buffers may be the same.
+//
 
+/**
+ * @brief Compute the error function of each element. The maximum error is 5
+ *        ulp, or an absolute error below 1.5e-7.
+ */
 void
     MLASCALL
     MlasComputeErf(
         const float* Input,
         float* Output,
-        size_t N);
+        size_t N,
+        MLAS_THREADPOOL* ThreadPool = nullptr);
 
+/**
+ * @brief Compute the exponential of each element. The maximum error is 2
+ *        ulp for results above 2^-125, below which results are flushed to
+ *        zero. Results above FLT_MAX are infinity.
+ */
 void
     MLASCALL
     MlasComputeExp(
         const float* Input,
         float* Output,
-        size_t N);
+        size_t N,
+        MLAS_THREADPOOL* ThreadPool = nullptr);
 
+/**
+ * @brief Compute the logistic function 1 / (1 + exp(-x)) of each element. The
+ *        maximum error is 3 ulp for results above 2^-125, below which
+ *        results are flushed to zero.
+ */
 void
     MLASCALL
     MlasComputeLogistic(
         const float* Input,
         float* Output,
-        size_t N);
+        size_t N,
+        MLAS_THREADPOOL* ThreadPool = nullptr);
 
+/**
+ * @brief Compute the softmax or log softmax function over each row of a N x D
+ *        matrix. Each row is read twice: once to find the maximum and the sum
+ *        of the exponentials, and once to write the output.
+ *
+ * Rows are distributed across the thread pool. If there are fewer rows than
+ * threads, each row is also split in segments across the threads.
+ */
 void
     MLASCALL
     MlasComputeSoftmax(
@@ -941,12 +1495,17 @@ void
         bool LogSoftmax,
         MLAS_THREADPOOL* ThreadPool);
 
+/**
+ * @brief Compute the hyperbolic tangent of each element. The maximum error is 7
+ *        ulp, or an absolute error below 4e-7.
+ */
 void
     MLASCALL
     MlasComputeTanh(
         const float* Input,
         float* Output,
-        size_t N);
+        size_t N,
+        MLAS_THREADPOOL* ThreadPool = nullptr);
 
 //
 // Half-precision floating-point routines.
@@ -1002,10 +1561,10 @@ void
 void
     MLASCALL
     MlasReorderInputNchw(
+        const int64_t* InputShape,
         const float* S,
         float* D,
-        size_t InputChannels,
-        size_t InputSize);
+        MLAS_THREADPOOL* ThreadPool);
 
 void
     MLASCALL
@@ -1021,14 +1580,16 @@ void
     MlasReorderOutputNchw(
         const int64_t* OutputShape,
         const float* S,
-        float* D);
+        float* D,
+        MLAS_THREADPOOL* ThreadPool);
 
 void
     MLASCALL
     MlasReorderOutputNhwc(
         const int64_t* OutputShape,
         const float* S,
-        float* D);
+        float* D,
+        MLAS_THREADPOOL* ThreadPool);
 
 void
     MLASCALL
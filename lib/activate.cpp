@@ -77,6 +77,232 @@ struct MLAS_ACTIVATION_FUNCTION<MlasIdentityActivation> {
   }
 };
 
+template <>
+struct MLAS_ACTIVATION_FUNCTION<MlasReluActivation> {
+  const MLAS_FLOAT32X4 ZeroBroadcast = MlasZeroFloat32x4();
+
+  MLAS_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation) {
+    MLAS_UNREFERENCED_PARAMETER(Activation);
+  }
+
+  MLAS_FLOAT32X4 Activate(MLAS_FLOAT32X4 Value) {
+    return MlasMaximumFloat32x4(ZeroBroadcast, Value);
+  }
+
+  float Activate(float Value) {
+    return std::max(0.0f, Value);
+  }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION<MlasLeakyReluActivation> {
+  const MLAS_FLOAT32X4 ZeroBroadcast = MlasZeroFloat32x4();
+  MLAS_FLOAT32X4 AlphaBroadcast;
+  float Alpha;
+
+  MLAS_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation) {
+    Alpha = Activation->Parameters.LeakyRelu.alpha;
+    AlphaBroadcast = MlasBroadcastFloat32x4(Alpha);
+  }
+
+  MLAS_FLOAT32X4 Activate(MLAS_FLOAT32X4 Value) {
+    MLAS_FLOAT32X4 ValueTimesAlpha = MlasMultiplyFloat32x4(Value, AlphaBroadcast);
+    return MlasBlendFloat32x4(ValueTimesAlpha, Value, MlasGreaterThanFloat32x4(Value, ZeroBroadcast));
+  }
+
+  float Activate(float Value) {
+    return (Value > 0.0f) ? Value : Value * Alpha;
+  }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION<MlasTanhActivation> {
+  MLAS_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation) {
+    MLAS_UNREFERENCED_PARAMETER(Activation);
+  }
+
+  MLAS_FLOAT32X4 Activate(MLAS_FLOAT32X4 Value) {
+    return MlasTanhFloat32x4(Value);
+  }
+
+  float Activate(float Value) {
+    return MlasExtractLaneFloat32x4<0>(Activate(MlasBroadcastFloat32x4(Value)));
+  }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION<MlasLogisticActivation> {
+  MLAS_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation) {
+    MLAS_UNREFERENCED_PARAMETER(Activation);
+  }
+
+  MLAS_FLOAT32X4 Activate(MLAS_FLOAT32X4 Value) {
+    return MlasLogisticFloat32x4(Value);
+  }
+
+  float Activate(float Value) {
+    return MlasExtractLaneFloat32x4<0>(Activate(MlasBroadcastFloat32x4(Value)));
+  }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION<MlasClipActivation> {
+  MLAS_FLOAT32X4 MinimumBroadcast;
+  MLAS_FLOAT32X4 MaximumBroadcast;
+  float Minimum;
+  float Maximum;
+
+  MLAS_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation) {
+    Minimum = Activation->Parameters.Clip.minimum;
+    Maximum = Activation->Parameters.Clip.maximum;
+    MinimumBroadcast = MlasBroadcastFloat32x4(Minimum);
+    MaximumBroadcast = MlasBroadcastFloat32x4(Maximum);
+  }
+
+  MLAS_FLOAT32X4 Activate(MLAS_FLOAT32X4 Value) {
+    Value = MlasMaximumFloat32x4(MinimumBroadcast, Value);
+    Value = MlasMinimumFloat32x4(MaximumBroadcast, Value);
+    return Value;
+  }
+
+  float Activate(float Value) {
+    return std::min(std::max(Value, Minimum), Maximum);
+  }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION<MlasHardSigmoidActivation> {
+  const MLAS_FLOAT32X4 ZeroBroadcast = MlasZeroFloat32x4();
+  const MLAS_FLOAT32X4 OneBroadcast = MlasBroadcastFloat32x4(1.0f);
+  MLAS_FLOAT32X4 AlphaBroadcast;
+  MLAS_FLOAT32X4 BetaBroadcast;
+  float Alpha;
+  float Beta;
+
+  MLAS_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation) {
+    Alpha = Activation->Parameters.HardSigmoid.alpha;
+    Beta = Activation->Parameters.HardSigmoid.beta;
+    AlphaBroadcast = MlasBroadcastFloat32x4(Alpha);
+    BetaBroadcast = MlasBroadcastFloat32x4(Beta);
+  }
+
+  MLAS_FLOAT32X4 Activate(MLAS_FLOAT32X4 Value) {
+    Value = MlasMultiplyAddFloat32x4(Value, AlphaBroadcast, BetaBroadcast);
+    Value = MlasMinimumFloat32x4(OneBroadcast, Value);
+    Value = MlasMaximumFloat32x4(ZeroBroadcast, Value);
+    return Value;
+  }
+
+  float Activate(float Value) {
+    return std::min(std::max(Value * Alpha + Beta, 0.0f), 1.0f);
+  }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION<MlasGeluErfActivation> {
+  MLAS_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation) {
+    MLAS_UNREFERENCED_PARAMETER(Activation);
+  }
+
+  MLAS_FLOAT32X4 Activate(MLAS_FLOAT32X4 Value) {
+    MLAS_FLOAT32X4 HalfValue = MlasMultiplyFloat32x4(Value, MlasBroadcastFloat32x4(0.5f));
+    MLAS_FLOAT32X4 Erf = MlasErfFloat32x4(MlasMultiplyFloat32x4(Value, MlasBroadcastFloat32x4(0.70710678118654752f)));
+    return MlasMultiplyAddFloat32x4(HalfValue, Erf, HalfValue);
+  }
+
+  float Activate(float Value) {
+    return MlasExtractLaneFloat32x4<0>(Activate(MlasBroadcastFloat32x4(Value)));
+  }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION<MlasGeluTanhActivation> {
+  MLAS_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation) {
+    MLAS_UNREFERENCED_PARAMETER(Activation);
+  }
+
+  MLAS_FLOAT32X4 Activate(MLAS_FLOAT32X4 Value) {
+    //
+    // sqrt(2 / pi) * (x + 0.044715 * x^3) = x * (c0 + c1 * x^2)
+    //
+
+    MLAS_FLOAT32X4 ValueSquared = MlasMultiplyFloat32x4(Value, Value);
+    MLAS_FLOAT32X4 Inner = MlasMultiplyAddFloat32x4(ValueSquared, MlasBroadcastFloat32x4(0.0356774081363001f),
+                                                    MlasBroadcastFloat32x4(0.7978845608028654f));
+    Inner = MlasMultiplyFloat32x4(Inner, Value);
+
+    MLAS_FLOAT32X4 HalfValue = MlasMultiplyFloat32x4(Value, MlasBroadcastFloat32x4(0.5f));
+    return MlasMultiplyAddFloat32x4(HalfValue, MlasTanhFloat32x4(Inner), HalfValue);
+  }
+
+  float Activate(float Value) {
+    return MlasExtractLaneFloat32x4<0>(Activate(MlasBroadcastFloat32x4(Value)));
+  }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION<MlasSiluActivation> {
+  MLAS_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation) {
+    MLAS_UNREFERENCED_PARAMETER(Activation);
+  }
+
+  MLAS_FLOAT32X4 Activate(MLAS_FLOAT32X4 Value) {
+    MLAS_FLOAT32X4 NegativeExp = MlasExpFloat32x4(MlasXorFloat32x4(Value, MlasBroadcastFloat32x4(-0.0f)));
+    return MlasDivideFloat32x4(Value, MlasAddFloat32x4(NegativeExp, MlasBroadcastFloat32x4(1.0f)));
+  }
+
+  float Activate(float Value) {
+    return MlasExtractLaneFloat32x4<0>(Activate(MlasBroadcastFloat32x4(Value)));
+  }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION<MlasMishActivation> {
+  MLAS_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation) {
+    MLAS_UNREFERENCED_PARAMETER(Activation);
+  }
+
+  MLAS_FLOAT32X4 Activate(MLAS_FLOAT32X4 Value) {
+    //
+    // With u = exp(x), tanh(ln(1 + u)) = u * (u + 2) / (u * (u + 2) + 2),
+    // which rounds to 1 for x above 20.
+    //
+
+    MLAS_FLOAT32X4 u = MlasExpFloat32x4(MlasMinimumFloat32x4(Value, MlasBroadcastFloat32x4(20.0f)));
+    MLAS_FLOAT32X4 n = MlasMultiplyFloat32x4(u, MlasAddFloat32x4(u, MlasBroadcastFloat32x4(2.0f)));
+    MLAS_FLOAT32X4 d = MlasAddFloat32x4(n, MlasBroadcastFloat32x4(2.0f));
+
+    return MlasDivideFloat32x4(MlasMultiplyFloat32x4(Value, n), d);
+  }
+
+  float Activate(float Value) {
+    return MlasExtractLaneFloat32x4<0>(Activate(MlasBroadcastFloat32x4(Value)));
+  }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION<MlasHardSwishActivation> {
+  const MLAS_FLOAT32X4 ZeroBroadcast = MlasZeroFloat32x4();
+  const MLAS_FLOAT32X4 OneBroadcast = MlasBroadcastFloat32x4(1.0f);
+  const MLAS_FLOAT32X4 AlphaBroadcast = MlasBroadcastFloat32x4(1.0f / 6.0f);
+  const MLAS_FLOAT32X4 BetaBroadcast = MlasBroadcastFloat32x4(0.5f);
+
+  MLAS_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation) {
+    MLAS_UNREFERENCED_PARAMETER(Activation);
+  }
+
+  MLAS_FLOAT32X4 Activate(MLAS_FLOAT32X4 Value) {
+    MLAS_FLOAT32X4 Gate = MlasMultiplyAddFloat32x4(Value, AlphaBroadcast, BetaBroadcast);
+    Gate = MlasMinimumFloat32x4(OneBroadcast, Gate);
+    Gate = MlasMaximumFloat32x4(ZeroBroadcast, Gate);
+    return MlasMultiplyFloat32x4(Value, Gate);
+  }
+
+  float Activate(float Value) {
+    return Value * std::min(std::max(Value * (1.0f / 6.0f) + 0.5f, 0.0f), 1.0f);
+  }
+};
+
 template <MLAS_ACTIVATION_KIND ActivationKind, bool AddBias>
 void MlasActivationKernel(
     const MLAS_ACTIVATION* Activation,
@@ -241,7 +467,7 @@ Return Value:
 
 void
     MLASCALL
-    MlasActivation(
+    MlasActivationFloatKernel(
         const MLAS_ACTIVATION* Activation,
         float* Buffer,
         const float* Bias,
@@ -253,7 +479,7 @@ void
 Routine Description:
 
     This routine applies an activation function to the output matrix after
-    optionally adding a bias vector.
+    optionally adding a bias vector, using four element vectors.
 
 Arguments:
 
@@ -281,5 +507,104 @@ Return Value:
       MlasActivationKernel<MlasIdentityActivation>(Activation, Buffer, Bias, M, N, ldc);
       break;
     }
+
+    case MlasReluActivation: {
+      MlasActivationKernel<MlasReluActivation>(Activation, Buffer, Bias, M, N, ldc);
+      break;
+    }
+
+    case MlasLeakyReluActivation: {
+      MlasActivationKernel<MlasLeakyReluActivation>(Activation, Buffer, Bias, M, N, ldc);
+      break;
+    }
+
+    case MlasTanhActivation: {
+      MlasActivationKernel<MlasTanhActivation>(Activation, Buffer, Bias, M, N, ldc);
+      break;
+    }
+
+    case MlasLogisticActivation: {
+      MlasActivationKernel<MlasLogisticActivation>(Activation, Buffer, Bias, M, N, ldc);
+      break;
+    }
+
+    case MlasClipActivation: {
+      MlasActivationKernel<MlasClipActivation>(Activation, Buffer, Bias, M, N, ldc);
+      break;
+    }
+
+    case MlasHardSigmoidActivation: {
+      MlasActivationKernel<MlasHardSigmoidActivation>(Activation, Buffer, Bias, M, N, ldc);
+      break;
+    }
+
+    case MlasGeluErfActivation: {
+      MlasActivationKernel<MlasGeluErfActivation>(Activation, Buffer, Bias, M, N, ldc);
+      break;
+    }
+
+    case MlasGeluTanhActivation: {
+      MlasActivationKernel<MlasGeluTanhActivation>(Activation, Buffer, Bias, M, N, ldc);
+      break;
+    }
+
+    case MlasSiluActivation: {
+      MlasActivationKernel<MlasSiluActivation>(Activation, Buffer, Bias, M, N, ldc);
+      break;
+    }
+
+    case MlasMishActivation: {
+      MlasActivationKernel<MlasMishActivation>(Activation, Buffer, Bias, M, N, ldc);
+      break;
+    }
+
+    case MlasHardSwishActivation: {
+      MlasActivationKernel<MlasHardSwishActivation>(Activation, Buffer, Bias, M, N, ldc);
+      break;
+    }
   }
 }
+
+void
+    MLASCALL
+    MlasActivation(
+        const MLAS_ACTIVATION* Activation,
+        float* Buffer,
+        const float* Bias,
+        size_t M,
+        size_t N,
+        size_t ldc)
+/*++
+
+Routine Description:
+
+    This routine applies an activation function to the output matrix after
+    optionally adding a bias vector.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation.
+
+    Buffer - Supplies the output matrix.
+
+    Bias - Supplies the optional bias vector.
+
+    M - Supplies the number of elements of the bias vector and the number of
+        rows in the output matrix.
+
+    N - Supplies the number of columns of the output matrix.
+
+    ldc - Supplies the number of elements per row of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+  GetMlasPlatform().ActivationFloatKernel(Activation, Buffer, Bias, M, N, ldc);
+#else
+  MlasActivationFloatKernel(Activation, Buffer, Bias, M, N, ldc);
+#endif
+}
@@ -0,0 +1,59 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    activate_avx.cpp
+
+Abstract:
+
+    This module implements the fused activation and bias addition kernel for
+    processors with AVX support.
+
+--*/
+
+#include "activate_avx.h"
+
+void
+MLASCALL
+MlasActivationFloatKernelAvx(
+    const MLAS_ACTIVATION* Activation,
+    float* Buffer,
+    const float* Bias,
+    size_t M,
+    size_t N,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine applies an activation function to the output matrix after
+    optionally adding a bias vector.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation.
+
+    Buffer - Supplies the output matrix.
+
+    Bias - Supplies the optional bias vector.
+
+    M - Supplies the number of elements of the bias vector and the number of
+        rows in the output matrix.
+
+    N - Supplies the number of columns of the output matrix.
+
+    ldc - Supplies the number of elements per row of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasActivationDispatchAvx(Activation, Buffer, Bias, M, N, ldc);
+}
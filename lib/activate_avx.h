@@ -0,0 +1,464 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    activate_avx.h
+
+Abstract:
+
+    This module implements the fused activation and bias addition kernels
+    using eight element AVX vectors.
+
+    This module is included by a translation unit per instruction set, which
+    is compiled with the matching flags. Multiply and add operations are fused
+    if the translation unit is compiled with FMA3 support. The routines are
+    defined with internal linkage so that each translation unit keeps its own
+    copy.
+
+--*/
+
+#pragma once
+
+#include "compute_avx.h"
+
+namespace {
+
+//
+// Templates for bias addition functions.
+//
+
+template <bool AddBias>
+struct MLAS_BIAS_ADDITION_AVX;
+
+template <>
+struct MLAS_BIAS_ADDITION_AVX<true> {
+    __m256 BiasBroadcast;
+
+    void LoadNext(const float*& Bias) {
+        BiasBroadcast = _mm256_broadcast_ss(Bias++);
+    }
+
+    __m256 Add(__m256 Value) {
+        return _mm256_add_ps(Value, BiasBroadcast);
+    }
+};
+
+template <>
+struct MLAS_BIAS_ADDITION_AVX<false> {
+    void LoadNext(const float*& Bias) {
+        MLAS_UNREFERENCED_PARAMETER(Bias);
+    }
+
+    __m256 Add(__m256 Value) {
+        return Value;
+    }
+};
+
+//
+// Templates for activation functions.
+//
+
+template <MLAS_ACTIVATION_KIND ActivationKind>
+struct MLAS_ACTIVATION_FUNCTION_AVX;
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION_AVX<MlasIdentityActivation> {
+    MLAS_ACTIVATION_FUNCTION_AVX(const MLAS_ACTIVATION* Activation) {
+        MLAS_UNREFERENCED_PARAMETER(Activation);
+    }
+
+    __m256 Activate(__m256 Value) {
+        return Value;
+    }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION_AVX<MlasReluActivation> {
+    const __m256 ZeroBroadcast = _mm256_setzero_ps();
+
+    MLAS_ACTIVATION_FUNCTION_AVX(const MLAS_ACTIVATION* Activation) {
+        MLAS_UNREFERENCED_PARAMETER(Activation);
+    }
+
+    __m256 Activate(__m256 Value) {
+        return _mm256_max_ps(ZeroBroadcast, Value);
+    }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION_AVX<MlasLeakyReluActivation> {
+    const __m256 ZeroBroadcast = _mm256_setzero_ps();
+    __m256 AlphaBroadcast;
+
+    MLAS_ACTIVATION_FUNCTION_AVX(const MLAS_ACTIVATION* Activation) {
+        AlphaBroadcast = _mm256_set1_ps(Activation->Parameters.LeakyRelu.alpha);
+    }
+
+    __m256 Activate(__m256 Value) {
+        __m256 ValueTimesAlpha = _mm256_mul_ps(Value, AlphaBroadcast);
+        return _mm256_blendv_ps(ValueTimesAlpha, Value, _mm256_cmp_ps(Value, ZeroBroadcast, _CMP_GT_OQ));
+    }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION_AVX<MlasTanhActivation> {
+    MLAS_ACTIVATION_FUNCTION_AVX(const MLAS_ACTIVATION* Activation) {
+        MLAS_UNREFERENCED_PARAMETER(Activation);
+    }
+
+    __m256 Activate(__m256 Value) {
+        return MlasTanhAvx(Value);
+    }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION_AVX<MlasLogisticActivation> {
+    MLAS_ACTIVATION_FUNCTION_AVX(const MLAS_ACTIVATION* Activation) {
+        MLAS_UNREFERENCED_PARAMETER(Activation);
+    }
+
+    __m256 Activate(__m256 Value) {
+        return MlasLogisticAvx(Value);
+    }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION_AVX<MlasClipActivation> {
+    __m256 MinimumBroadcast;
+    __m256 MaximumBroadcast;
+
+    MLAS_ACTIVATION_FUNCTION_AVX(const MLAS_ACTIVATION* Activation) {
+        MinimumBroadcast = _mm256_set1_ps(Activation->Parameters.Clip.minimum);
+        MaximumBroadcast = _mm256_set1_ps(Activation->Parameters.Clip.maximum);
+    }
+
+    __m256 Activate(__m256 Value) {
+        Value = _mm256_max_ps(MinimumBroadcast, Value);
+        Value = _mm256_min_ps(MaximumBroadcast, Value);
+        return Value;
+    }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION_AVX<MlasHardSigmoidActivation> {
+    const __m256 ZeroBroadcast = _mm256_setzero_ps();
+    const __m256 OneBroadcast = _mm256_set1_ps(1.0f);
+    __m256 AlphaBroadcast;
+    __m256 BetaBroadcast;
+
+    MLAS_ACTIVATION_FUNCTION_AVX(const MLAS_ACTIVATION* Activation) {
+        AlphaBroadcast = _mm256_set1_ps(Activation->Parameters.HardSigmoid.alpha);
+        BetaBroadcast = _mm256_set1_ps(Activation->Parameters.HardSigmoid.beta);
+    }
+
+    __m256 Activate(__m256 Value) {
+        Value = MlasActivationMultiplyAdd(Value, AlphaBroadcast, BetaBroadcast);
+        Value = _mm256_min_ps(OneBroadcast, Value);
+        Value = _mm256_max_ps(ZeroBroadcast, Value);
+        return Value;
+    }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION_AVX<MlasGeluErfActivation> {
+    MLAS_ACTIVATION_FUNCTION_AVX(const MLAS_ACTIVATION* Activation) {
+        MLAS_UNREFERENCED_PARAMETER(Activation);
+    }
+
+    __m256 Activate(__m256 Value) {
+        __m256 HalfValue = _mm256_mul_ps(Value, _mm256_set1_ps(0.5f));
+        __m256 Erf = MlasErfAvx(_mm256_mul_ps(Value, _mm256_set1_ps(0.70710678118654752f)));
+        return MlasActivationMultiplyAdd(HalfValue, Erf, HalfValue);
+    }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION_AVX<MlasGeluTanhActivation> {
+    MLAS_ACTIVATION_FUNCTION_AVX(const MLAS_ACTIVATION* Activation) {
+        MLAS_UNREFERENCED_PARAMETER(Activation);
+    }
+
+    __m256 Activate(__m256 Value) {
+        __m256 ValueSquared = _mm256_mul_ps(Value, Value);
+        __m256 Inner = MlasActivationMultiplyAdd(ValueSquared, _mm256_set1_ps(0.0356774081363001f),
+                                                 _mm256_set1_ps(0.7978845608028654f));
+        Inner = _mm256_mul_ps(Inner, Value);
+
+        __m256 HalfValue = _mm256_mul_ps(Value, _mm256_set1_ps(0.5f));
+        return MlasActivationMultiplyAdd(HalfValue, MlasTanhAvx(Inner), HalfValue);
+    }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION_AVX<MlasSiluActivation> {
+    MLAS_ACTIVATION_FUNCTION_AVX(const MLAS_ACTIVATION* Activation) {
+        MLAS_UNREFERENCED_PARAMETER(Activation);
+    }
+
+    __m256 Activate(__m256 Value) {
+        __m256 NegativeExp = MlasExpAvx(_mm256_xor_ps(Value, _mm256_set1_ps(-0.0f)));
+        return _mm256_div_ps(Value, _mm256_add_ps(NegativeExp, _mm256_set1_ps(1.0f)));
+    }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION_AVX<MlasMishActivation> {
+    MLAS_ACTIVATION_FUNCTION_AVX(const MLAS_ACTIVATION* Activation) {
+        MLAS_UNREFERENCED_PARAMETER(Activation);
+    }
+
+    __m256 Activate(__m256 Value) {
+        __m256 u = MlasExpAvx(_mm256_min_ps(Value, _mm256_set1_ps(20.0f)));
+        __m256 n = _mm256_mul_ps(u, _mm256_add_ps(u, _mm256_set1_ps(2.0f)));
+        __m256 d = _mm256_add_ps(n, _mm256_set1_ps(2.0f));
+
+        return _mm256_div_ps(_mm256_mul_ps(Value, n), d);
+    }
+};
+
+template <>
+struct MLAS_ACTIVATION_FUNCTION_AVX<MlasHardSwishActivation> {
+    const __m256 ZeroBroadcast = _mm256_setzero_ps();
+    const __m256 OneBroadcast = _mm256_set1_ps(1.0f);
+    const __m256 AlphaBroadcast = _mm256_set1_ps(1.0f / 6.0f);
+    const __m256 BetaBroadcast = _mm256_set1_ps(0.5f);
+
+    MLAS_ACTIVATION_FUNCTION_AVX(const MLAS_ACTIVATION* Activation) {
+        MLAS_UNREFERENCED_PARAMETER(Activation);
+    }
+
+    __m256 Activate(__m256 Value) {
+        __m256 Gate = MlasActivationMultiplyAdd(Value, AlphaBroadcast, BetaBroadcast);
+        Gate = _mm256_min_ps(OneBroadcast, Gate);
+        Gate = _mm256_max_ps(ZeroBroadcast, Gate);
+        return _mm256_mul_ps(Value, Gate);
+    }
+};
+
+template <MLAS_ACTIVATION_KIND ActivationKind, bool AddBias>
+void
+MlasActivationKernelAvx(
+    const MLAS_ACTIVATION* Activation,
+    float* Buffer,
+    const float* Bias,
+    size_t M,
+    size_t N,
+    size_t ldc)
+/*++
+
+Routine Description:
+
+    This routine steps over the output matrix and invokes the templated bias
+    addition and activation functions. The remaining columns of a row are
+    processed with masked loads and stores.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation.
+
+    Buffer - Supplies the output matrix.
+
+    Bias - Supplies the optional bias vector.
+
+    M - Supplies the number of elements of the bias vector and the number of
+        rows in the output matrix.
+
+    N - Supplies the number of columns of the output matrix.
+
+    ldc - Supplies the number of elements per row of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_ACTIVATION_FUNCTION_AVX<ActivationKind> ActivationFunction(Activation);
+    MLAS_BIAS_ADDITION_AVX<AddBias> BiasAddition;
+
+    const size_t RemainingN = N % 8;
+    const __m256i RemainingMask = _mm256_loadu_si256((const __m256i*)&MlasMaskMoveTableAvx[8 - RemainingN]);
+
+    //
+    // Step through each row of the output matrix.
+    //
+
+    while (M-- > 0) {
+
+        float* buffer = Buffer;
+        size_t n = N;
+
+        BiasAddition.LoadNext(Bias);
+
+        while (n >= 8) {
+
+            __m256 Vector = BiasAddition.Add(_mm256_loadu_ps(buffer));
+            _mm256_storeu_ps(buffer, ActivationFunction.Activate(Vector));
+
+            buffer += 8;
+            n -= 8;
+        }
+
+        if (n > 0) {
+
+            __m256 Vector = BiasAddition.Add(_mm256_maskload_ps(buffer, RemainingMask));
+            _mm256_maskstore_ps(buffer, RemainingMask, ActivationFunction.Activate(Vector));
+        }
+
+        Buffer += ldc;
+    }
+}
+
+template <MLAS_ACTIVATION_KIND ActivationKind>
+void
+MlasActivationKernelAvx(
+    const MLAS_ACTIVATION* Activation,
+    float* Buffer,
+    const float* Bias,
+    size_t M,
+    size_t N,
+    size_t ldc)
+/*++
+
+Routine Description:
+
+    This routine invokes the appropriate activation kernel based on the
+    optional bias vector.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation.
+
+    Buffer - Supplies the output matrix.
+
+    Bias - Supplies the optional bias vector.
+
+    M - Supplies the number of elements of the bias vector and the number of
+        rows in the output matrix.
+
+    N - Supplies the number of columns of the output matrix.
+
+    ldc - Supplies the number of elements per row of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Bias != nullptr) {
+        MlasActivationKernelAvx<ActivationKind, true>(Activation, Buffer, Bias, M, N, ldc);
+    } else {
+        MlasActivationKernelAvx<ActivationKind, false>(Activation, Buffer, Bias, M, N, ldc);
+    }
+}
+
+void
+MlasActivationDispatchAvx(
+    const MLAS_ACTIVATION* Activation,
+    float* Buffer,
+    const float* Bias,
+    size_t M,
+    size_t N,
+    size_t ldc)
+/*++
+
+Routine Description:
+
+    This routine applies an activation function to the output matrix after
+    optionally adding a bias vector, using eight element vectors.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation.
+
+    Buffer - Supplies the output matrix.
+
+    Bias - Supplies the optional bias vector.
+
+    M - Supplies the number of elements of the bias vector and the number of
+        rows in the output matrix.
+
+    N - Supplies the number of columns of the output matrix.
+
+    ldc - Supplies the number of elements per row of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (Activation->ActivationKind) {
+        case MlasIdentityActivation: {
+            //
+            // An identity operation with no bias addition is a no-op.
+            //
+            if (Bias != nullptr) {
+                MlasActivationKernelAvx<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+            }
+            break;
+        }
+
+        case MlasReluActivation: {
+            MlasActivationKernelAvx<MlasReluActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
+        case MlasLeakyReluActivation: {
+            MlasActivationKernelAvx<MlasLeakyReluActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
+        case MlasTanhActivation: {
+            MlasActivationKernelAvx<MlasTanhActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
+        case MlasLogisticActivation: {
+            MlasActivationKernelAvx<MlasLogisticActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
+        case MlasClipActivation: {
+            MlasActivationKernelAvx<MlasClipActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
+        case MlasHardSigmoidActivation: {
+            MlasActivationKernelAvx<MlasHardSigmoidActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
+        case MlasGeluErfActivation: {
+            MlasActivationKernelAvx<MlasGeluErfActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
+        case MlasGeluTanhActivation: {
+            MlasActivationKernelAvx<MlasGeluTanhActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
+        case MlasSiluActivation: {
+            MlasActivationKernelAvx<MlasSiluActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
+        case MlasMishActivation: {
+            MlasActivationKernelAvx<MlasMishActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+
+        case MlasHardSwishActivation: {
+            MlasActivationKernelAvx<MlasHardSwishActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
+    }
+}
+
+}  // namespace
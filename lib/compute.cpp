@@ -0,0 +1,874 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute.cpp
+
+Abstract:
+
+    This module implements the exponential function, the threading support
+    shared by the elementwise compute routines and the softmax routines.
+
+    The exponential is computed by reducing the input to x = n * ln2 + r with
+    |r| <= ln2/2, evaluating a degree-6 minimax polynomial of exp(r) and then
+    scaling by 2^n through the exponent field. The maximum error is 2 ulp for
+    results above 2^-125, below which results are flushed to zero.
+
+    The softmax routines make two passes over each row. The first pass finds
+    the maximum and the sum of the exponentials of the elements relative to
+    the maximum together, rescaling the partial sums of each vector lane as
+    the maximum of the lane grows. The second pass writes the normalized
+    output. A row is split in segments across threads if there are fewer
+    rows than threads, in which case the sums of the segments are combined
+    between the passes.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Bundles the constants for use by kernels written in assembly.
+//
+
+MLAS_INTERNAL_DATA const MLAS_EXP_CONSTANTS MlasExpConstants = {
+    -86.6433976f,                   // -125 * ln2
+    88.7228394f,                    // ln(FLT_MAX)
+    1.44269504088896341f,           // 1 / ln2
+    -6.93145752e-1f,                // -ln2, high bits
+    -1.42860677e-6f,                // -ln2, low bits
+    12582912.0f,                    // 1.5 * 2^23
+    1.378059387e-03f,
+    8.373124525e-03f,
+    4.166953638e-02f,
+    1.666647196e-01f,
+    4.999998510e-01f,
+    1.0f,
+    1.0f,
+};
+
+//
+// Define the parameters to execute segments of an elementwise compute routine
+// on worker threads.
+//
+
+struct MLAS_COMPUTE_UNARY_WORK_BLOCK {
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL* Kernel;
+    const float* Input;
+    float* Output;
+    size_t N;
+    ptrdiff_t ThreadCount;
+};
+
+void
+MlasComputeUnaryThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of an
+    elementwise compute routine.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_COMPUTE_UNARY_WORK_BLOCK*)Context;
+
+    //
+    // Partition the elements in blocks of 16 so that each thread starts at
+    // a cache line boundary if the buffers are aligned.
+    //
+
+    constexpr size_t BlockSize = 16;
+
+    const size_t BlockCount = MlasDivRoundup(WorkBlock->N, BlockSize);
+
+    size_t BlockIndex;
+    size_t BlockRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, BlockCount, &BlockIndex, &BlockRemaining);
+
+    const size_t Offset = BlockIndex * BlockSize;
+
+    if (Offset >= WorkBlock->N) {
+        return;
+    }
+
+    const size_t Count = std::min(BlockRemaining * BlockSize, WorkBlock->N - Offset);
+
+    WorkBlock->Kernel(WorkBlock->Input + Offset, WorkBlock->Output + Offset, Count);
+}
+
+void
+MlasComputeUnary(
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL* Kernel,
+    const float* Input,
+    float* Output,
+    size_t N,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine applies an elementwise compute kernel to a buffer, using
+    worker threads if the buffer is large enough to amortize the cost.
+
+Arguments:
+
+    Kernel - Supplies the compute kernel.
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ptrdiff_t TargetThreadCount = ptrdiff_t(N / MLAS_COMPUTE_UNARY_THREAD_COMPLEXITY);
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount > MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount <= 1) {
+        Kernel(Input, Output, N);
+        return;
+    }
+
+    MLAS_COMPUTE_UNARY_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Kernel = Kernel;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.ThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasComputeUnaryThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasComputeExpF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasExpFloat32x4(MlasLoadFloat32x4(Input)));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        MlasStoreLaneFloat32x4<0>(Output, MlasExpFloat32x4(MlasBroadcastFloat32x4(*Input)));
+
+        Input += 1;
+        Output += 1;
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasComputeUnary(GetMlasPlatform().ComputeExpF32Kernel, Input, Output, N, ThreadPool);
+#else
+    MlasComputeUnary(MlasComputeExpF32Kernel, Input, Output, N, ThreadPool);
+#endif
+}
+
+MLAS_FORCEINLINE
+void
+MlasComputeSumExpAccumulate(
+    MLAS_FLOAT32X4& MaximumVector,
+    MLAS_FLOAT32X4& Accumulator,
+    MLAS_FLOAT32X4 BlockMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine raises the running maximum of each vector lane to include a
+    block of elements and rescales the partial sums of the lanes to the new
+    maximum.
+
+Arguments:
+
+    MaximumVector - Supplies the running maximum of each lane.
+
+    Accumulator - Supplies the partial sums of each lane relative to the
+        running maximum.
+
+    BlockMaximum - Supplies the maximum of each lane of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 NewMaximum = MlasMaximumFloat32x4(MaximumVector, BlockMaximum);
+
+    Accumulator = MlasMultiplyFloat32x4(Accumulator, MlasExpFloat32x4(MlasSubtractFloat32x4(MaximumVector, NewMaximum)));
+    MaximumVector = NewMaximum;
+}
+
+float
+MLASCALL
+MlasComputeSumExpF32Kernel(
+    const float* Input,
+    size_t N,
+    float* Maximum
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the first pass of the
+    softmax routines, which finds the maximum of the input buffer and the sum
+    of the exponentials of the elements relative to the maximum.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+    Maximum - Receives the maximum of the input buffer, or the lowest float
+        value if the buffer is empty.
+
+Return Value:
+
+    Returns the sum of exp(Input[i] - Maximum).
+
+--*/
+{
+    const float Lowest = std::numeric_limits<float>::lowest();
+
+    MLAS_FLOAT32X4 MaximumVector = MlasBroadcastFloat32x4(Lowest);
+    MLAS_FLOAT32X4 Accumulator = MlasZeroFloat32x4();
+
+    while (N >= 16) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input);
+        MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input + 4);
+        MLAS_FLOAT32X4 Vector2 = MlasLoadFloat32x4(Input + 8);
+        MLAS_FLOAT32X4 Vector3 = MlasLoadFloat32x4(Input + 12);
+
+        MLAS_FLOAT32X4 BlockMaximum = MlasMaximumFloat32x4(MlasMaximumFloat32x4(Vector0, Vector1),
+                                                           MlasMaximumFloat32x4(Vector2, Vector3));
+
+        MlasComputeSumExpAccumulate(MaximumVector, Accumulator, BlockMaximum);
+
+        Vector0 = MlasExpFloat32x4(MlasSubtractFloat32x4(Vector0, MaximumVector));
+        Vector1 = MlasExpFloat32x4(MlasSubtractFloat32x4(Vector1, MaximumVector));
+        Vector2 = MlasExpFloat32x4(MlasSubtractFloat32x4(Vector2, MaximumVector));
+        Vector3 = MlasExpFloat32x4(MlasSubtractFloat32x4(Vector3, MaximumVector));
+
+        Accumulator = MlasAddFloat32x4(Accumulator, MlasAddFloat32x4(MlasAddFloat32x4(Vector0, Vector1),
+                                                                     MlasAddFloat32x4(Vector2, Vector3)));
+
+        Input += 16;
+        N -= 16;
+    }
+
+    while (N > 0) {
+
+        MLAS_FLOAT32X4 Vector;
+
+        if (N >= 4) {
+
+            Vector = MlasLoadFloat32x4(Input);
+
+            Input += 4;
+            N -= 4;
+
+        } else {
+
+            //
+            // Pad the remaining elements with the lowest float value, which
+            // adds nothing to the sum of a lane with an element.
+            //
+
+            float Buffer[4] = {Lowest, Lowest, Lowest, Lowest};
+
+            std::copy_n(Input, N, Buffer);
+            Vector = MlasLoadFloat32x4(Buffer);
+
+            N = 0;
+        }
+
+        MlasComputeSumExpAccumulate(MaximumVector, Accumulator, Vector);
+
+        Accumulator = MlasAddFloat32x4(Accumulator, MlasExpFloat32x4(MlasSubtractFloat32x4(Vector, MaximumVector)));
+    }
+
+    //
+    // Rescale the partial sums of the lanes to the maximum of all lanes.
+    //
+
+    *Maximum = MlasReduceMaximumFloat32x4(MaximumVector);
+
+    MlasComputeSumExpAccumulate(MaximumVector, Accumulator, MlasBroadcastFloat32x4(*Maximum));
+
+    return MlasReduceAddFloat32x4(Accumulator);
+}
+
+void
+MLASCALL
+MlasComputeSoftmaxOutputF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the second pass of the
+    softmax routine.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies an array containing the negated maximum and the
+        reciprocal of the sum of the exponentials.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 NegativeMaximum = MlasBroadcastFloat32x4(Parameters[0]);
+    const MLAS_FLOAT32X4 Scale = MlasBroadcastFloat32x4(Parameters[1]);
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasExpFloat32x4(MlasAddFloat32x4(MlasLoadFloat32x4(Input), NegativeMaximum));
+        MlasStoreFloat32x4(Output, MlasMultiplyFloat32x4(Vector, Scale));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        MLAS_FLOAT32X4 Vector = MlasExpFloat32x4(MlasAddFloat32x4(MlasBroadcastFloat32x4(*Input), NegativeMaximum));
+        MlasStoreLaneFloat32x4<0>(Output, MlasMultiplyFloat32x4(Vector, Scale));
+
+        Input += 1;
+        Output += 1;
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasComputeLogSoftmaxOutputF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the second pass of the log
+    softmax routine.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies an array containing the negated maximum and the
+        logarithm of the sum of the exponentials.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float NegativeMaximum = Parameters[0];
+    const float Logarithm = Parameters[1];
+
+    const MLAS_FLOAT32X4 NegativeMaximumVector = MlasBroadcastFloat32x4(NegativeMaximum);
+    const MLAS_FLOAT32X4 LogarithmVector = MlasBroadcastFloat32x4(Logarithm);
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasAddFloat32x4(MlasLoadFloat32x4(Input), NegativeMaximumVector);
+        MlasStoreFloat32x4(Output, MlasSubtractFloat32x4(Vector, LogarithmVector));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output++ = (*Input++ + NegativeMaximum) - Logarithm;
+        N -= 1;
+    }
+}
+
+//
+// Define the parameters to execute segments of a softmax operation on worker
+// threads.
+//
+
+struct MLAS_SOFTMAX_WORK_BLOCK {
+    MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL* SumExpKernel;
+    MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL* OutputKernel;
+    const float* Input;
+    float* Output;
+    size_t N;
+    size_t D;
+    bool LogSoftmax;
+    ptrdiff_t ThreadCount;
+    size_t SegmentCount;
+    float* Statistics;
+};
+
+void
+MlasComputeSoftmaxParameters(
+    const MLAS_SOFTMAX_WORK_BLOCK* WorkBlock,
+    float Maximum,
+    float Accumulation,
+    float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the parameters of the second pass of a row from the
+    results of the first pass.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the softmax parameters.
+
+    Maximum - Supplies the maximum of the row.
+
+    Accumulation - Supplies the sum of the exponentials of the row relative
+        to the maximum.
+
+    Parameters - Receives the parameters of the output kernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    Parameters[0] = -Maximum;
+
+    if (WorkBlock->LogSoftmax) {
+        Parameters[1] = std::log(Accumulation);
+    } else {
+        Parameters[1] = 1.0f / Accumulation;
+    }
+}
+
+void
+MlasComputeSoftmaxThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    softmax operation over whole rows.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SOFTMAX_WORK_BLOCK*)Context;
+
+    const size_t D = WorkBlock->D;
+
+    size_t RowIndex;
+    size_t RowRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, WorkBlock->N, &RowIndex, &RowRemaining);
+
+    const float* Input = WorkBlock->Input + RowIndex * D;
+    float* Output = WorkBlock->Output + RowIndex * D;
+
+    //
+    // Make both passes over a row before moving to the next row, so that the
+    // second pass reads the row from the cache.
+    //
+
+    while (RowRemaining-- > 0) {
+
+        float Maximum;
+        float Accumulation = WorkBlock->SumExpKernel(Input, D, &Maximum);
+
+        float Parameters[2];
+
+        MlasComputeSoftmaxParameters(WorkBlock, Maximum, Accumulation, Parameters);
+
+        WorkBlock->OutputKernel(Input, Output, D, Parameters);
+
+        Input += D;
+        Output += D;
+    }
+}
+
+void
+MlasComputeSoftmaxSegment(
+    const MLAS_SOFTMAX_WORK_BLOCK* WorkBlock,
+    ptrdiff_t Index,
+    size_t* Offset,
+    size_t* Count
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the range of a row segment, which is partitioned in
+    blocks of 16 elements.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the softmax parameters.
+
+    Index - Supplies the index of the segment across all rows.
+
+    Offset - Receives the offset of the segment from the start of the input
+        buffer.
+
+    Count - Receives the number of elements of the segment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = 16;
+
+    const size_t D = WorkBlock->D;
+    const size_t Row = size_t(Index) / WorkBlock->SegmentCount;
+    const size_t Segment = size_t(Index) % WorkBlock->SegmentCount;
+
+    size_t BlockIndex;
+    size_t BlockRemaining;
+
+    MlasPartitionWork(ptrdiff_t(Segment), ptrdiff_t(WorkBlock->SegmentCount), MlasDivRoundup(D, BlockSize),
+                      &BlockIndex, &BlockRemaining);
+
+    const size_t Start = std::min(BlockIndex * BlockSize, D);
+
+    *Offset = Row * D + Start;
+    *Count = std::min(BlockRemaining * BlockSize, D - Start);
+}
+
+void
+MlasComputeSoftmaxSumExpThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute the first pass of
+    a softmax operation over a segment of a row.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SOFTMAX_WORK_BLOCK*)Context;
+
+    size_t Offset;
+    size_t Count;
+
+    MlasComputeSoftmaxSegment(WorkBlock, Index, &Offset, &Count);
+
+    float* Statistics = WorkBlock->Statistics + size_t(Index) * 2;
+
+    Statistics[1] = WorkBlock->SumExpKernel(WorkBlock->Input + Offset, Count, &Statistics[0]);
+}
+
+void
+MlasComputeSoftmaxOutputThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute the second pass of
+    a softmax operation over a segment of a row.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SOFTMAX_WORK_BLOCK*)Context;
+
+    size_t Offset;
+    size_t Count;
+
+    MlasComputeSoftmaxSegment(WorkBlock, Index, &Offset, &Count);
+
+    //
+    // The parameters of the row are stored in place of the statistics of the
+    // first segment of the row.
+    //
+
+    const size_t Row = size_t(Index) / WorkBlock->SegmentCount;
+    const float* Parameters = WorkBlock->Statistics + Row * WorkBlock->SegmentCount * 2;
+
+    WorkBlock->OutputKernel(WorkBlock->Input + Offset, WorkBlock->Output + Offset, Count, Parameters);
+}
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function over each row
+    of the input matrix.
+
+Arguments:
+
+    Input - Supplies the input matrix.
+
+    Output - Supplies the output matrix.
+
+    N - Supplies the number of rows of the matrix.
+
+    D - Supplies the number of columns of the matrix.
+
+    LogSoftmax - Supplies true if the log softmax function should be computed,
+        else false if the softmax function should be computed.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (N == 0 || D == 0) {
+        return;
+    }
+
+    MLAS_SOFTMAX_WORK_BLOCK WorkBlock;
+
+#if defined(MLAS_TARGET_AMD64)
+    WorkBlock.SumExpKernel = GetMlasPlatform().ComputeSumExpF32Kernel;
+    WorkBlock.OutputKernel = LogSoftmax ? GetMlasPlatform().ComputeLogSoftmaxOutputF32Kernel
+                                        : GetMlasPlatform().ComputeSoftmaxOutputF32Kernel;
+#else
+    WorkBlock.SumExpKernel = MlasComputeSumExpF32Kernel;
+    WorkBlock.OutputKernel = LogSoftmax ? MlasComputeLogSoftmaxOutputF32Kernel : MlasComputeSoftmaxOutputF32Kernel;
+#endif
+
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.LogSoftmax = LogSoftmax;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation.
+    //
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(N * D / MLAS_COMPUTE_SOFTMAX_THREAD_COMPLEXITY);
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount > MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount < 1) {
+        TargetThreadCount = 1;
+    }
+
+    //
+    // Parallelize over whole rows if there are enough rows to keep the
+    // threads busy.
+    //
+
+    if (size_t(TargetThreadCount) <= N) {
+
+        WorkBlock.ThreadCount = TargetThreadCount;
+
+        MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+        return;
+    }
+
+    //
+    // Split each row in segments and make each pass over the segments on the
+    // worker threads. Between the passes, the maximum and sum of the segments
+    // of a row are combined and the parameters of the output kernel stored in
+    // place of the statistics of the first segment.
+    //
+
+    const size_t SegmentCount = MlasDivRoundup(size_t(TargetThreadCount), N);
+    const ptrdiff_t Iterations = ptrdiff_t(N * SegmentCount);
+
+    std::vector<float> Statistics(N * SegmentCount * 2);
+
+    WorkBlock.SegmentCount = SegmentCount;
+    WorkBlock.Statistics = Statistics.data();
+
+    MlasExecuteThreaded(MlasComputeSoftmaxSumExpThreaded, &WorkBlock, Iterations, ThreadPool);
+
+    for (size_t Row = 0; Row < N; Row++) {
+
+        float* RowStatistics = Statistics.data() + Row * SegmentCount * 2;
+
+        float Maximum = RowStatistics[0];
+
+        for (size_t Segment = 1; Segment < SegmentCount; Segment++) {
+            Maximum = std::max(Maximum, RowStatistics[Segment * 2]);
+        }
+
+        float Accumulation = 0.0f;
+
+        for (size_t Segment = 0; Segment < SegmentCount; Segment++) {
+            Accumulation += RowStatistics[Segment * 2 + 1] * std::exp(RowStatistics[Segment * 2] - Maximum);
+        }
+
+        MlasComputeSoftmaxParameters(&WorkBlock, Maximum, Accumulation, RowStatistics);
+    }
+
+    MlasExecuteThreaded(MlasComputeSoftmaxOutputThreaded, &WorkBlock, Iterations, ThreadPool);
+}
@@ -0,0 +1,172 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute_avx.h
+
+Abstract:
+
+    This module implements the exponential, hyperbolic tangent, logistic and
+    error functions using eight element AVX vectors.
+
+    This module is included by the activation and elementwise compute
+    translation units of each instruction set, which are compiled with the
+    matching flags. Multiply and add operations are fused if the translation
+    unit is compiled with FMA3 support. The routines are defined with internal
+    linkage so that each translation unit keeps its own copy.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+namespace {
+
+MLAS_FORCEINLINE
+__m256
+MlasActivationMultiplyAdd(__m256 Vector1, __m256 Vector2, __m256 Vector3)
+{
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+    return _mm256_fmadd_ps(Vector1, Vector2, Vector3);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(Vector1, Vector2), Vector3);
+#endif
+}
+
+MLAS_FORCEINLINE
+__m256
+MlasTanhAvx(__m256 Value)
+{
+    const __m256 SignMask = _mm256_set1_ps(-0.0f);
+
+    __m256 SaturatedMask = _mm256_cmp_ps(_mm256_andnot_ps(SignMask, Value),
+                                         _mm256_set1_ps(MlasTanhConstants.UpperRange), _CMP_GT_OQ);
+
+    Value = _mm256_max_ps(_mm256_set1_ps(MlasTanhConstants.LowerRange), Value);
+    Value = _mm256_min_ps(_mm256_set1_ps(MlasTanhConstants.UpperRange), Value);
+
+    __m256 ValueSquared = _mm256_mul_ps(Value, Value);
+
+    __m256 p;
+    p = MlasActivationMultiplyAdd(ValueSquared, _mm256_set1_ps(MlasTanhConstants.alpha_13),
+                                  _mm256_set1_ps(MlasTanhConstants.alpha_11));
+    p = MlasActivationMultiplyAdd(p, ValueSquared, _mm256_set1_ps(MlasTanhConstants.alpha_9));
+    p = MlasActivationMultiplyAdd(p, ValueSquared, _mm256_set1_ps(MlasTanhConstants.alpha_7));
+    p = MlasActivationMultiplyAdd(p, ValueSquared, _mm256_set1_ps(MlasTanhConstants.alpha_5));
+    p = MlasActivationMultiplyAdd(p, ValueSquared, _mm256_set1_ps(MlasTanhConstants.alpha_3));
+    p = MlasActivationMultiplyAdd(p, ValueSquared, _mm256_set1_ps(MlasTanhConstants.alpha_1));
+    p = _mm256_mul_ps(p, Value);
+
+    __m256 q;
+    q = MlasActivationMultiplyAdd(ValueSquared, _mm256_set1_ps(MlasTanhConstants.beta_6),
+                                  _mm256_set1_ps(MlasTanhConstants.beta_4));
+    q = MlasActivationMultiplyAdd(q, ValueSquared, _mm256_set1_ps(MlasTanhConstants.beta_2));
+    q = MlasActivationMultiplyAdd(q, ValueSquared, _mm256_set1_ps(MlasTanhConstants.beta_0));
+
+    __m256 Saturated = _mm256_or_ps(_mm256_set1_ps(1.0f), _mm256_and_ps(Value, SignMask));
+
+    return _mm256_blendv_ps(_mm256_div_ps(p, q), Saturated, SaturatedMask);
+}
+
+MLAS_FORCEINLINE
+__m256
+MlasExpAvx(__m256 Value)
+{
+    const __m256 LowerRange = _mm256_set1_ps(MlasExpConstants.LowerRange);
+    const __m256 UpperRange = _mm256_set1_ps(MlasExpConstants.UpperRange);
+
+    __m256 UnderflowMask = _mm256_cmp_ps(Value, LowerRange, _CMP_LT_OQ);
+    __m256 OverflowMask = _mm256_cmp_ps(Value, UpperRange, _CMP_GT_OQ);
+
+    Value = _mm256_max_ps(LowerRange, Value);
+    Value = _mm256_min_ps(UpperRange, Value);
+
+    __m256 RoundingBias = _mm256_set1_ps(MlasExpConstants.RoundingBias);
+    __m256 n = MlasActivationMultiplyAdd(Value, _mm256_set1_ps(MlasExpConstants.Log2Reciprocal), RoundingBias);
+    n = _mm256_sub_ps(n, RoundingBias);
+
+    __m256 r = MlasActivationMultiplyAdd(n, _mm256_set1_ps(MlasExpConstants.Log2High), Value);
+    r = MlasActivationMultiplyAdd(n, _mm256_set1_ps(MlasExpConstants.Log2Low), r);
+
+    __m256 p;
+    p = MlasActivationMultiplyAdd(r, _mm256_set1_ps(MlasExpConstants.poly_6), _mm256_set1_ps(MlasExpConstants.poly_5));
+    p = MlasActivationMultiplyAdd(p, r, _mm256_set1_ps(MlasExpConstants.poly_4));
+    p = MlasActivationMultiplyAdd(p, r, _mm256_set1_ps(MlasExpConstants.poly_3));
+    p = MlasActivationMultiplyAdd(p, r, _mm256_set1_ps(MlasExpConstants.poly_2));
+    p = MlasActivationMultiplyAdd(p, r, _mm256_set1_ps(MlasExpConstants.poly_1));
+    p = MlasActivationMultiplyAdd(p, r, _mm256_set1_ps(MlasExpConstants.poly_0));
+
+    //
+    // Build 2^(n - 1) from the exponent field (n - 1 + 127) << 23, which is
+    // computed in floating point and converted so that no AVX2 integer
+    // operations are needed, and then double the scaled result.
+    //
+
+    __m256 Exponent = _mm256_mul_ps(_mm256_add_ps(n, _mm256_set1_ps(126.0f)), _mm256_set1_ps(8388608.0f));
+    __m256 PowerOf2 = _mm256_castsi256_ps(_mm256_cvtps_epi32(Exponent));
+
+    p = _mm256_mul_ps(p, PowerOf2);
+    p = _mm256_add_ps(p, p);
+
+    p = _mm256_andnot_ps(UnderflowMask, p);
+    p = _mm256_blendv_ps(p, _mm256_set1_ps(std::numeric_limits<float>::infinity()), OverflowMask);
+
+    return p;
+}
+
+MLAS_FORCEINLINE
+__m256
+MlasLogisticAvx(__m256 Value)
+{
+    const __m256 One = _mm256_set1_ps(1.0f);
+    __m256 NegativeExp = MlasExpAvx(_mm256_xor_ps(Value, _mm256_set1_ps(-0.0f)));
+    return _mm256_div_ps(One, _mm256_add_ps(One, NegativeExp));
+}
+
+MLAS_FORCEINLINE
+__m256
+MlasErfAvx(__m256 Value)
+{
+    const __m256 SignMask = _mm256_set1_ps(-0.0f);
+    const __m256 One = _mm256_set1_ps(1.0f);
+
+    __m256 AbsValue = _mm256_andnot_ps(SignMask, Value);
+    __m256 ValueSquared = _mm256_mul_ps(Value, Value);
+
+    __m256 s;
+    s = MlasActivationMultiplyAdd(ValueSquared, _mm256_set1_ps(MlasErfConstants.small_10),
+                                  _mm256_set1_ps(MlasErfConstants.small_9));
+    s = MlasActivationMultiplyAdd(s, ValueSquared, _mm256_set1_ps(MlasErfConstants.small_8));
+    s = MlasActivationMultiplyAdd(s, ValueSquared, _mm256_set1_ps(MlasErfConstants.small_7));
+    s = MlasActivationMultiplyAdd(s, ValueSquared, _mm256_set1_ps(MlasErfConstants.small_6));
+    s = MlasActivationMultiplyAdd(s, ValueSquared, _mm256_set1_ps(MlasErfConstants.small_5));
+    s = MlasActivationMultiplyAdd(s, ValueSquared, _mm256_set1_ps(MlasErfConstants.small_4));
+    s = MlasActivationMultiplyAdd(s, ValueSquared, _mm256_set1_ps(MlasErfConstants.small_3));
+    s = MlasActivationMultiplyAdd(s, ValueSquared, _mm256_set1_ps(MlasErfConstants.small_2));
+    s = MlasActivationMultiplyAdd(s, ValueSquared, _mm256_set1_ps(MlasErfConstants.small_1));
+    s = MlasActivationMultiplyAdd(s, ValueSquared, _mm256_set1_ps(MlasErfConstants.small_0));
+    s = _mm256_mul_ps(s, Value);
+
+    __m256 t = _mm256_div_ps(One, MlasActivationMultiplyAdd(AbsValue, _mm256_set1_ps(MlasErfConstants.p), One));
+
+    __m256 l;
+    l = MlasActivationMultiplyAdd(t, _mm256_set1_ps(MlasErfConstants.a5), _mm256_set1_ps(MlasErfConstants.a4));
+    l = MlasActivationMultiplyAdd(l, t, _mm256_set1_ps(MlasErfConstants.a3));
+    l = MlasActivationMultiplyAdd(l, t, _mm256_set1_ps(MlasErfConstants.a2));
+    l = MlasActivationMultiplyAdd(l, t, _mm256_set1_ps(MlasErfConstants.a1));
+    l = _mm256_mul_ps(l, t);
+    l = _mm256_mul_ps(l, MlasExpAvx(_mm256_xor_ps(ValueSquared, SignMask)));
+    l = _mm256_sub_ps(One, l);
+    l = _mm256_or_ps(l, _mm256_and_ps(Value, SignMask));
+
+    __m256 LargeMask = _mm256_cmp_ps(AbsValue, _mm256_set1_ps(MlasErfConstants.SplitBoundary), _CMP_GT_OQ);
+
+    return _mm256_blendv_ps(s, l, LargeMask);
+}
+
+}  // namespace
@@ -0,0 +1,347 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute_fma3.cpp
+
+Abstract:
+
+    This module implements the elementwise exponential, hyperbolic tangent,
+    logistic and error function kernels and the softmax kernels for
+    processors with AVX2/FMA3 support. The kernels evaluate the same
+    approximations as the generic kernels with eight element vectors.
+
+--*/
+
+#include "compute_avx.h"
+
+namespace {
+
+template <__m256 (*Function)(__m256)>
+void
+MlasComputeUnaryKernelAvx(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the templated function to each element of the input
+    buffer. The remaining elements are processed with masked loads and stores.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 8) {
+
+        _mm256_storeu_ps(Output, Function(_mm256_loadu_ps(Input)));
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+    if (N > 0) {
+
+        const __m256i RemainingMask = _mm256_loadu_si256((const __m256i*)&MlasMaskMoveTableAvx[8 - N]);
+
+        __m256 Vector = _mm256_maskload_ps(Input, RemainingMask);
+        _mm256_maskstore_ps(Output, RemainingMask, Function(Vector));
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasComputeSumExpAccumulateAvx(
+    __m256& MaximumVector,
+    __m256& Accumulator,
+    __m256 BlockMaximum
+    )
+{
+    //
+    // Skip the rescaling if no lane has a new maximum, which is the common
+    // case once the running maximum is near the maximum of the input.
+    //
+
+    if (_mm256_movemask_ps(_mm256_cmp_ps(BlockMaximum, MaximumVector, _CMP_GT_OQ)) == 0) {
+        return;
+    }
+
+    __m256 NewMaximum = _mm256_max_ps(MaximumVector, BlockMaximum);
+
+    Accumulator = _mm256_mul_ps(Accumulator, MlasExpAvx(_mm256_sub_ps(MaximumVector, NewMaximum)));
+    MaximumVector = NewMaximum;
+}
+
+}  // namespace
+
+void
+MLASCALL
+MlasComputeExpF32KernelFma3(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    MlasComputeUnaryKernelAvx<MlasExpAvx>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeTanhF32KernelFma3(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    MlasComputeUnaryKernelAvx<MlasTanhAvx>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeLogisticF32KernelFma3(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    MlasComputeUnaryKernelAvx<MlasLogisticAvx>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasErfKernelFma3(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+{
+    MlasComputeUnaryKernelAvx<MlasErfAvx>(Input, Output, N);
+}
+
+float
+MLASCALL
+MlasComputeSumExpF32KernelFma3(
+    const float* Input,
+    size_t N,
+    float* Maximum
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the first pass of the softmax routines, which
+    finds the maximum of the input buffer and the sum of the exponentials of
+    the elements relative to the maximum.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+    Maximum - Receives the maximum of the input buffer, or the lowest float
+        value if the buffer is empty.
+
+Return Value:
+
+    Returns the sum of exp(Input[i] - Maximum).
+
+--*/
+{
+    const __m256 Lowest = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+
+    __m256 MaximumVector = Lowest;
+    __m256 Accumulator = _mm256_setzero_ps();
+
+    while (N >= 32) {
+
+        __m256 Vector0 = _mm256_loadu_ps(Input);
+        __m256 Vector1 = _mm256_loadu_ps(Input + 8);
+        __m256 Vector2 = _mm256_loadu_ps(Input + 16);
+        __m256 Vector3 = _mm256_loadu_ps(Input + 24);
+
+        __m256 BlockMaximum = _mm256_max_ps(_mm256_max_ps(Vector0, Vector1), _mm256_max_ps(Vector2, Vector3));
+
+        MlasComputeSumExpAccumulateAvx(MaximumVector, Accumulator, BlockMaximum);
+
+        Vector0 = MlasExpAvx(_mm256_sub_ps(Vector0, MaximumVector));
+        Vector1 = MlasExpAvx(_mm256_sub_ps(Vector1, MaximumVector));
+        Vector2 = MlasExpAvx(_mm256_sub_ps(Vector2, MaximumVector));
+        Vector3 = MlasExpAvx(_mm256_sub_ps(Vector3, MaximumVector));
+
+        Accumulator = _mm256_add_ps(Accumulator, _mm256_add_ps(_mm256_add_ps(Vector0, Vector1),
+                                                               _mm256_add_ps(Vector2, Vector3)));
+
+        Input += 32;
+        N -= 32;
+    }
+
+    while (N > 0) {
+
+        __m256 Vector;
+
+        if (N >= 8) {
+
+            Vector = _mm256_loadu_ps(Input);
+
+            Input += 8;
+            N -= 8;
+
+        } else {
+
+            //
+            // Pad the remaining elements with the lowest float value, which
+            // adds nothing to the sum of a lane with an element.
+            //
+
+            const __m256i RemainingMask = _mm256_loadu_si256((const __m256i*)&MlasMaskMoveTableAvx[8 - N]);
+
+            Vector = _mm256_blendv_ps(Lowest, _mm256_maskload_ps(Input, RemainingMask),
+                                      _mm256_castsi256_ps(RemainingMask));
+
+            N = 0;
+        }
+
+        MlasComputeSumExpAccumulateAvx(MaximumVector, Accumulator, Vector);
+
+        Accumulator = _mm256_add_ps(Accumulator, MlasExpAvx(_mm256_sub_ps(Vector, MaximumVector)));
+    }
+
+    //
+    // Rescale the partial sums of the lanes to the maximum of all lanes.
+    //
+
+    __m128 Maximum4 = _mm_max_ps(_mm256_castps256_ps128(MaximumVector), _mm256_extractf128_ps(MaximumVector, 1));
+
+    *Maximum = MlasReduceMaximumFloat32x4(Maximum4);
+
+    MlasComputeSumExpAccumulateAvx(MaximumVector, Accumulator, _mm256_set1_ps(*Maximum));
+
+    __m128 Accumulator4 = _mm_add_ps(_mm256_castps256_ps128(Accumulator), _mm256_extractf128_ps(Accumulator, 1));
+
+    return MlasReduceAddFloat32x4(Accumulator4);
+}
+
+void
+MLASCALL
+MlasComputeSoftmaxOutputF32KernelFma3(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the second pass of the softmax routine.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies an array containing the negated maximum and the
+        reciprocal of the sum of the exponentials.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const __m256 NegativeMaximum = _mm256_broadcast_ss(&Parameters[0]);
+    const __m256 Scale = _mm256_broadcast_ss(&Parameters[1]);
+
+    while (N >= 8) {
+
+        __m256 Vector = MlasExpAvx(_mm256_add_ps(_mm256_loadu_ps(Input), NegativeMaximum));
+        _mm256_storeu_ps(Output, _mm256_mul_ps(Vector, Scale));
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+    if (N > 0) {
+
+        const __m256i RemainingMask = _mm256_loadu_si256((const __m256i*)&MlasMaskMoveTableAvx[8 - N]);
+
+        __m256 Vector = MlasExpAvx(_mm256_add_ps(_mm256_maskload_ps(Input, RemainingMask), NegativeMaximum));
+        _mm256_maskstore_ps(Output, RemainingMask, _mm256_mul_ps(Vector, Scale));
+    }
+}
+
+void
+MLASCALL
+MlasComputeLogSoftmaxOutputF32KernelFma3(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the second pass of the log softmax routine.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies an array containing the negated maximum and the
+        logarithm of the sum of the exponentials.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const __m256 NegativeMaximum = _mm256_broadcast_ss(&Parameters[0]);
+    const __m256 Logarithm = _mm256_broadcast_ss(&Parameters[1]);
+
+    while (N >= 8) {
+
+        __m256 Vector = _mm256_add_ps(_mm256_loadu_ps(Input), NegativeMaximum);
+        _mm256_storeu_ps(Output, _mm256_sub_ps(Vector, Logarithm));
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+    if (N > 0) {
+
+        const __m256i RemainingMask = _mm256_loadu_si256((const __m256i*)&MlasMaskMoveTableAvx[8 - N]);
+
+        __m256 Vector = _mm256_add_ps(_mm256_maskload_ps(Input, RemainingMask), NegativeMaximum);
+        _mm256_maskstore_ps(Output, RemainingMask, _mm256_sub_ps(Vector, Logarithm));
+    }
+}
@@ -16,6 +16,8 @@ Abstract:
 
 #include "mlasi.h"
 
+#include <thread>
+
 //
 // Define the number of working buffer elements required per thread.
 //
@@ -35,13 +37,21 @@ struct MLAS_CONV_WORK_BLOCK {
     const float* Bias;
     float* WorkingBuffer;
     float* Output;
-    struct SEGMENT {
-        size_t StartN;
-        size_t CountN;
-    } Segments[MLAS_MAXIMUM_THREAD_COUNT];
+    size_t ThreadStrideN;
+    size_t WorkingBufferCount;
+    std::atomic<uint64_t>* WorkingBufferInUse;
     ptrdiff_t TargetThreadCount;
+    ptrdiff_t ThreadCountM;
+    ptrdiff_t ThreadCountN;
 };
 
+//
+// Define the number of working buffers that can be tracked without allocating
+// memory for the in use flags.
+//
+
+#define MLAS_CONV_INLINE_WORKING_BUFFER_COUNT 256
+
 void
 MlasConvIm2Col(
     const MLAS_CONV_PARAMETERS* Parameters,
@@ -481,6 +491,199 @@ Return Value:
     }
 }
 
+void
+MlasConvPackPatches(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    float* PanelB,
+    size_t k,
+    size_t CountK,
+    size_t n,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine gathers a set of convolution patches directly into the
+    packed matrix B format consumed by the SGEMM kernels.
+
+    The packed format stores columns of 16 elements contiguously for each row
+    of the slice, which is the layout produced by sampling 16 convolution
+    patches at a time, so the patches do not need to be expanded to a column
+    buffer and then packed again.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    PanelB - Supplies the buffer to receive the packed convolution patches.
+
+    k - Supplies the K to begin sampling the convolution patches.
+
+    CountK - Supplies the count of K to sample for the convolution patches.
+
+    n - Supplies the N to begin sampling the convolution patches.
+
+    CountN - Supplies the count of N to sample for the convolution patches.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (CountN > 0) {
+
+        const size_t CountX = std::min(CountN, size_t(16));
+
+        if (Parameters->Dimensions == 2) {
+            MlasConvIm2Col(Parameters, Input, PanelB, k, CountK, n, CountX);
+        } else {
+            MlasConvVol2Col(Parameters, Input, PanelB, k, CountK, n, CountX);
+        }
+
+        //
+        // Spread the rows of a partial block of columns to the packed row
+        // width and zero pad the remaining columns. The rows are moved
+        // starting from the last row, so no row is overwritten before it has
+        // been moved.
+        //
+
+        if (CountX < 16) {
+
+            for (size_t y = CountK; y-- > 0;) {
+
+                float* d = PanelB + y * 16;
+                const float* b = PanelB + y * CountX;
+
+                for (size_t x = 16; x-- > CountX;) {
+                    d[x] = 0.0f;
+                }
+
+                for (size_t x = CountX; x-- > 0;) {
+                    d[x] = b[x];
+                }
+            }
+        }
+
+        PanelB += CountK * 16;
+        n += CountX;
+        CountN -= CountX;
+    }
+}
+
+MLAS_FORCEINLINE
+MLAS_SGEMM_EPILOGUE
+MlasConvEpilogue(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Bias
+    )
+/*++
+
+Routine Description:
+
+    This routine builds the SGEMM epilogue that applies the activation with
+    optional bias to the output of a convolution.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Bias - Optionally supplies the bias vector of the group.
+
+Return Value:
+
+    Returns the epilogue.
+
+--*/
+{
+    MLAS_SGEMM_EPILOGUE Epilogue;
+
+    Epilogue.Bias = Bias;
+    Epilogue.BiasKind = MlasSgemmBiasPerRow;
+    Epilogue.Activation = Parameters->Activation;
+
+    return Epilogue;
+}
+
+void
+MlasConvGemm(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    CBLAS_TRANSPOSE TransB,
+    size_t FilterCount,
+    size_t OutputSize,
+    size_t K,
+    const float* Filter,
+    const float* B,
+    size_t ldb,
+    float Beta,
+    float* Output,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine invokes the threaded GEMM for a group of a convolution
+    operation with the epilogue fused into the GEMM.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    FilterCount - Supplies the number of filters of the group.
+
+    OutputSize - Supplies the number of output elements per filter.
+
+    K - Supplies the number of filter elements per filter.
+
+    Filter - Supplies the filter tensor of the group, which is packed if the
+        filter of the convolution is packed.
+
+    B - Supplies the input tensor or the expanded input tensor.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    Beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    Output - Supplies the output tensor of the group.
+
+    Epilogue - Supplies the epilogue.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_DATA_PARAMS Data;
+
+    Data.A = Filter;
+    Data.lda = K;
+    Data.B = B;
+    Data.ldb = ldb;
+    Data.C = Output;
+    Data.ldc = OutputSize;
+    Data.alpha = 1.0f;
+    Data.beta = Beta;
+    Data.Epilogue = Epilogue;
+    Data.AIsPacked = Parameters->FilterIsPacked;
+
+    MlasGemmBatch(CblasNoTrans, TransB, FilterCount, OutputSize, K, &Data, 1, ThreadPool);
+}
+
 void
 MlasConvOperation(
     const MLAS_CONV_PARAMETERS* Parameters,
@@ -528,6 +731,8 @@ Return Value:
     const size_t OutputSize = Parameters->OutputSize;
     const size_t K = Parameters->K;
 
+    const MLAS_SGEMM_EPILOGUE Epilogue = MlasConvEpilogue(Parameters, Bias);
+
     //
     // Compute the strides to step through slices of the local segment.
     //
@@ -537,7 +742,22 @@ Return Value:
     uint32_t StrideN = MLAS_SGEMM_STRIDEN;
     uint32_t StrideK = MLAS_SGEMM_STRIDEK;
 
-    if (SegmentCountN >= K) {
+    if (Parameters->FilterIsPacked) {
+
+        //
+        // The K stride is fixed by the layout of the packed filter. Size the
+        // N stride so that a slice of the input tensor fits in the working
+        // buffer.
+        //
+
+        StrideK = MLAS_SGEMM_PACKED_STRIDEK;
+        StrideN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+        while (StrideN * 2 * std::min(K, size_t(StrideK)) <= MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD) {
+            StrideN *= 2;
+        }
+
+    } else if (SegmentCountN >= K) {
 
         while (StrideK / 2 >= K) {
             StrideN *= 2;
@@ -590,19 +810,30 @@ Return Value:
                     SegmentStartN + n, CountN);
             }
 
+            //
+            // A slice of the packed filter stores the rows of the slice
+            // contiguously.
+            //
+
+            const float* filter = Filter + k;
+            size_t ldf = K;
+
+            if (Parameters->FilterIsPacked) {
+                filter = Filter + FilterCount * k;
+                ldf = CountK;
+            }
+
+            //
+            // Apply the activation with optional bias as part of the last
+            // slice along the K dimension.
+            //
+
             MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountN,
-                CountK, 1.0f, Filter + k, K, ColumnBuffer, CountN, beta,
-                SegmentOutput, OutputSize);
+                CountK, 1.0f, filter, ldf, ColumnBuffer, CountN, beta,
+                SegmentOutput, OutputSize, (k + CountK == K) ? &Epilogue : nullptr);
 
             beta = 1.0f;
         }
-
-        //
-        // Apply the activation with optional bias.
-        //
-
-        MlasActivation(Parameters->Activation, SegmentOutput, Bias, FilterCount,
-            CountN, OutputSize);
     }
 }
 
@@ -618,6 +849,14 @@ Routine Description:
     This routine is invoked from a worker thread to execute a segment of a
     convolution operation.
 
+    The operation may have more segments than working buffers, so the segment
+    claims a working buffer that is not in use by another segment. The number
+    of working buffers is bounded by the degree of parallelism of the thread
+    pool passed to MlasConvPrepare, so more segments than working buffers may
+    run concurrently, for example on a larger thread pool. A segment that
+    finds all working buffers in use yields the processor until a running
+    segment releases its working buffer.
+
 Arguments:
 
     Context - Supplies the pointer to the context for the threaded operation.
@@ -632,14 +871,44 @@ Return Value:
 {
     MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
 
-    MLAS_CONV_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+    const size_t OutputSize = WorkBlock->Parameters->OutputSize;
+    const size_t SegmentStartN = size_t(Index) * WorkBlock->ThreadStrideN;
+    const size_t SegmentCountN = std::min(WorkBlock->ThreadStrideN, OutputSize - SegmentStartN);
+
+    const size_t WorkingBufferCount = WorkBlock->WorkingBufferCount;
+    const size_t FirstSlot = size_t(Index) % WorkingBufferCount;
+    size_t Slot = FirstSlot;
+
+    for (;;) {
+
+        const uint64_t Bit = uint64_t(1) << (Slot % 64);
+
+        if ((WorkBlock->WorkingBufferInUse[Slot / 64].fetch_or(Bit, std::memory_order_acquire) & Bit) == 0) {
+            break;
+        }
+
+        Slot = (Slot + 1) % WorkingBufferCount;
+
+        //
+        // Every working buffer is in use by a segment running on another
+        // thread, which does not wait on this segment, so yield the processor
+        // before scanning the working buffers again.
+        //
+
+        if (Slot == FirstSlot) {
+            std::this_thread::yield();
+        }
+    }
 
     float* ColumnBuffer =
-        WorkBlock->WorkingBuffer + Index * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
+        WorkBlock->WorkingBuffer + Slot * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
 
     MlasConvOperation(WorkBlock->Parameters, WorkBlock->Input, WorkBlock->Filter,
-        WorkBlock->Bias, ColumnBuffer, WorkBlock->Output, Segment->StartN,
-        Segment->CountN);
+        WorkBlock->Bias, ColumnBuffer, WorkBlock->Output, SegmentStartN,
+        SegmentCountN);
+
+    WorkBlock->WorkingBufferInUse[Slot / 64].fetch_and(~(uint64_t(1) << (Slot % 64)),
+        std::memory_order_release);
 }
 
 void
@@ -706,46 +975,51 @@ Return Value:
         const float* filter = WorkBlock->Filter + group * FilterGroupSize;
         float* output = WorkBlock->Output + bg * OutputGroupSize;
 
-        //
-        // Invoke the non-threaded GEMM directly with the input tensor.
-        //
+        const float* bias = WorkBlock->Bias;
 
-        MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount, OutputSize,
-                           K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, Beta, output,
-                           OutputSize);
+        if (bias != nullptr) {
+            bias += group * FilterCount;
+        }
 
         //
-        // Apply the activation with optional bias.
+        // Invoke the non-threaded GEMM directly with the input tensor and
+        // apply the activation with optional bias.
         //
 
-        const float* bias = WorkBlock->Bias;
+        const MLAS_SGEMM_EPILOGUE Epilogue = MlasConvEpilogue(Parameters, bias);
 
-        if (bias != nullptr) {
-            bias += group * FilterCount;
+        if (Parameters->FilterIsPacked) {
+            MlasSgemmPackedAOperation(Parameters->u.GemmDirect.TransB, FilterCount, OutputSize, K,
+                                      1.0f, filter, FilterCount, 0, input, Parameters->u.GemmDirect.ldb,
+                                      false, 0, 0, Beta, output, OutputSize, &Epilogue);
+        } else {
+            MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount, OutputSize,
+                               K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, Beta, output,
+                               OutputSize, &Epilogue);
         }
-
-        MlasActivation(Parameters->Activation, output, bias, FilterCount,
-            OutputSize, OutputSize);
     }
 }
 
-inline
-bool
-MlasConvTryMultithread(
+void
+MlasConvImplicitGemmOperation(
     const MLAS_CONV_PARAMETERS* Parameters,
     const float* Input,
     const float* Filter,
     const float* Bias,
-    float* WorkingBuffer,
     float* Output,
-    MLAS_THREADPOOL* ThreadPool
+    size_t StartM,
+    size_t CountM,
+    size_t StartN,
+    size_t CountN
     )
 /*++
 
 Routine Description:
 
-    This routine attempts to launch a convolution operation across multiple
-    threads.
+    This routine implements a block of the convolution operation as an
+    implicit GEMM: the convolution patches for each slice of the GEMM are
+    gathered into a local packed buffer that is consumed by the SGEMM
+    kernels, so the operation does not need a working buffer.
 
 Arguments:
 
@@ -758,99 +1032,1621 @@ Arguments:
 
     Bias - Optionally supplies the bias vector.
 
-    WorkingBuffer - Supplies a working buffer sized to the number of elements
-        returned by MlasConvPrepare.
-
     Output - Supplies the output tensor.
 
-    ThreadPool - Supplies the thread pool object to use, else nullptr if the
-        base library threading support should be used.
+    StartM - Supplies the first filter of the block.
+
+    CountM - Supplies the number of filters of the block.
+
+    StartN - Supplies the first output element of the block.
+
+    CountN - Supplies the number of output elements of the block.
 
 Return Value:
 
-    Returns true if the operation was completed across multiple threads, else
-    false if the operation should fall back to a single thread.
+    None.
 
 --*/
 {
-    MLAS_CONV_WORK_BLOCK WorkBlock;
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
 
+    const size_t FilterCount = Parameters->FilterCount;
     const size_t OutputSize = Parameters->OutputSize;
-    const size_t ThreadStrideN = Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
+    const size_t K = Parameters->K;
 
-    if (ThreadStrideN >= OutputSize) {
-        return false;
-    }
+    const MLAS_SGEMM_EPILOGUE Epilogue =
+        MlasConvEpilogue(Parameters, (Bias != nullptr) ? Bias + StartM : nullptr);
 
     //
-    // Initialize the common fields of the work block.
+    // Compute the strides to step through slices of the block. A slice of
+    // the convolution patches must fit in the local packed buffer.
+    //
+    // See MlasSgemmOperation.
     //
 
-    WorkBlock.Parameters = Parameters;
-    WorkBlock.Input = Input;
-    WorkBlock.Filter = Filter;
-    WorkBlock.Bias = Bias;
-    WorkBlock.WorkingBuffer = WorkingBuffer;
-    WorkBlock.Output = Output;
+    uint32_t StrideN = MLAS_SGEMM_STRIDEN;
+    uint32_t StrideK = MLAS_SGEMM_STRIDEK;
 
-    //
-    // Segment the operation across multiple threads.
-    //
+    if (Parameters->FilterIsPacked) {
 
-    int32_t Index = 0;
-    size_t SegmentCountN;
+        StrideK = MLAS_SGEMM_PACKED_STRIDEK;
+        StrideN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
 
-    for (size_t SegmentStartN = 0; SegmentStartN < OutputSize; SegmentStartN += SegmentCountN) {
+        while (StrideN * 2 * std::min(K, size_t(StrideK)) <= MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK) {
+            StrideN *= 2;
+        }
 
-        SegmentCountN = OutputSize - SegmentStartN;
+    } else if (CountN >= K) {
 
-        if (SegmentCountN > ThreadStrideN) {
-            SegmentCountN = ThreadStrideN;
+        while (StrideK / 2 >= K) {
+            StrideN *= 2;
+            StrideK /= 2;
         }
 
-        WorkBlock.Segments[Index].StartN = SegmentStartN;
-        WorkBlock.Segments[Index].CountN = SegmentCountN;
+    } else {
+
+        //
+        // The packed GEMM steps through the patches in slices of the packed
+        // K stride, so a slice along the K dimension cannot be larger.
+        //
 
-        Index++;
+        while (StrideN > 16 && StrideN / 2 >= CountN && StrideK * 2 <= MLAS_SGEMM_PACKED_STRIDEK) {
+            StrideK *= 2;
+            StrideN /= 2;
+        }
     }
 
-    MlasExecuteThreaded(MlasConvOperationThreaded, &WorkBlock, Index, ThreadPool);
+    //
+    // Step through each slice of the convolution patches along the N
+    // dimension.
+    //
 
-    return true;
-}
+    size_t SliceCountN;
 
-void
-MLASCALL
-MlasConv(
-    const MLAS_CONV_PARAMETERS* Parameters,
-    const float* Input,
-    const float* Filter,
-    const float* Bias,
-    float* WorkingBuffer,
-    float* Output,
-    MLAS_THREADPOOL* ThreadPool
-    )
-/*++
+    for (size_t n = 0; n < CountN; n += SliceCountN) {
 
-Routine Description:
+        SliceCountN = std::min(CountN - n, size_t(StrideN));
 
-    This routine implements the convolution operation.
+        //
+        // Step through each slice of the convolution patches along the K
+        // dimension.
+        //
 
-Arguments:
+        size_t CountK;
+        float beta = Parameters->Beta;
+        float* SliceOutput = Output + StartM * OutputSize + StartN + n;
 
-    Parameters - Supplies the structure that contains the convolution
-        parameters.
+        for (size_t k = 0; k < K; k += CountK) {
 
-    Input - Supplies the input tensor.
+            CountK = std::min(K - k, size_t(StrideK));
 
-    Filter - Supplies the filter tensor.
+            MlasConvPackPatches(Parameters, Input, PanelB, k, CountK, StartN + n, SliceCountN);
 
-    Bias - Optionally supplies the bias vector.
+            //
+            // Apply the activation with optional bias as part of the last
+            // slice along the K dimension.
+            //
 
-    WorkingBuffer - Supplies a working buffer sized to the number of elements
-        returned by MlasConvPrepare.
+            const MLAS_SGEMM_EPILOGUE* SliceEpilogue = (k + CountK == K) ? &Epilogue : nullptr;
 
-    Output - Supplies the output tensor.
+            if (Parameters->FilterIsPacked) {
+                MlasSgemmPackedAOperation(CblasNoTrans, CountM, SliceCountN, CountK, 1.0f,
+                    Filter + FilterCount * k, FilterCount, StartM, PanelB, 0, true, 0, 0,
+                    beta, SliceOutput, OutputSize, SliceEpilogue);
+            } else {
+                MlasSgemmPackedOperation(CblasNoTrans, CountM, 0, SliceCountN, CountK, 1.0f,
+                    Filter + StartM * K + k, K, PanelB, 0, beta, SliceOutput, OutputSize,
+                    SliceEpilogue);
+            }
+
+            beta = 1.0f;
+        }
+    }
+}
+
+void
+MlasConvImplicitGemmThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a block of an
+    implicit GEMM convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const ptrdiff_t ThreadIdM = Index / WorkBlock->ThreadCountN;
+    const ptrdiff_t ThreadIdN = Index % WorkBlock->ThreadCountN;
+
+    //
+    // Partition the operation along the M dimension.
+    //
+
+    size_t StartM;
+    size_t CountM;
+
+    MlasPartitionWork(ThreadIdM, WorkBlock->ThreadCountM, Parameters->FilterCount,
+        &StartM, &CountM);
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    const size_t OutputSize = Parameters->OutputSize;
+
+    size_t StartN;
+    size_t CountN;
+
+    const size_t BlockedN = (OutputSize + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    MlasPartitionWork(ThreadIdN, WorkBlock->ThreadCountN, BlockedN, &StartN, &CountN);
+
+    StartN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    CountN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    if (StartN >= OutputSize || CountM == 0) {
+        return;
+    }
+
+    CountN = std::min(CountN, OutputSize - StartN);
+
+    MlasConvImplicitGemmOperation(Parameters, WorkBlock->Input, WorkBlock->Filter,
+        WorkBlock->Bias, WorkBlock->Output, StartM, CountM, StartN, CountN);
+}
+
+void
+MlasConvImplicitGemm(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a group of the convolution operation as an
+    implicit GEMM, partitioned across threads as a grid of blocks of filters
+    and output elements.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor of the group.
+
+    Filter - Supplies the filter tensor of the group.
+
+    Bias - Optionally supplies the bias vector of the group.
+
+    Output - Supplies the output tensor of the group.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // convolution operation (see MlasGemmBatch).
+    //
+
+    const double Complexity = double(FilterCount) * double(OutputSize) * double(K);
+
+    const ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+    if (TargetThreadCount > MaximumThreadCount) {
+        TargetThreadCount = (MaximumThreadCount > 1) ?
+            std::min(MaximumThreadCount * MLAS_THREADED_WORK_ITEMS_PER_THREAD, TargetThreadCount) : 1;
+    }
+
+    if (TargetThreadCount == 1) {
+        MlasConvImplicitGemmOperation(Parameters, Input, Filter, Bias, Output, 0, FilterCount,
+            0, OutputSize);
+        return;
+    }
+
+    MLAS_CONV_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = nullptr;
+    WorkBlock.Output = Output;
+
+    MlasSgemmPartitionThreads(FilterCount, OutputSize, K, TargetThreadCount,
+        &WorkBlock.ThreadCountM, &WorkBlock.ThreadCountN);
+
+    MlasExecuteThreaded(MlasConvImplicitGemmThreaded, &WorkBlock,
+        WorkBlock.ThreadCountM * WorkBlock.ThreadCountN, ThreadPool);
+}
+
+//
+// Define the tile sizes of the Winograd F(4x4, 3x3) convolution algorithm. A
+// 6x6 tile of the input produces a 4x4 tile of the output, with the product of
+// the transformed input and filter tiles computed as 36 GEMMs over the
+// channels.
+//
+
+#define MLAS_CONV_WINOGRAD_TILE_SIZE 6
+#define MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE 4
+#define MLAS_CONV_WINOGRAD_TILE_ELEMENTS (MLAS_CONV_WINOGRAD_TILE_SIZE * MLAS_CONV_WINOGRAD_TILE_SIZE)
+
+//
+// Define the target number of working buffer elements per thread for the
+// transformed input and output tiles of a block of tiles.
+//
+
+#define MLAS_CONV_WINOGRAD_BLOCK_ELEMENTS (64 * 1024)
+
+//
+// Define the minimum number of input channels and filters to use the Winograd
+// algorithm, below which the cost of the transforms outweighs the reduction
+// in multiplies.
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS 32
+
+//
+// Define the number of elements to pad each transformed matrix, so that the
+// matrices of the elements of a tile do not map to the same cache sets when
+// the matrix size is a multiple of a large power of two.
+//
+
+#define MLAS_CONV_WINOGRAD_MATRIX_PADDING 16
+
+MLAS_FORCEINLINE
+size_t
+MlasConvWinogradTileCount(
+    const MLAS_CONV_PARAMETERS* Parameters
+    )
+{
+    const size_t TileCountH = (Parameters->OutputShape[0] + MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE - 1) /
+        MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE;
+    const size_t TileCountW = (Parameters->OutputShape[1] + MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE - 1) /
+        MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE;
+
+    return TileCountH * TileCountW;
+}
+
+MLAS_FORCEINLINE
+size_t
+MlasConvWinogradFilterMatrixSize(
+    const MLAS_CONV_PARAMETERS* Parameters
+    )
+{
+    return Parameters->FilterCount * Parameters->InputChannels + MLAS_CONV_WINOGRAD_MATRIX_PADDING;
+}
+
+MLAS_FORCEINLINE
+size_t
+MlasConvWinogradWorkingBufferSize(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    size_t TileBlockSize
+    )
+{
+    const size_t InputMatrixSize = Parameters->InputChannels * TileBlockSize + MLAS_CONV_WINOGRAD_MATRIX_PADDING;
+    const size_t OutputMatrixSize = Parameters->FilterCount * TileBlockSize + MLAS_CONV_WINOGRAD_MATRIX_PADDING;
+
+    return MLAS_CONV_WINOGRAD_TILE_ELEMENTS * (InputMatrixSize + OutputMatrixSize);
+}
+
+//
+// Define the transforms of the Winograd algorithm. The transforms are applied
+// to the rows and then the columns of a tile, with the elements of a row or
+// column separated by the supplied stride.
+//
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradFilterTransform(
+    const float* g,
+    size_t gs,
+    float* u,
+    size_t us
+    )
+{
+    const float g0 = g[0];
+    const float g1 = g[gs];
+    const float g2 = g[gs * 2];
+
+    u[0] = g0 * (1.0f / 4.0f);
+    u[us] = (g0 + g1 + g2) * (-1.0f / 6.0f);
+    u[us * 2] = (g0 - g1 + g2) * (-1.0f / 6.0f);
+    u[us * 3] = g0 * (1.0f / 24.0f) + g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+    u[us * 4] = g0 * (1.0f / 24.0f) - g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+    u[us * 5] = g2;
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradInputTransform(
+    const float* d,
+    size_t ds,
+    float* v,
+    size_t vs
+    )
+{
+    const float d0 = d[0];
+    const float d1 = d[ds];
+    const float d2 = d[ds * 2];
+    const float d3 = d[ds * 3];
+    const float d4 = d[ds * 4];
+    const float d5 = d[ds * 5];
+
+    v[0] = 4.0f * d0 - 5.0f * d2 + d4;
+    v[vs] = -4.0f * (d1 + d2) + (d3 + d4);
+    v[vs * 2] = 4.0f * (d1 - d2) + (d4 - d3);
+    v[vs * 3] = 2.0f * (d3 - d1) + (d4 - d2);
+    v[vs * 4] = 2.0f * (d1 - d3) + (d4 - d2);
+    v[vs * 5] = 4.0f * d1 - 5.0f * d3 + d5;
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradOutputTransform(
+    const float* m,
+    size_t ms,
+    float* y,
+    size_t ys
+    )
+{
+    const float m0 = m[0];
+    const float m1 = m[ms];
+    const float m2 = m[ms * 2];
+    const float m3 = m[ms * 3];
+    const float m4 = m[ms * 4];
+    const float m5 = m[ms * 5];
+
+    y[0] = m0 + (m1 + m2) + (m3 + m4);
+    y[ys] = (m1 - m2) + 2.0f * (m3 - m4);
+    y[ys * 2] = (m1 + m2) + 4.0f * (m3 + m4);
+    y[ys * 3] = (m1 - m2) + 8.0f * (m3 - m4) + m5;
+}
+
+void
+MlasConvWinogradTransformFilter(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Filter,
+    float* TransformedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the 3x3 filter of a group of a convolution for the
+    Winograd algorithm. The transformed filter is stored as 36 matrices of
+    FilterCount rows by InputChannels columns, one for each element of a
+    transformed tile.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Filter - Supplies the filter tensor of the group.
+
+    TransformedFilter - Supplies the buffer to receive the transformed filter.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t MatrixSize = MlasConvWinogradFilterMatrixSize(Parameters);
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        for (size_t c = 0; c < InputChannels; c++) {
+
+            const float* g = Filter + (f * InputChannels + c) * 9;
+
+            float t[MLAS_CONV_WINOGRAD_TILE_SIZE * 3];
+            float u[MLAS_CONV_WINOGRAD_TILE_ELEMENTS];
+
+            for (size_t i = 0; i < 3; i++) {
+                MlasConvWinogradFilterTransform(g + i, 3, t + i, 3);
+            }
+
+            for (size_t i = 0; i < MLAS_CONV_WINOGRAD_TILE_SIZE; i++) {
+                MlasConvWinogradFilterTransform(t + i * 3, 1, u + i * MLAS_CONV_WINOGRAD_TILE_SIZE, 1);
+            }
+
+            float* d = TransformedFilter + f * InputChannels + c;
+
+            for (size_t i = 0; i < MLAS_CONV_WINOGRAD_TILE_ELEMENTS; i++) {
+                d[i * MatrixSize] = u[i];
+            }
+        }
+    }
+}
+
+void
+MlasConvWinogradOperation(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* TransformedFilter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    size_t StartTile,
+    size_t CountTile
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a block of tiles of the Winograd convolution
+    operation for a group. The input tiles are transformed to the working
+    buffer, multiplied with the transformed filter by 36 GEMMs over the input
+    channels and then transformed to the output tensor.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor of the group.
+
+    TransformedFilter - Supplies the transformed filter of the group.
+
+    Bias - Optionally supplies the bias vector of the group.
+
+    WorkingBuffer - Supplies the working buffer for the transformed input and
+        output tiles of the block.
+
+    Output - Supplies the output tensor of the group.
+
+    StartTile - Supplies the index of the first tile of the block.
+
+    CountTile - Supplies the number of tiles of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+
+    const size_t TileCountW = (OutputWidth + MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE - 1) /
+        MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE;
+
+    const size_t FilterMatrixSize = MlasConvWinogradFilterMatrixSize(Parameters);
+    const size_t InputMatrixSize = InputChannels * TileBlockSize + MLAS_CONV_WINOGRAD_MATRIX_PADDING;
+    const size_t OutputMatrixSize = FilterCount * TileBlockSize + MLAS_CONV_WINOGRAD_MATRIX_PADDING;
+
+    float* TransformedInput = WorkingBuffer;
+    float* TransformedOutput = WorkingBuffer + MLAS_CONV_WINOGRAD_TILE_ELEMENTS * InputMatrixSize;
+
+    //
+    // Transform the input tiles. The tiles are read from the input tensor with
+    // zero padding at the edges. The tiles of a channel are transformed in
+    // turn, so that each transformed matrix is written sequentially.
+    //
+
+    for (size_t c = 0; c < InputChannels; c++) {
+
+        const float* input = Input + c * InputSize;
+
+        for (size_t t = 0; t < CountTile; t++) {
+
+            const size_t TileIndex = StartTile + t;
+            const ptrdiff_t ih = ptrdiff_t((TileIndex / TileCountW) * MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE) -
+                ptrdiff_t(Parameters->Padding[0]);
+            const ptrdiff_t iw = ptrdiff_t((TileIndex % TileCountW) * MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE) -
+                ptrdiff_t(Parameters->Padding[1]);
+
+            const bool TileIsInside = ih >= 0 && iw >= 0 &&
+                size_t(ih) + MLAS_CONV_WINOGRAD_TILE_SIZE <= InputHeight &&
+                size_t(iw) + MLAS_CONV_WINOGRAD_TILE_SIZE <= InputWidth;
+
+            float d[MLAS_CONV_WINOGRAD_TILE_ELEMENTS];
+            float v[MLAS_CONV_WINOGRAD_TILE_ELEMENTS];
+
+            const float* tile;
+            size_t TileStride;
+
+            if (TileIsInside) {
+
+                tile = input + size_t(ih) * InputWidth + size_t(iw);
+                TileStride = InputWidth;
+
+            } else {
+
+                for (size_t i = 0; i < MLAS_CONV_WINOGRAD_TILE_SIZE; i++) {
+
+                    const ptrdiff_t y = ih + ptrdiff_t(i);
+
+                    for (size_t j = 0; j < MLAS_CONV_WINOGRAD_TILE_SIZE; j++) {
+
+                        const ptrdiff_t x = iw + ptrdiff_t(j);
+
+                        d[i * MLAS_CONV_WINOGRAD_TILE_SIZE + j] =
+                            (y >= 0 && size_t(y) < InputHeight && x >= 0 && size_t(x) < InputWidth) ?
+                            input[size_t(y) * InputWidth + size_t(x)] : 0.0f;
+                    }
+                }
+
+                tile = d;
+                TileStride = MLAS_CONV_WINOGRAD_TILE_SIZE;
+            }
+
+            float r[MLAS_CONV_WINOGRAD_TILE_ELEMENTS];
+
+            for (size_t j = 0; j < MLAS_CONV_WINOGRAD_TILE_SIZE; j++) {
+                MlasConvWinogradInputTransform(tile + j, TileStride, r + j, MLAS_CONV_WINOGRAD_TILE_SIZE);
+            }
+
+            for (size_t i = 0; i < MLAS_CONV_WINOGRAD_TILE_SIZE; i++) {
+                MlasConvWinogradInputTransform(r + i * MLAS_CONV_WINOGRAD_TILE_SIZE, 1,
+                    v + i * MLAS_CONV_WINOGRAD_TILE_SIZE, 1);
+            }
+
+            float* transformed = TransformedInput + c * TileBlockSize + t;
+
+            for (size_t i = 0; i < MLAS_CONV_WINOGRAD_TILE_ELEMENTS; i++) {
+                transformed[i * InputMatrixSize] = v[i];
+            }
+        }
+    }
+
+    //
+    // Multiply the transformed filter and input for each element of the
+    // transformed tiles.
+    //
+
+    for (size_t i = 0; i < MLAS_CONV_WINOGRAD_TILE_ELEMENTS; i++) {
+
+        MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountTile, InputChannels, 1.0f,
+            TransformedFilter + i * FilterMatrixSize, InputChannels,
+            TransformedInput + i * InputMatrixSize, TileBlockSize, 0.0f,
+            TransformedOutput + i * OutputMatrixSize, TileBlockSize);
+    }
+
+    //
+    // Transform the output tiles, clipping the tiles at the right and bottom
+    // edges of the output tensor, and apply the bias, the beta multiplier and
+    // the activation.
+    //
+
+    const MLAS_ACTIVATION* Activation = Parameters->Activation;
+    const bool ApplyActivation = Activation->ActivationKind != MlasIdentityActivation;
+    const float Beta = Parameters->Beta;
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        const float bias = (Bias != nullptr) ? Bias[f] : 0.0f;
+        float* output = Output + f * OutputSize;
+
+        for (size_t t = 0; t < CountTile; t++) {
+
+            const size_t TileIndex = StartTile + t;
+            const size_t oh = (TileIndex / TileCountW) * MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE;
+            const size_t ow = (TileIndex % TileCountW) * MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE;
+
+            const float* transformed = TransformedOutput + f * TileBlockSize + t;
+
+            float m[MLAS_CONV_WINOGRAD_TILE_ELEMENTS];
+            float r[MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE * MLAS_CONV_WINOGRAD_TILE_SIZE];
+            float y[MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE * MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE];
+
+            for (size_t i = 0; i < MLAS_CONV_WINOGRAD_TILE_ELEMENTS; i++) {
+                m[i] = transformed[i * OutputMatrixSize];
+            }
+
+            for (size_t j = 0; j < MLAS_CONV_WINOGRAD_TILE_SIZE; j++) {
+                MlasConvWinogradOutputTransform(m + j, MLAS_CONV_WINOGRAD_TILE_SIZE, r + j,
+                    MLAS_CONV_WINOGRAD_TILE_SIZE);
+            }
+
+            for (size_t i = 0; i < MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE; i++) {
+                MlasConvWinogradOutputTransform(r + i * MLAS_CONV_WINOGRAD_TILE_SIZE, 1,
+                    y + i * MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE, 1);
+            }
+
+            const size_t CountH = std::min<size_t>(MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE, OutputHeight - oh);
+            const size_t CountW = std::min<size_t>(MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE, OutputWidth - ow);
+
+            float* o = output + oh * OutputWidth + ow;
+
+            for (size_t i = 0; i < CountH; i++) {
+
+                for (size_t j = 0; j < CountW; j++) {
+
+                    float value = y[i * MLAS_CONV_WINOGRAD_OUTPUT_TILE_SIZE + j] + bias;
+
+                    if (Beta != 0.0f) {
+                        value += Beta * o[i * OutputWidth + j];
+                    }
+
+                    o[i * OutputWidth + j] = value;
+                }
+            }
+
+            if (ApplyActivation) {
+                MlasActivation(Activation, o, nullptr, CountH, CountW, OutputWidth);
+            }
+        }
+    }
+}
+
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of tile
+    blocks of a Winograd convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation, which is
+        also the index of the working buffer of the thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t TileCount = MlasConvWinogradTileCount(Parameters);
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+    const size_t TileBlockCount = (TileCount + TileBlockSize - 1) / TileBlockSize;
+
+    size_t StartBlock;
+    size_t CountBlock;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, TileBlockCount, &StartBlock, &CountBlock);
+
+    float* WorkingBuffer = WorkBlock->WorkingBuffer + size_t(Index) *
+        MlasConvWinogradWorkingBufferSize(Parameters, TileBlockSize);
+
+    for (size_t block = StartBlock; block < StartBlock + CountBlock; block++) {
+
+        const size_t StartTile = block * TileBlockSize;
+        const size_t CountTile = std::min(TileBlockSize, TileCount - StartTile);
+
+        MlasConvWinogradOperation(Parameters, WorkBlock->Input, WorkBlock->Filter, WorkBlock->Bias,
+            WorkingBuffer, WorkBlock->Output, StartTile, CountTile);
+    }
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a group of the convolution operation with the
+    Winograd F(4x4, 3x3) algorithm, partitioned across threads as ranges of
+    blocks of output tiles.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor of the group.
+
+    Filter - Supplies the filter tensor of the group, which is the transformed
+        filter if the filter of the convolution is packed.
+
+    Bias - Optionally supplies the bias vector of the group.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor of the group.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Transform the filter to the start of the working buffer unless the
+    // transformed filter was cached by MlasConvPackFilter.
+    //
+
+    const float* TransformedFilter = Filter;
+
+    if (!Parameters->FilterIsPacked) {
+        MlasConvWinogradTransformFilter(Parameters, Filter, WorkingBuffer);
+        TransformedFilter = WorkingBuffer;
+    }
+
+    WorkingBuffer += MLAS_CONV_WINOGRAD_TILE_ELEMENTS * MlasConvWinogradFilterMatrixSize(Parameters);
+
+    //
+    // Each thread processes a range of tile blocks with its own working
+    // buffer.
+    //
+
+    MLAS_CONV_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = TransformedFilter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+    WorkBlock.TargetThreadCount = ptrdiff_t(Parameters->u.Winograd.WorkingBufferCount);
+
+    if (WorkBlock.TargetThreadCount == 1) {
+        MlasConvWinogradThreaded(&WorkBlock, 0);
+        return;
+    }
+
+    MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock, WorkBlock.TargetThreadCount, ThreadPool);
+}
+
+#if defined(MLAS_TARGET_AMD64)
+
+size_t
+MlasConvDepthwiseWorkingBufferSize(
+    const MLAS_CONV_PARAMETERS* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of working buffer elements required by
+    a thread of a depthwise convolution operation to hold a block of channels
+    of the input, output, filter and bias in the NCHWc format.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+Return Value:
+
+    Returns the number of working buffer elements per thread.
+
+--*/
+{
+    return MlasNchwcGetBlockSize() *
+        (Parameters->InputSize + Parameters->OutputSize + Parameters->K + 1);
+}
+
+void
+MlasConvDepthwiseOperation(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    size_t StartChannel,
+    size_t CountChannel
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a block of channels of a depthwise convolution
+    operation. The channels are reordered to the NCHWc format, convolved
+    with the vectorized NCHWc depthwise kernel and reordered back.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor of the batch.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies the working buffer of the thread.
+
+    Output - Supplies the output tensor of the batch.
+
+    StartChannel - Supplies the first channel of the block.
+
+    CountChannel - Supplies the number of channels of the block, which is no
+        larger than the NCHWc block size.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    float* input = WorkingBuffer;
+    float* output = input + BlockSize * InputSize;
+    float* filter = output + BlockSize * OutputSize;
+    float* bias = filter + BlockSize * K;
+
+    //
+    // Clear the unused channels of a partial block so that the kernel does
+    // not operate on stale values.
+    //
+
+    if (CountChannel < BlockSize) {
+        std::fill_n(input, BlockSize * InputSize, 0.0f);
+        std::fill_n(filter, BlockSize * K, 0.0f);
+    }
+
+    MlasTransposeStrided(reinterpret_cast<const uint32_t*>(Input + StartChannel * InputSize),
+        InputSize, reinterpret_cast<uint32_t*>(input), BlockSize, CountChannel, InputSize);
+
+    MlasTransposeStrided(reinterpret_cast<const uint32_t*>(Filter + StartChannel * K),
+        K, reinterpret_cast<uint32_t*>(filter), BlockSize, CountChannel, K);
+
+    if (Bias != nullptr) {
+        std::copy_n(Bias + StartChannel, CountChannel, bias);
+        std::fill_n(bias + CountChannel, BlockSize - CountChannel, 0.0f);
+    } else {
+        bias = nullptr;
+    }
+
+    //
+    // The kernel overwrites its output, so when accumulating into the output
+    // tensor, the activation is applied after the accumulation instead.
+    //
+
+    const float Beta = Parameters->Beta;
+
+    MLAS_ACTIVATION IdentityActivation;
+    IdentityActivation.ActivationKind = MlasIdentityActivation;
+
+    MlasNchwcConvDepthwiseBlock(Parameters, input, filter, bias, output,
+        (Beta == 0.0f) ? Parameters->Activation : &IdentityActivation);
+
+    float* OutputBlock = Output + StartChannel * OutputSize;
+
+    if (Beta == 0.0f) {
+        MlasTransposeStrided(reinterpret_cast<const uint32_t*>(output), BlockSize,
+            reinterpret_cast<uint32_t*>(OutputBlock), OutputSize, OutputSize, CountChannel);
+        return;
+    }
+
+    for (size_t c = 0; c < CountChannel; c++) {
+
+        float* o = OutputBlock + c * OutputSize;
+
+        for (size_t i = 0; i < OutputSize; i++) {
+            o[i] = output[i * BlockSize + c] + Beta * o[i];
+        }
+    }
+
+    MlasActivation(Parameters->Activation, OutputBlock, nullptr, CountChannel, OutputSize, OutputSize);
+}
+
+void
+MlasConvDepthwiseThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of
+    channel blocks of a depthwise convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation, which is
+        also the index of the working buffer of the thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t ChannelBlockCount = (GroupCount + BlockSize - 1) / BlockSize;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, Parameters->BatchCount * ChannelBlockCount,
+        &WorkIndex, &WorkRemaining);
+
+    float* WorkingBuffer = WorkBlock->WorkingBuffer + size_t(Index) *
+        MlasConvDepthwiseWorkingBufferSize(Parameters);
+
+    for (size_t work = WorkIndex; work < WorkIndex + WorkRemaining; work++) {
+
+        const size_t batch = work / ChannelBlockCount;
+        const size_t StartChannel = (work % ChannelBlockCount) * BlockSize;
+        const size_t CountChannel = std::min(BlockSize, GroupCount - StartChannel);
+
+        MlasConvDepthwiseOperation(Parameters, WorkBlock->Input + batch * GroupCount * Parameters->InputSize,
+            WorkBlock->Filter, WorkBlock->Bias, WorkingBuffer,
+            WorkBlock->Output + batch * GroupCount * Parameters->OutputSize, StartChannel, CountChannel);
+    }
+}
+
+void
+MlasConvDepthwiseDirect(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a depthwise convolution operation, partitioned
+    across threads as ranges of blocks of channels of all batches.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+    WorkBlock.TargetThreadCount = Parameters->ThreadCount;
+
+    if (WorkBlock.TargetThreadCount == 1) {
+        MlasConvDepthwiseThreaded(&WorkBlock, 0);
+        return;
+    }
+
+    MlasExecuteThreaded(MlasConvDepthwiseThreaded, &WorkBlock, WorkBlock.TargetThreadCount, ThreadPool);
+}
+
+#endif
+
+//
+// Define the maximum number of rows of the expanded input tensor gathered by
+// a thread of a NHWC convolution operation before multiplying with the
+// packed filter.
+//
+
+#define MLAS_CONV_NHWC_BLOCK_ROWS 128
+
+size_t
+MlasConvNhwcPackedFilterSize(
+    const MLAS_CONV_PARAMETERS* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of elements of the filter of a group of
+    a NHWC convolution operation packed by MlasGemmPackB.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+Return Value:
+
+    Returns the number of elements of the packed filter of a group.
+
+--*/
+{
+    return MlasGemmPackBSize(Parameters->FilterCount, Parameters->K) / sizeof(float);
+}
+
+void
+MlasConvNhwcPackFilter(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Filter,
+    float* ReorderBuffer,
+    float* PackedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the filter of a group of a NHWC convolution operation
+    as the B matrix of the GEMM. The rows of the expanded input tensor store
+    the input channels of each kernel position contiguously, so the filter
+    elements are first reordered from the kernel position minor order of the
+    filter tensor to the same order.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Filter - Supplies the filter tensor of the group.
+
+    ReorderBuffer - Supplies a buffer of FilterCount * K elements to hold the
+        reordered filter, unused for a pointwise convolution.
+
+    PackedFilter - Supplies the packed filter of the group.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t K = Parameters->K;
+    const size_t KernelSize = K / InputChannels;
+
+    const float* B = Filter;
+
+    if (KernelSize > 1) {
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            const float* filter = Filter + f * K;
+            float* reorder = ReorderBuffer + f * K;
+
+            for (size_t c = 0; c < InputChannels; c++) {
+                for (size_t k = 0; k < KernelSize; k++) {
+                    reorder[k * InputChannels + c] = filter[c * KernelSize + k];
+                }
+            }
+        }
+
+        B = ReorderBuffer;
+    }
+
+    MlasGemmPackB(CblasTrans, FilterCount, K, B, K, PackedFilter);
+}
+
+void
+MlasConvNhwcExpandInput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    float* ColumnBuffer,
+    size_t StartRow,
+    size_t CountRow
+    )
+/*++
+
+Routine Description:
+
+    This routine gathers the convolution patches of a range of output
+    elements of a NHWC convolution operation. Each row of the expanded input
+    tensor holds the input channels of the group for each kernel position,
+    with zeros for the kernel positions in the padding region.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor, offset to the first input channel of
+        the group.
+
+    ColumnBuffer - Supplies the buffer to receive the rows of the expanded
+        input tensor.
+
+    StartRow - Supplies the first output element over all batches.
+
+    CountRow - Supplies the number of output elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t Dimensions = Parameters->Dimensions;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t InputStride = Parameters->GroupCount * InputChannels;
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t KernelSize = Parameters->K / InputChannels;
+
+    for (size_t row = StartRow; row < StartRow + CountRow; row++) {
+
+        const float* input = Input + (row / OutputSize) * InputSize * InputStride;
+
+        //
+        // Compute the coordinates of the first input element of the patch.
+        //
+
+        ptrdiff_t Origin[3];
+        size_t OutputIndex = row % OutputSize;
+
+        for (size_t dim = Dimensions; dim-- > 0;) {
+
+            const size_t OutputShape = Parameters->OutputShape[dim];
+
+            Origin[dim] = ptrdiff_t((OutputIndex % OutputShape) * Parameters->StrideShape[dim]) -
+                ptrdiff_t(Parameters->Padding[dim]);
+            OutputIndex /= OutputShape;
+        }
+
+        //
+        // Copy the input channels of each kernel position, stepping through
+        // the kernel positions in row major order.
+        //
+
+        size_t KernelIndex[3] = {0, 0, 0};
+
+        for (size_t k = 0; k < KernelSize; k++) {
+
+            size_t InputIndex = 0;
+            bool InPadding = false;
+
+            for (size_t dim = 0; dim < Dimensions; dim++) {
+
+                const ptrdiff_t Coordinate = Origin[dim] +
+                    ptrdiff_t(KernelIndex[dim] * Parameters->DilationShape[dim]);
+
+                if (Coordinate < 0 || size_t(Coordinate) >= Parameters->InputShape[dim]) {
+                    InPadding = true;
+                    break;
+                }
+
+                InputIndex = InputIndex * Parameters->InputShape[dim] + size_t(Coordinate);
+            }
+
+            if (InPadding) {
+                std::fill_n(ColumnBuffer, InputChannels, 0.0f);
+            } else {
+                std::copy_n(input + InputIndex * InputStride, InputChannels, ColumnBuffer);
+            }
+
+            ColumnBuffer += InputChannels;
+
+            for (size_t dim = Dimensions; dim-- > 0;) {
+
+                if (++KernelIndex[dim] < Parameters->KernelShape[dim]) {
+                    break;
+                }
+
+                KernelIndex[dim] = 0;
+            }
+        }
+    }
+}
+
+void
+MlasConvNhwcThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a block of a
+    NHWC convolution operation, which is a range of output elements over all
+    batches and a range of filters of every group.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation, which is
+        also the index of the working buffer of the thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t K = Parameters->K;
+    const size_t BlockRows = Parameters->u.NhwcGemm.BlockRows;
+
+    const ptrdiff_t ThreadIdM = Index / WorkBlock->ThreadCountN;
+    const ptrdiff_t ThreadIdN = Index % WorkBlock->ThreadCountN;
+
+    //
+    // Partition the operation along the output elements of all batches.
+    //
+
+    size_t StartM;
+    size_t CountM;
+
+    MlasPartitionWork(ThreadIdM, WorkBlock->ThreadCountM, Parameters->BatchCount * Parameters->OutputSize,
+        &StartM, &CountM);
+
+    //
+    // Partition the operation along the filters.
+    //
+
+    const size_t BlockedN = (FilterCount + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    size_t StartN;
+    size_t CountN;
+
+    MlasPartitionWork(ThreadIdN, WorkBlock->ThreadCountN, BlockedN, &StartN, &CountN);
+
+    StartN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    CountN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    if (StartN >= FilterCount || CountM == 0) {
+        return;
+    }
+
+    CountN = std::min(CountN, FilterCount - StartN);
+
+    float* ColumnBuffer = WorkBlock->WorkingBuffer + size_t(Index) * BlockRows * K;
+
+    const size_t AlignedN = (FilterCount + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) &
+        ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+    const size_t ldc = GroupCount * FilterCount;
+
+    for (size_t group = 0; group < GroupCount; group++) {
+
+        const float* input = WorkBlock->Input + group * InputChannels;
+        const float* filter = WorkBlock->Filter + group * MlasConvNhwcPackedFilterSize(Parameters);
+
+        MLAS_SGEMM_EPILOGUE Epilogue;
+
+        Epilogue.Bias = (WorkBlock->Bias != nullptr) ? WorkBlock->Bias + group * FilterCount + StartN : nullptr;
+        Epilogue.BiasKind = MlasSgemmBiasPerColumn;
+        Epilogue.Activation = Parameters->Activation;
+
+        size_t CountRow;
+
+        for (size_t row = StartM; row < StartM + CountM; row += CountRow) {
+
+            CountRow = std::min(StartM + CountM - row, BlockRows);
+
+            //
+            // The input tensor of a pointwise convolution is already the
+            // expanded input tensor.
+            //
+
+            const float* A = input + row * GroupCount * InputChannels;
+            size_t lda = GroupCount * InputChannels;
+
+            if (Parameters->u.NhwcGemm.ExpandInput) {
+                MlasConvNhwcExpandInput(Parameters, input, ColumnBuffer, row, CountRow);
+                A = ColumnBuffer;
+                lda = K;
+            }
+
+            MlasSgemmPackedOperation(CblasNoTrans, CountRow, StartN, CountN, K, 1.0f, A, lda, filter,
+                AlignedN, Parameters->Beta, WorkBlock->Output + row * ldc + group * FilterCount + StartN,
+                ldc, &Epilogue);
+        }
+    }
+}
+
+void
+MlasConvNhwc(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a NHWC convolution operation as a GEMM of the
+    expanded input tensor with the filter packed by MlasGemmPackB, for all
+    batches and groups, partitioned across threads as a grid of blocks of
+    output elements and filters.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor (NHWC).
+
+    Filter - Supplies the filter tensor, which is packed if the filter of the
+        convolution is packed.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor (NHWC).
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t PackedFilterSize = MlasConvNhwcPackedFilterSize(Parameters);
+
+    //
+    // Pack the filter of each group to the start of the working buffer unless
+    // the filter was packed by MlasConvPackFilter. The SGEMM kernels require
+    // the packed filter to be aligned like a buffer packed by MlasGemmPackB.
+    // The filter is reordered in the space of the expanded input tensor.
+    //
+
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+
+    WorkingBuffer = reinterpret_cast<float*>((uintptr_t(WorkingBuffer) + BufferAlignment - 1) &
+        ~(uintptr_t(BufferAlignment) - 1));
+
+    const float* PackedFilter = Filter;
+
+    if (!Parameters->FilterIsPacked) {
+
+        float* ReorderBuffer = WorkingBuffer + GroupCount * PackedFilterSize;
+        const size_t FilterGroupSize = Parameters->FilterCount * Parameters->K;
+
+        for (size_t group = 0; group < GroupCount; group++) {
+            MlasConvNhwcPackFilter(Parameters, Filter + group * FilterGroupSize, ReorderBuffer,
+                WorkingBuffer + group * PackedFilterSize);
+        }
+
+        PackedFilter = WorkingBuffer;
+    }
+
+    WorkingBuffer += GroupCount * PackedFilterSize;
+
+    MLAS_CONV_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = PackedFilter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+    WorkBlock.ThreadCountM = Parameters->u.NhwcGemm.ThreadCountM;
+    WorkBlock.ThreadCountN = Parameters->u.NhwcGemm.ThreadCountN;
+
+    if (Parameters->ThreadCount == 1) {
+        MlasConvNhwcThreaded(&WorkBlock, 0);
+        return;
+    }
+
+    MlasExecuteThreaded(MlasConvNhwcThreaded, &WorkBlock, Parameters->ThreadCount, ThreadPool);
+}
+
+inline
+bool
+MlasConvTryMultithread(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine attempts to launch a convolution operation across multiple
+    threads.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the operation was completed across multiple threads, else
+    false if the operation should fall back to a single thread.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK WorkBlock;
+
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t ThreadStrideN = Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
+
+    if (ThreadStrideN >= OutputSize) {
+        return false;
+    }
+
+    //
+    // Initialize the common fields of the work block.
+    //
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+    WorkBlock.ThreadStrideN = ThreadStrideN;
+    WorkBlock.WorkingBufferCount = Parameters->u.ExpandThenGemmSegmented.WorkingBufferCount;
+
+    //
+    // Allocate the in use flags for the working buffers if there are more
+    // buffers than can be tracked on the stack.
+    //
+
+    const size_t InUseWordCount = (WorkBlock.WorkingBufferCount + 63) / 64;
+
+    std::atomic<uint64_t> InlineInUse[MLAS_CONV_INLINE_WORKING_BUFFER_COUNT / 64];
+    std::unique_ptr<std::atomic<uint64_t>[]> AllocatedInUse;
+
+    if (InUseWordCount <= MLAS_CONV_INLINE_WORKING_BUFFER_COUNT / 64) {
+        WorkBlock.WorkingBufferInUse = InlineInUse;
+    } else {
+        AllocatedInUse.reset(new std::atomic<uint64_t>[InUseWordCount]);
+        WorkBlock.WorkingBufferInUse = AllocatedInUse.get();
+    }
+
+    for (size_t i = 0; i < InUseWordCount; i++) {
+        WorkBlock.WorkingBufferInUse[i].store(0, std::memory_order_relaxed);
+    }
+
+    //
+    // Segment the operation across multiple threads.
+    //
+
+    const ptrdiff_t SegmentCount = ptrdiff_t((OutputSize + ThreadStrideN - 1) / ThreadStrideN);
+
+    MlasExecuteThreaded(MlasConvOperationThreaded, &WorkBlock, SegmentCount, ThreadPool);
+
+    return true;
+}
+
+void
+MLASCALL
+MlasConv(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution operation.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
 
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
@@ -867,13 +2663,29 @@ Return Value:
 
     const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
     const size_t OutputGroupSize = FilterCount * OutputSize;
-    const size_t FilterGroupSize = FilterCount * K;
-
     const size_t BatchCount = Parameters->BatchCount;
     const size_t GroupCount = Parameters->GroupCount;
 
     const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
 
+    //
+    // The filter of a group transformed for the Winograd algorithm has one
+    // element per filter, input channel and element of a transformed tile.
+    //
+
+    const size_t FilterGroupSize = (Algorithm == MlasConvAlgorithmWinograd && Parameters->FilterIsPacked) ?
+        MLAS_CONV_WINOGRAD_TILE_ELEMENTS * MlasConvWinogradFilterMatrixSize(Parameters) : FilterCount * K;
+
+    //
+    // The NHWC tensors interleave the channels of all groups, so all batches
+    // and groups are convolved together.
+    //
+
+    if (Algorithm == MlasConvAlgorithmNhwcGemm) {
+        MlasConvNhwc(Parameters, Input, Filter, Bias, WorkingBuffer, Output, ThreadPool);
+        return;
+    }
+
     //
     // Schedule batches of GEMMs across multiple threads.
     //
@@ -882,7 +2694,8 @@ Return Value:
 
         const size_t BatchGroupCount = BatchCount * GroupCount;
 
-        ptrdiff_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+        ptrdiff_t TargetThreadCount =
+            MlasGetMaximumThreadCount(ThreadPool) * MLAS_THREADED_WORK_ITEMS_PER_THREAD;
 
         if (size_t(TargetThreadCount) >= BatchGroupCount) {
             TargetThreadCount = ptrdiff_t(BatchGroupCount);
@@ -903,6 +2716,19 @@ Return Value:
         return;
     }
 
+#if defined(MLAS_TARGET_AMD64)
+
+    //
+    // Schedule blocks of channels of all batches across multiple threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmDepthwise) {
+        MlasConvDepthwiseDirect(Parameters, Input, Filter, Bias, WorkingBuffer, Output, ThreadPool);
+        return;
+    }
+
+#endif
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
     if (Algorithm == MlasConvAlgorithmDepthwise) {
@@ -932,19 +2758,15 @@ Return Value:
                 case MlasConvAlgorithmGemmDirect:
                 {
                     //
-                    // Invoke the threaded GEMM directly with the input tensor.
+                    // Invoke the threaded GEMM directly with the input tensor and
+                    // apply the activation with optional bias.
                     //
 
-                    MlasGemm(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount, OutputSize,
-                             K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb,
-                             Parameters->Beta, Output, OutputSize, ThreadPool);
-
-                    //
-                    // Apply the activation with optional bias.
-                    //
+                    const MLAS_SGEMM_EPILOGUE Epilogue = MlasConvEpilogue(Parameters, bias);
 
-                    MlasActivation(Parameters->Activation, Output, bias, FilterCount,
-                        OutputSize, OutputSize);
+                    MlasConvGemm(Parameters, Parameters->u.GemmDirect.TransB, FilterCount, OutputSize, K,
+                                 filter, Input, Parameters->u.GemmDirect.ldb, Parameters->Beta,
+                                 Output, &Epilogue, ThreadPool);
 
                     break;
                 }
@@ -962,16 +2784,34 @@ Return Value:
                         MlasConvVol2Col(Parameters, Input, WorkingBuffer, 0, K, 0, OutputSize);
                     }
 
-                    MlasGemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f, filter,
-                             K, WorkingBuffer, OutputSize, Parameters->Beta, Output, OutputSize,
-                             ThreadPool);
+                    const MLAS_SGEMM_EPILOGUE Epilogue = MlasConvEpilogue(Parameters, bias);
+
+                    MlasConvGemm(Parameters, CblasNoTrans, FilterCount, OutputSize, K, filter, WorkingBuffer,
+                                 OutputSize, Parameters->Beta, Output, &Epilogue, ThreadPool);
+
+                    break;
+                }
+
+                case MlasConvAlgorithmImplicitGemm:
+                {
+                    //
+                    // Gather the convolution patches directly into the packed
+                    // buffers of the GEMM.
+                    //
+
+                    MlasConvImplicitGemm(Parameters, Input, filter, bias, Output, ThreadPool);
+
+                    break;
+                }
 
+                case MlasConvAlgorithmWinograd:
+                {
                     //
-                    // Apply the activation with optional bias.
+                    // Transform the input tiles, multiply them with the
+                    // transformed filter and transform the output tiles.
                     //
 
-                    MlasActivation(Parameters->Activation, Output, bias, FilterCount,
-                        OutputSize, OutputSize);
+                    MlasConvWinograd(Parameters, Input, filter, bias, WorkingBuffer, Output, ThreadPool);
 
                     break;
                 }
@@ -985,8 +2825,21 @@ Return Value:
                     break;
                 }
 
+#elif defined(MLAS_TARGET_AMD64)
+
+                case MlasConvAlgorithmDepthwise:
+
 #endif
 
+                case MlasConvAlgorithmNhwcGemm:
+                {
+                    //
+                    // Dispatched above across all batches and groups.
+                    //
+
+                    break;
+                }
+
                 case MlasConvAlgorithmExpandThenGemmSegmented:
                 {
                     //
@@ -1018,6 +2871,65 @@ Return Value:
         }
     }
 }
+
+#if defined(BUILD_MLAS_NO_ONNXRUNTIME)
+
+MLAS_TASK*
+MLASCALL
+MlasConvAsync(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool,
+    MLAS_TASK* Predecessor
+    )
+/*++
+
+Routine Description:
+
+    This routine starts the convolution operation on the dispatcher thread of
+    the thread pool and returns without waiting for the operation.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters. The structure is copied.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr to
+        select the default thread pool.
+
+    Predecessor - Optionally supplies an operation that must complete before
+        this operation starts.
+
+Return Value:
+
+    Returns the handle of the operation, to be released by MlasReleaseTask.
+
+--*/
+{
+    const MLAS_CONV_PARAMETERS ParametersCopy = *Parameters;
+
+    return MlasScheduleTask(ThreadPool, Predecessor, [=]() {
+        MlasConv(&ParametersCopy, Input, Filter, Bias, WorkingBuffer, Output, ThreadPool);
+    });
+}
+
+#endif
+
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(push)
 // Chance of arithmetic overflow could be reduced
@@ -1041,7 +2953,8 @@ MlasConvPrepare(
     const MLAS_ACTIVATION* Activation,
     size_t* WorkingBufferSize,
     float Beta,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    bool ChannelsLast
     )
 /*++
 
@@ -1088,6 +3001,10 @@ Arguments:
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
+    ChannelsLast - Supplies true if the input and output tensors are in the
+        NHWC format, else false if they are in the NCHW format. The filter
+        tensor is in the same format for either.
+
 Return Value:
 
     None.
@@ -1104,6 +3021,8 @@ Return Value:
     Parameters->InputChannels = InputChannels;
     Parameters->FilterCount = FilterCount;
     Parameters->Beta = Beta;
+    Parameters->FilterIsPacked = false;
+    Parameters->ChannelsLast = ChannelsLast;
 
     size_t InputSize = 1;
     size_t OutputSize = 1;
@@ -1168,6 +3087,57 @@ Return Value:
 
     *WorkingBufferSize = 0;
 
+    if (ChannelsLast) {
+
+        //
+        // Multiply the expanded input tensor with the filter packed as the B
+        // matrix of a GEMM, with a row per output element of all batches. The
+        // input tensor of a pointwise convolution is used directly.
+        //
+        // Compute the number of target threads given the complexity of the
+        // convolution operation.
+        //
+
+        const size_t M = BatchCount * OutputSize;
+        const double Complexity = double(GroupCount) * double(M) * double(FilterCount) * double(K);
+
+        ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+        TargetThreadCount = std::min(TargetThreadCount, MlasGetMaximumThreadCount(ThreadPool));
+
+        ptrdiff_t ThreadCountM;
+        ptrdiff_t ThreadCountN;
+
+        MlasSgemmPartitionThreads(M, FilterCount, K, TargetThreadCount, &ThreadCountM, &ThreadCountN);
+
+        const size_t BlockRows = std::min(size_t(MLAS_CONV_NHWC_BLOCK_ROWS), (M + ThreadCountM - 1) / ThreadCountM);
+        const bool ExpandInput = !(K == InputChannels && AllStridesAreOne && AllPaddingIsZero);
+
+        Parameters->ThreadCount = ThreadCountM * ThreadCountN;
+
+        Parameters->Algorithm = MlasConvAlgorithmNhwcGemm;
+        Parameters->u.NhwcGemm.BlockRows = BlockRows;
+        Parameters->u.NhwcGemm.ThreadCountM = ThreadCountM;
+        Parameters->u.NhwcGemm.ThreadCountN = ThreadCountN;
+        Parameters->u.NhwcGemm.ExpandInput = ExpandInput;
+
+        //
+        // The working buffer holds the aligned packed filter, unless the
+        // filter is packed, followed by the expanded input tensor of each
+        // thread. The filter is reordered in the space of the expanded input
+        // tensor before it is packed.
+        //
+
+        *WorkingBufferSize = GroupCount * MlasConvNhwcPackedFilterSize(Parameters) +
+            MlasGetPreferredBufferAlignment() / sizeof(float);
+
+        if (ExpandInput) {
+            *WorkingBufferSize += std::max(size_t(Parameters->ThreadCount) * BlockRows * K, FilterCount * K);
+        }
+
+        return;
+    }
+
     if (AllStridesAreOne && AllPaddingIsZero) {
 
         //
@@ -1211,16 +3181,81 @@ Return Value:
         }
     }
 
-    if (FilterCount > OutputSize) {
+    if (Dimensions == 2 && AllStridesAreOne && AllDilationsAreOne &&
+        Parameters->KernelShape[0] == 3 && Parameters->KernelShape[1] == 3 &&
+        InputChannels >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS &&
+        FilterCount >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS && FilterCount <= OutputSize) {
+
+        //
+        // Use the Winograd F(4x4, 3x3) algorithm, which reduces the number of
+        // multiplies of a 3x3 convolution by a factor of four. The transforms
+        // are amortized over the channels, so the algorithm is only used if
+        // there are enough input channels and filters.
+        //
+        // Compute the number of target threads given the complexity of the
+        // convolution operation.
+        //
+
+        const double Complexity = double(FilterCount) * double(OutputSize) * double(K);
+
+        const ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+        if (TargetThreadCount > MaximumThreadCount) {
+            TargetThreadCount = MaximumThreadCount;
+        }
+
+        //
+        // Size the blocks of tiles so the transformed input and output tiles
+        // of a block fit the working buffer of a thread, in multiples of the
+        // SGEMM column stride, and so each thread processes at least one
+        // block.
+        //
+
+        const size_t TileCount = MlasConvWinogradTileCount(Parameters);
+        const size_t TileElements = MLAS_CONV_WINOGRAD_TILE_ELEMENTS * (InputChannels + FilterCount);
+
+        size_t TileBlockSize = MLAS_CONV_WINOGRAD_BLOCK_ELEMENTS / TileElements;
+        TileBlockSize = std::max<size_t>(TileBlockSize / MLAS_SGEMM_STRIDEN_THREAD_ALIGN, 1) *
+            MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+        size_t TilesPerThread = (TileCount + TargetThreadCount - 1) / TargetThreadCount;
+        TilesPerThread = (TilesPerThread + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) &
+            ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+        TileBlockSize = std::min(TileBlockSize, std::min(TilesPerThread, TileCount));
+
+        const size_t TileBlockCount = (TileCount + TileBlockSize - 1) / TileBlockSize;
+
+        if (size_t(TargetThreadCount) > TileBlockCount) {
+            TargetThreadCount = ptrdiff_t(TileBlockCount);
+        }
+
+        Parameters->ThreadCount = TargetThreadCount;
+
+        Parameters->Algorithm = MlasConvAlgorithmWinograd;
+        Parameters->u.Winograd.TileBlockSize = TileBlockSize;
+        Parameters->u.Winograd.WorkingBufferCount = size_t(TargetThreadCount);
 
         //
-        // The filter count is larger than the output dimensions, so perform the
-        // full matrix expansion and then invoke the threaded GEMM.
+        // The working buffer holds the transformed filter, unless the filter
+        // is packed, followed by the transformed tiles of each thread.
         //
 
-        Parameters->Algorithm = MlasConvAlgorithmExpandThenGemm;
+        *WorkingBufferSize = MLAS_CONV_WINOGRAD_TILE_ELEMENTS * MlasConvWinogradFilterMatrixSize(Parameters) +
+            size_t(TargetThreadCount) * MlasConvWinogradWorkingBufferSize(Parameters, TileBlockSize);
+
+    } else if (FilterCount > OutputSize) {
+
+        //
+        // The filter count is larger than the output dimensions, so partition
+        // the GEMM across the filters as well as the output elements. The
+        // convolution patches are gathered directly into the packed buffers
+        // of the GEMM instead of being expanded to a working buffer.
+        //
 
-        *WorkingBufferSize = OutputSize * K;
+        Parameters->Algorithm = MlasConvAlgorithmImplicitGemm;
 
     } else {
 
@@ -1242,6 +3277,36 @@ Return Value:
             return;
         }
 
+#elif defined(MLAS_TARGET_AMD64)
+
+        //
+        // Direct depthwise convolution with the vectorized NCHWc kernel for
+        // any kernel, stride, dilation and padding. Each thread reorders a
+        // block of channels at a time to its own working buffer.
+        //
+
+        const size_t BlockSize = MlasNchwcGetBlockSize();
+
+        if (Dimensions == 2 && BlockSize > 1 && GroupCount > 1 &&
+            FilterCount == 1 && InputChannels == 1) {
+
+            const size_t WorkCount = BatchCount * ((GroupCount + BlockSize - 1) / BlockSize);
+
+            const double Complexity = double(BatchCount) * double(GroupCount) *
+                double(OutputSize) * double(K);
+
+            ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+            TargetThreadCount = std::min(TargetThreadCount, MlasGetMaximumThreadCount(ThreadPool));
+            TargetThreadCount = std::min(TargetThreadCount, ptrdiff_t(WorkCount));
+
+            Parameters->ThreadCount = TargetThreadCount;
+            Parameters->Algorithm = MlasConvAlgorithmDepthwise;
+
+            *WorkingBufferSize = size_t(TargetThreadCount) * MlasConvDepthwiseWorkingBufferSize(Parameters);
+            return;
+        }
+
 #endif
 
         //
@@ -1256,18 +3321,37 @@ Return Value:
         ptrdiff_t TargetThreadCount;
         double Complexity = double(FilterCount) * double(OutputSize) * double(K);
 
-        if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MaximumThreadCount)) {
             TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
         } else {
-            TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+            TargetThreadCount = MaximumThreadCount;
         }
 
-        ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
-
         if (TargetThreadCount >= MaximumThreadCount) {
             TargetThreadCount = MaximumThreadCount;
         }
 
+        //
+        // Each thread needs its own working buffer.
+        //
+
+        size_t WorkingBufferCount = size_t(TargetThreadCount);
+
+        //
+        // Generate multiple segments per thread if the operation is large
+        // enough, so that the thread pool can rebalance the work when some
+        // threads run slower than others. Segments share the working buffers
+        // of the threads.
+        //
+
+        if (TargetThreadCount > 1) {
+
+            TargetThreadCount = std::min(TargetThreadCount * MLAS_THREADED_WORK_ITEMS_PER_THREAD,
+                ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1);
+        }
+
         //
         // Compute the thread stride for slicing the N dimension.
         //
@@ -1284,19 +3368,148 @@ Return Value:
 
             if (StrideN >= OutputSize) {
                 TargetThreadCount = 1;
-            } else if (StrideN * (TargetThreadCount - 1) >= OutputSize) {
-                TargetThreadCount--;
+            } else {
+                TargetThreadCount = ptrdiff_t((OutputSize + StrideN - 1) / StrideN);
             }
         }
 
+        if (WorkingBufferCount > size_t(TargetThreadCount)) {
+            WorkingBufferCount = size_t(TargetThreadCount);
+        }
+
         Parameters->ThreadCount = TargetThreadCount;
 
         Parameters->Algorithm = MlasConvAlgorithmExpandThenGemmSegmented;
         Parameters->u.ExpandThenGemmSegmented.ThreadStrideN = StrideN;
+        Parameters->u.ExpandThenGemmSegmented.WorkingBufferCount = WorkingBufferCount;
 
-        *WorkingBufferSize = TargetThreadCount * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
+        *WorkingBufferSize = WorkingBufferCount * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
     }
 }
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(pop)
-#endif
\ No newline at end of file
+#endif
+
+size_t
+MLASCALL
+MlasConvPackFilterSize(
+    const MLAS_CONV_PARAMETERS* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the packed filter buffer.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+Return Value:
+
+    Returns the size in bytes for the packed filter buffer.
+
+--*/
+{
+    if (Parameters->Algorithm == MlasConvAlgorithmWinograd) {
+        return Parameters->GroupCount * MLAS_CONV_WINOGRAD_TILE_ELEMENTS *
+            MlasConvWinogradFilterMatrixSize(Parameters) * sizeof(float);
+    }
+
+    if (Parameters->Algorithm == MlasConvAlgorithmNhwcGemm) {
+        return Parameters->GroupCount * MlasConvNhwcPackedFilterSize(Parameters) * sizeof(float);
+    }
+
+    return MlasGemmPackASize(Parameters->GroupCount * Parameters->FilterCount, Parameters->K);
+}
+
+void
+MLASCALL
+MlasConvPackFilter(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Filter,
+    void* PackedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the filter tensor of a convolution. The filter of each
+    group is the left operand of the GEMM of the group and is packed with
+    MlasGemmPackA, so the packed filter of each group occupies the same
+    number of elements as the unpacked filter. For the Winograd algorithm,
+    the filter of each group is transformed instead, and for a NHWC
+    convolution, it is packed with MlasGemmPackB as the B matrix.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Filter - Supplies the filter tensor.
+
+    PackedFilter - Supplies the address of the packed filter buffer, sized by
+        MlasConvPackFilterSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterGroupSize = Parameters->FilterCount * Parameters->K;
+
+    //
+    // The filter of a NHWC convolution is the B matrix of the GEMM and is
+    // packed with MlasGemmPackB after reordering it to the layout of the
+    // expanded input tensor.
+    //
+
+    if (Parameters->Algorithm == MlasConvAlgorithmNhwcGemm) {
+
+        const size_t PackedFilterSize = MlasConvNhwcPackedFilterSize(Parameters);
+
+        std::vector<float> ReorderBuffer(FilterGroupSize);
+
+        for (size_t group = 0; group < Parameters->GroupCount; group++) {
+            MlasConvNhwcPackFilter(Parameters, Filter + group * FilterGroupSize, ReorderBuffer.data(),
+                static_cast<float*>(PackedFilter) + group * PackedFilterSize);
+        }
+
+        return;
+    }
+
+    //
+    // The depthwise algorithm reads the filter of each channel directly.
+    //
+
+    if (Parameters->Algorithm == MlasConvAlgorithmDepthwise) {
+        std::copy_n(Filter, Parameters->GroupCount * FilterGroupSize, static_cast<float*>(PackedFilter));
+        return;
+    }
+
+    //
+    // Cache the filter transformed for the Winograd algorithm, so that it is
+    // not transformed on every inference.
+    //
+
+    if (Parameters->Algorithm == MlasConvAlgorithmWinograd) {
+
+        const size_t TransformedGroupSize =
+            MLAS_CONV_WINOGRAD_TILE_ELEMENTS * MlasConvWinogradFilterMatrixSize(Parameters);
+
+        for (size_t group = 0; group < Parameters->GroupCount; group++) {
+            MlasConvWinogradTransformFilter(Parameters, Filter + group * FilterGroupSize,
+                static_cast<float*>(PackedFilter) + group * TransformedGroupSize);
+        }
+
+        return;
+    }
+
+    for (size_t group = 0; group < Parameters->GroupCount; group++) {
+        MlasGemmPackA(CblasNoTrans, Parameters->FilterCount, Parameters->K,
+            Filter + group * FilterGroupSize, Parameters->K,
+            static_cast<float*>(PackedFilter) + group * FilterGroupSize);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,283 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convstream.cpp
+
+Abstract:
+
+    This module implements the streaming causal convolution operation.
+
+    The first spatial dimension of the convolution is time. Each call supplies
+    the next frames of the input tensor and produces the same number of output
+    frames. The state of a stream is the window of input frames convolved by
+    a call: the last (kernel - 1) * dilation input frames of the previous
+    calls, which replace the zero padding at the start of the time dimension,
+    followed by the new frames. Only the output frames of the new input frames
+    are computed.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasConvStreamPrepare(
+    MLAS_CONV_STREAM_PARAMETERS* Parameters,
+    size_t Dimensions,
+    size_t GroupCount,
+    size_t InputChannels,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    size_t FilterCount,
+    const MLAS_ACTIVATION* Activation,
+    size_t* StateSize,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool,
+    bool ChannelsLast
+    )
+/*++
+
+Routine Description:
+
+    This routine prepares for a streaming causal convolution operation by
+    preparing the convolution of the window of input frames of a call and
+    computing the required state and working buffer sizes.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the computed parameters
+        for the streaming convolution operation.
+
+    Dimensions - Supplies the number of dimensions (must be between 1 and 3),
+        where the first dimension is time.
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    InputShape - Supplies the shape of the input tensor of a call, where the
+        first dimension is the number of frames of a call.
+
+    KernelShape - Supplies the shape of the kernel transform.
+
+    DilationShape - Supplies the shape of the dilation.
+
+    Padding - Supplies the number of zero padding elements at the edge of the
+        input tensor. The padding along the time dimension is ignored.
+
+    StrideShape - Supplies the shape of the stride. The stride along the time
+        dimension is ignored and is one.
+
+    FilterCount - Supplies the number of rows of the filter matrix per group.
+
+    Activation - Supplies the parameters for the activation to apply to the
+        convolution output.
+
+    StateSize - Receives the number of elements to allocate for the state of
+        a stream.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer for intermediate results.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+    ChannelsLast - Supplies true if the input and output tensors are in the
+        NHWC format, else false if they are in the NCHW format.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t HistoryFrames = size_t(KernelShape[0] - 1) * size_t(DilationShape[0]);
+    const size_t FrameCount = size_t(InputShape[0]);
+
+    //
+    // The window of a call is the history followed by the new frames, which
+    // is convolved without padding along the time dimension to produce an
+    // output frame per new frame.
+    //
+
+    int64_t WindowShape[3];
+    int64_t WindowPadding[6];
+    int64_t WindowStrideShape[3];
+    int64_t OutputShape[3];
+
+    size_t InputFrameSize = 1;
+    size_t OutputFrameSize = 1;
+
+    for (size_t dim = 0; dim < Dimensions; dim++) {
+
+        WindowShape[dim] = InputShape[dim];
+        WindowPadding[dim] = Padding[dim];
+        WindowPadding[dim + Dimensions] = Padding[dim + Dimensions];
+        WindowStrideShape[dim] = StrideShape[dim];
+
+        if (dim == 0) {
+
+            WindowShape[dim] = int64_t(HistoryFrames + FrameCount);
+            WindowPadding[dim] = 0;
+            WindowPadding[dim + Dimensions] = 0;
+            WindowStrideShape[dim] = 1;
+            OutputShape[dim] = int64_t(FrameCount);
+
+        } else {
+
+            const int64_t DilatedKernel = (KernelShape[dim] - 1) * DilationShape[dim] + 1;
+
+            OutputShape[dim] = (InputShape[dim] + Padding[dim] + Padding[dim + Dimensions] -
+                DilatedKernel) / StrideShape[dim] + 1;
+
+            InputFrameSize *= size_t(InputShape[dim]);
+            OutputFrameSize *= size_t(OutputShape[dim]);
+        }
+    }
+
+    MlasConvPrepare(&Parameters->Conv, Dimensions, 1, GroupCount, InputChannels, WindowShape,
+        KernelShape, DilationShape, WindowPadding, WindowStrideShape, OutputShape, FilterCount,
+        Activation, WorkingBufferSize, 0.0f, ThreadPool, ChannelsLast);
+
+    Parameters->HistoryFrames = HistoryFrames;
+    Parameters->FrameCount = FrameCount;
+    Parameters->InputFrameSize = InputFrameSize;
+    Parameters->OutputFrameSize = OutputFrameSize;
+
+    *StateSize = GroupCount * InputChannels * (HistoryFrames + FrameCount) * InputFrameSize;
+}
+
+void
+MLASCALL
+MlasConvStreamReset(
+    const MLAS_CONV_STREAM_PARAMETERS* Parameters,
+    float* State
+    )
+/*++
+
+Routine Description:
+
+    This routine resets the state of a stream to the start of the time
+    dimension, where the history is zero padding.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the streaming
+        convolution parameters.
+
+    State - Supplies the state of the stream.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_CONV_PARAMETERS* Conv = &Parameters->Conv;
+
+    const size_t ChannelCount = Conv->GroupCount * Conv->InputChannels;
+
+    std::fill_n(State, ChannelCount * (Parameters->HistoryFrames + Parameters->FrameCount) *
+        Parameters->InputFrameSize, 0.0f);
+}
+
+void
+MLASCALL
+MlasConvStream(
+    const MLAS_CONV_STREAM_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* State,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the streaming causal convolution operation for
+    the next frames of a stream.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the streaming
+        convolution parameters.
+
+    Input - Supplies the new frames of the input tensor.
+
+    Filter - Supplies the filter tensor, which is packed if the filter of the
+        convolution is packed.
+
+    Bias - Optionally supplies the bias vector.
+
+    State - Supplies the state of the stream, which is updated with the new
+        frames.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvStreamPrepare.
+
+    Output - Supplies the output tensor of the new frames.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_CONV_PARAMETERS* Conv = &Parameters->Conv;
+
+    const size_t ChannelCount = Conv->GroupCount * Conv->InputChannels;
+    const size_t HistoryFrames = Parameters->HistoryFrames;
+    const size_t FrameCount = Parameters->FrameCount;
+    const size_t WindowFrames = HistoryFrames + FrameCount;
+
+    //
+    // Append the new frames to the history. A NHWC window stores the frames
+    // of all channels contiguously, while a NCHW window stores the frames of
+    // each channel contiguously.
+    //
+
+    size_t FrameSize = Parameters->InputFrameSize;
+    size_t WindowCount = ChannelCount;
+
+    if (Conv->ChannelsLast) {
+        FrameSize *= ChannelCount;
+        WindowCount = 1;
+    }
+
+    for (size_t window = 0; window < WindowCount; window++) {
+        std::copy_n(Input + window * FrameCount * FrameSize, FrameCount * FrameSize,
+            State + (window * WindowFrames + HistoryFrames) * FrameSize);
+    }
+
+    MlasConv(Conv, State, Filter, Bias, WorkingBuffer, Output, ThreadPool);
+
+    //
+    // Keep the last frames of the window as the history of the next call.
+    // Shifting the few history frames keeps the window contiguous for the
+    // convolution, which could not address a ring buffer that wraps around.
+    //
+
+    if (HistoryFrames > 0) {
+
+        for (size_t window = 0; window < WindowCount; window++) {
+
+            float* state = State + window * WindowFrames * FrameSize;
+
+            std::copy(state + FrameCount * FrameSize, state + WindowFrames * FrameSize, state);
+        }
+    }
+}
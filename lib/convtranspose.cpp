@@ -0,0 +1,522 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convtranspose.cpp
+
+Abstract:
+
+    This module implements the transposed convolution operation.
+
+    The transposed filter of each group is multiplied with the input tensor
+    to produce a column matrix with a row per output channel and kernel
+    position and a column per input element, which is then scattered and
+    accumulated to the output tensor (col2im).
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute segments of a transposed convolution
+// operation on worker threads.
+//
+
+struct MLAS_CONV_TRANSPOSE_WORK_BLOCK {
+    const MLAS_CONV_TRANSPOSE_PARAMETERS* Parameters;
+    const float* ColumnBuffer;
+    const float* Bias;
+    float* Output;
+    ptrdiff_t TargetThreadCount;
+};
+
+void
+MlasConvTransposeAddRow(
+    const float* Column,
+    float* Output,
+    size_t InputWidth,
+    size_t OutputWidth,
+    size_t Stride,
+    ptrdiff_t Offset
+    )
+/*++
+
+Routine Description:
+
+    This routine accumulates a row of the column matrix to a row of the output
+    tensor, where input element x maps to output element x * Stride + Offset.
+    Input elements that map outside the output row are in the padding region
+    and are skipped.
+
+Arguments:
+
+    Column - Supplies the row of the column matrix.
+
+    Output - Supplies the row of the output tensor.
+
+    InputWidth - Supplies the number of elements of the row of the column
+        matrix.
+
+    OutputWidth - Supplies the number of elements of the row of the output
+        tensor.
+
+    Stride - Supplies the stride of the innermost dimension.
+
+    Offset - Supplies the output element of the first input element.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Compute the range of input elements that map inside the output row.
+    //
+
+    size_t StartX = 0;
+
+    if (Offset < 0) {
+        StartX = (size_t(-Offset) + Stride - 1) / Stride;
+    }
+
+    if (ptrdiff_t(OutputWidth) <= Offset) {
+        return;
+    }
+
+    const size_t EndX = std::min(InputWidth, (size_t(ptrdiff_t(OutputWidth) - 1 - Offset)) / Stride + 1);
+
+    if (StartX >= EndX) {
+        return;
+    }
+
+    const float* column = Column + StartX;
+    float* output = Output + ptrdiff_t(StartX * Stride) + Offset;
+    size_t CountX = EndX - StartX;
+
+    if (Stride == 1) {
+
+        while (CountX >= 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasAddFloat32x4(MlasLoadFloat32x4(output), MlasLoadFloat32x4(column));
+            MlasStoreFloat32x4(output, Vector);
+
+            column += 4;
+            output += 4;
+            CountX -= 4;
+        }
+
+        while (CountX > 0) {
+            *output++ += *column++;
+            CountX--;
+        }
+
+    } else {
+
+        while (CountX > 0) {
+            *output += *column++;
+            output += Stride;
+            CountX--;
+        }
+    }
+}
+
+void
+MlasConvTransposeCol2Im(
+    const MLAS_CONV_TRANSPOSE_PARAMETERS* Parameters,
+    const float* ColumnBuffer,
+    const float* Bias,
+    float* Output,
+    size_t StartRow,
+    size_t CountRow
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a range of rows of the output tensor of a group of
+    a transposed convolution operation from the column matrix. A row is the
+    innermost dimension of an output channel, so that each row is accumulated
+    by a single thread. The row is initialized with the bias, accumulated with
+    the elements of the column matrix that map to it, and then activated.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the transposed
+        convolution parameters.
+
+    ColumnBuffer - Supplies the column matrix of the group.
+
+    Bias - Optionally supplies the bias vector of the group.
+
+    Output - Supplies the output tensor of the group.
+
+    StartRow - Supplies the first row over all output channels of the group.
+
+    CountRow - Supplies the number of rows.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t Dimensions = Parameters->Dimensions;
+    const size_t InnerDim = Dimensions - 1;
+
+    const size_t InputSize = Parameters->InputSize;
+    const size_t InputWidth = Parameters->InputShape[InnerDim];
+    const size_t OutputWidth = Parameters->OutputShape[InnerDim];
+    const size_t OutputRows = Parameters->OutputSize / OutputWidth;
+    const size_t KernelSize = Parameters->KernelSize;
+    const size_t KernelWidth = Parameters->KernelShape[InnerDim];
+
+    for (size_t row = StartRow; row < StartRow + CountRow; row++) {
+
+        const size_t channel = row / OutputRows;
+        const size_t OutputRow = row % OutputRows;
+
+        float* output = Output + row * OutputWidth;
+
+        std::fill_n(output, OutputWidth, (Bias != nullptr) ? Bias[channel] : 0.0f);
+
+        //
+        // Compute the coordinates of the output row along the outer
+        // dimensions.
+        //
+
+        size_t OutputCoordinate[3];
+        size_t index = OutputRow;
+
+        for (size_t dim = InnerDim; dim-- > 0;) {
+            OutputCoordinate[dim] = index % Parameters->OutputShape[dim];
+            index /= Parameters->OutputShape[dim];
+        }
+
+        //
+        // Step through the kernel positions along the outer dimensions in row
+        // major order, and for each that maps an input row to the output row,
+        // accumulate the rows of the column matrix of the kernel positions
+        // along the innermost dimension.
+        //
+
+        const size_t KernelRows = KernelSize / KernelWidth;
+        size_t KernelIndex[3] = {0, 0, 0};
+
+        for (size_t KernelRow = 0; KernelRow < KernelRows; KernelRow++) {
+
+            size_t InputRow = 0;
+            bool Skip = false;
+
+            for (size_t dim = 0; dim < InnerDim; dim++) {
+
+                const ptrdiff_t Numerator = ptrdiff_t(OutputCoordinate[dim] + Parameters->Padding[dim]) -
+                    ptrdiff_t(KernelIndex[dim] * Parameters->DilationShape[dim]);
+                const ptrdiff_t Stride = ptrdiff_t(Parameters->StrideShape[dim]);
+
+                if (Numerator < 0 || Numerator % Stride != 0 ||
+                    size_t(Numerator / Stride) >= Parameters->InputShape[dim]) {
+                    Skip = true;
+                    break;
+                }
+
+                InputRow = InputRow * Parameters->InputShape[dim] + size_t(Numerator / Stride);
+            }
+
+            if (!Skip) {
+
+                const float* column = ColumnBuffer +
+                    (channel * KernelSize + KernelRow * KernelWidth) * InputSize + InputRow * InputWidth;
+
+                for (size_t kx = 0; kx < KernelWidth; kx++) {
+
+                    const ptrdiff_t Offset = ptrdiff_t(kx * Parameters->DilationShape[InnerDim]) -
+                        ptrdiff_t(Parameters->Padding[InnerDim]);
+
+                    MlasConvTransposeAddRow(column, output, InputWidth, OutputWidth,
+                        Parameters->StrideShape[InnerDim], Offset);
+
+                    column += InputSize;
+                }
+            }
+
+            for (size_t dim = InnerDim; dim-- > 0;) {
+
+                if (++KernelIndex[dim] < Parameters->KernelShape[dim]) {
+                    break;
+                }
+
+                KernelIndex[dim] = 0;
+            }
+        }
+
+        MlasActivation(Parameters->Activation, output, nullptr, 1, OutputWidth, OutputWidth);
+    }
+}
+
+void
+MlasConvTransposeCol2ImThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of rows
+    of the col2im step of a transposed convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_TRANSPOSE_WORK_BLOCK* WorkBlock = (MLAS_CONV_TRANSPOSE_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_TRANSPOSE_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t TotalRows = Parameters->FilterCount *
+        (Parameters->OutputSize / Parameters->OutputShape[Parameters->Dimensions - 1]);
+
+    size_t StartRow;
+    size_t CountRow;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, TotalRows, &StartRow, &CountRow);
+
+    MlasConvTransposeCol2Im(Parameters, WorkBlock->ColumnBuffer, WorkBlock->Bias, WorkBlock->Output,
+        StartRow, CountRow);
+}
+
+void
+MLASCALL
+MlasConvTransposePrepare(
+    MLAS_CONV_TRANSPOSE_PARAMETERS* Parameters,
+    size_t Dimensions,
+    size_t BatchCount,
+    size_t GroupCount,
+    size_t InputChannels,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    size_t FilterCount,
+    const MLAS_ACTIVATION* Activation,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine prepares for a transposed convolution operation by computing
+    required parameters including the required working buffer size for the
+    column matrix.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the transposed convolution operation.
+
+    Dimensions - Supplies the number of dimensions (must be between 1 and 3).
+
+    BatchCount - Supplies the number of batches to the processed.
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    InputShape - Supplies the shape of the input tensor.
+
+    KernelShape - Supplies the shape of the kernel transform.
+
+    DilationShape - Supplies the shape of the dilation.
+
+    Padding - Supplies the number of padding elements removed from the edge
+        of the output tensor.
+
+    StrideShape - Supplies the shape of the stride.
+
+    OutputShape - Supplies the shape of the output tensor, which includes any
+        additional output padding.
+
+    FilterCount - Supplies the number of output channels per group.
+
+    Activation - Supplies the parameters for the activation to apply to the
+        transposed convolution output.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer for intermediate results.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    Parameters->Activation = Activation;
+    Parameters->Dimensions = Dimensions;
+    Parameters->BatchCount = BatchCount;
+    Parameters->GroupCount = GroupCount;
+    Parameters->InputChannels = InputChannels;
+    Parameters->FilterCount = FilterCount;
+
+    size_t InputSize = 1;
+    size_t OutputSize = 1;
+    size_t KernelSize = 1;
+
+    for (size_t dim = 0; dim < Dimensions; dim++) {
+
+        Parameters->InputShape[dim] = size_t(InputShape[dim]);
+        Parameters->OutputShape[dim] = size_t(OutputShape[dim]);
+        Parameters->KernelShape[dim] = size_t(KernelShape[dim]);
+        Parameters->DilationShape[dim] = size_t(DilationShape[dim]);
+        Parameters->Padding[dim] = size_t(Padding[dim]);
+        Parameters->Padding[dim + Dimensions] = size_t(Padding[dim + Dimensions]);
+        Parameters->StrideShape[dim] = size_t(StrideShape[dim]);
+
+        InputSize *= Parameters->InputShape[dim];
+        OutputSize *= Parameters->OutputShape[dim];
+        KernelSize *= Parameters->KernelShape[dim];
+    }
+
+    Parameters->InputSize = InputSize;
+    Parameters->OutputSize = OutputSize;
+    Parameters->KernelSize = KernelSize;
+
+    //
+    // Compute the number of target threads for the col2im step given the
+    // number of elements of the column matrix to accumulate, partitioned as
+    // rows of the output tensor.
+    //
+
+    const size_t TotalRows = FilterCount * (OutputSize / Parameters->OutputShape[Dimensions - 1]);
+    const double Complexity = double(FilterCount) * double(KernelSize) * double(InputSize);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+    TargetThreadCount = std::min(TargetThreadCount, MlasGetMaximumThreadCount(ThreadPool));
+    TargetThreadCount = std::min(TargetThreadCount, ptrdiff_t(TotalRows));
+
+    Parameters->ThreadCount = TargetThreadCount;
+
+    *WorkingBufferSize = FilterCount * KernelSize * InputSize;
+}
+
+void
+MLASCALL
+MlasConvTranspose(
+    const MLAS_CONV_TRANSPOSE_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the transposed convolution operation.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the transposed
+        convolution parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor, with the input channels as the
+        outer dimension.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvTransposePrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t M = FilterCount * Parameters->KernelSize;
+
+    MLAS_CONV_TRANSPOSE_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.ColumnBuffer = WorkingBuffer;
+    WorkBlock.TargetThreadCount = Parameters->ThreadCount;
+
+    for (size_t batch = 0; batch < Parameters->BatchCount; batch++) {
+
+        const float* filter = Filter;
+        const float* bias = Bias;
+
+        for (size_t group = 0; group < Parameters->GroupCount; group++) {
+
+            //
+            // Multiply the transposed filter of the group with the input
+            // tensor of the group to produce the column matrix.
+            //
+
+            MLAS_SGEMM_DATA_PARAMS Data;
+
+            Data.A = filter;
+            Data.lda = M;
+            Data.B = Input;
+            Data.ldb = InputSize;
+            Data.C = WorkingBuffer;
+            Data.ldc = InputSize;
+
+            MlasGemmBatch(CblasTrans, CblasNoTrans, M, InputSize, InputChannels, &Data, 1, ThreadPool);
+
+            //
+            // Scatter and accumulate the column matrix to the output tensor.
+            //
+
+            WorkBlock.Bias = bias;
+            WorkBlock.Output = Output;
+
+            if (WorkBlock.TargetThreadCount == 1) {
+                MlasConvTransposeCol2ImThreaded(&WorkBlock, 0);
+            } else {
+                MlasExecuteThreaded(MlasConvTransposeCol2ImThreaded, &WorkBlock,
+                    WorkBlock.TargetThreadCount, ThreadPool);
+            }
+
+            if (bias != nullptr) {
+                bias += FilterCount;
+            }
+
+            filter += InputChannels * M;
+            Input += InputChannels * InputSize;
+            Output += FilterCount * OutputSize;
+        }
+    }
+}
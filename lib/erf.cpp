@@ -0,0 +1,132 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    erf.cpp
+
+Abstract:
+
+    This module implements the error function.
+
+    For |x| <= 0.921875, the function is computed as x * P(x^2) with the
+    degree-10 Taylor polynomial of erf(x) / x. Above that, the function is
+    computed as 1 - t * P(t) * exp(-x^2) with t = 1 / (1 + p * |x|) using the
+    approximation 7.1.26 of Abramowitz and Stegun, which has an absolute error
+    below 1.5e-7. The maximum error is 5 ulp.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Bundles the floating point constants for use by kernels written in assembly.
+//
+
+MLAS_INTERNAL_DATA const MLAS_ERF_CONSTANTS MlasErfConstants = {
+    0.921875f,
+    1.4807192815879218e-08f,
+    -1.6365844691234924e-07f,
+    1.6462114365889246e-06f,
+    -1.492565035840625e-05f,
+    0.00012055332981789664f,
+    -0.0008548327023450852f,
+    0.005223977625442188f,
+    -0.026866170645131252f,
+    0.11283791670955126f,
+    -0.37612638903183754f,
+    1.1283791670955126f,
+    0.3275911f,
+    1.061405429f,
+    -1.453152027f,
+    1.421413741f,
+    -0.284496736f,
+    0.254829592f,
+};
+
+void
+MLASCALL
+MlasErfKernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the error function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasErfFloat32x4(MlasLoadFloat32x4(Input)));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        MlasStoreLaneFloat32x4<0>(Output, MlasErfFloat32x4(MlasBroadcastFloat32x4(*Input)));
+
+        Input += 1;
+        Output += 1;
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasComputeErf(
+    const float* Input,
+    float* Output,
+    size_t N,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the error function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasComputeUnary(GetMlasPlatform().ErfKernelRoutine, Input, Output, N, ThreadPool);
+#else
+    MlasComputeUnary(MlasErfKernel, Input, Output, N, ThreadPool);
+#endif
+}
@@ -0,0 +1,105 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    logistic.cpp
+
+Abstract:
+
+    This module implements the logistic function.
+
+    The function is computed as 1 / (1 + exp(-x)) using the exponential of
+    compute.cpp. The maximum error is 3 ulp for results above 2^-125, below
+    which the result is flushed to zero.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasLogisticKernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the logistic function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasLogisticFloat32x4(MlasLoadFloat32x4(Input)));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        MlasStoreLaneFloat32x4<0>(Output, MlasLogisticFloat32x4(MlasBroadcastFloat32x4(*Input)));
+
+        Input += 1;
+        Output += 1;
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasComputeLogistic(
+    const float* Input,
+    float* Output,
+    size_t N,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the logistic function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasComputeUnary(GetMlasPlatform().LogisticKernelRoutine, Input, Output, N, ThreadPool);
+#else
+    MlasComputeUnary(MlasLogisticKernel, Input, Output, N, ThreadPool);
+#endif
+}
@@ -18,6 +18,7 @@ Abstract:
 #pragma once
 
 #include <mlas.h>
+#include <atomic>
 #include <memory>
 #include <algorithm>
 #include <limits>
@@ -25,6 +26,7 @@ Abstract:
 #include <type_traits>
 #include <stdexcept>
 #include <functional>
+#include <vector>
 
 #if defined(_WIN32)
 #ifndef WIN32_LEAN_AND_MEAN
@@ -94,12 +96,62 @@ variable
 
 #define MLAS_UNREFERENCED_PARAMETER(parameter) ((void)(parameter))
 
+//
+// Define the core types of hybrid processors.
+//
+
+enum MlasCoreType { mlas_core_unknown = 0,
+                    mlas_core_little = 2,
+                    mlas_core_big = 3 };
+
+//
+// Stores a non-owning reference to a callable object.
+//
+// Unlike std::function, constructing the reference never allocates and
+// invoking it is a single indirect call. The referenced object must outlive
+// the reference, so the reference is intended to be passed down to routines
+// that invoke it before returning.
+//
+
+template <typename Signature>
+class MLAS_FUNCTION_REF;
+
+template <typename ReturnType, typename... ArgumentTypes>
+class MLAS_FUNCTION_REF<ReturnType(ArgumentTypes...)> {
+ public:
+  template <typename CallableType,
+            typename = typename std::enable_if<
+                !std::is_same<typename std::decay<CallableType>::type, MLAS_FUNCTION_REF>::value>::type>
+  MLAS_FUNCTION_REF(CallableType&& Callable)
+      : Callable_(const_cast<void*>(static_cast<const void*>(std::addressof(Callable)))),
+        Invoke_(&Invoke<typename std::remove_reference<CallableType>::type>) {
+  }
+
+  ReturnType
+  operator()(
+      ArgumentTypes... Arguments) const {
+    return Invoke_(Callable_, std::forward<ArgumentTypes>(Arguments)...);
+  }
+
+ private:
+  template <typename CallableType>
+  static ReturnType
+  Invoke(
+      void* Callable,
+      ArgumentTypes... Arguments) {
+    return (*static_cast<CallableType*>(Callable))(std::forward<ArgumentTypes>(Arguments)...);
+  }
+
+  void* Callable_;
+  ReturnType (*Invoke_)(void*, ArgumentTypes...);
+};
+
 //
 // Select the threading model.
 //
-// N.B. BUILD_MLAS_NO_ONNXRUNTIME is used to build MLAS test code outside
-// of the ONNX Runtime source tree. OpenMP may or may not be enabled in this
-// configuration.
+// N.B. BUILD_MLAS_NO_ONNXRUNTIME is used to build MLAS outside of the ONNX
+// Runtime source tree. The library then supplies its own thread pool that
+// implements the subset of the ONNX Runtime thread pool contract used here.
 //
 
 #if !defined(BUILD_MLAS_NO_ONNXRUNTIME)
@@ -110,6 +162,8 @@ using MLAS_CPUIDINFO = onnxruntime::CPUIDInfo;
 
 #else  // BUILD_MLAS_NO_ONNXRUNTIME
 
+#include "threadpool.h"
+
 class MLASCPUIDInfo {
  public:
   static const MLASCPUIDInfo& GetCPUIDInfo() {
@@ -186,6 +240,22 @@ enum MlasUArch {
 
 #define MLAS_MAXIMUM_THREAD_COUNT 16
 
+//
+// Define the number of work items to generate per thread when an operation is
+// large enough to be segmented across multiple threads. Generating more work
+// items than threads allows the thread pool to rebalance the work when some
+// threads run slower than others.
+//
+
+#define MLAS_THREADED_WORK_ITEMS_PER_THREAD 4
+
+//
+// Define the size of the per core L2 cache to assume if the size cannot be
+// queried from the processor.
+//
+
+#define MLAS_DEFAULT_L2_CACHE_SIZE (512 * 1024)
+
 //
 // Define the default strides to step through slices of the input matrices.
 //
@@ -323,6 +393,15 @@ typedef size_t(MLASCALL MLAS_GEMM_U8U8_KERNEL)(
     const int32_t* ZeroPointB,
     bool ZeroMode);
 
+//
+// Define the convolution kernel flags.
+//
+
+#define MLAS_CONV_KERNEL_FLAG_ACCUMULATE_OUTPUT 0x00000001
+#define MLAS_CONV_KERNEL_FLAG_BIAS_ADDITION 0x00000002
+#define MLAS_CONV_KERNEL_FLAG_RELU_ACTIVATION 0x00000004
+#define MLAS_CONV_KERNEL_FLAG_OTHER_ACTIVATION 0x00000008
+
 typedef void(MLASCALL MLAS_CONV_FLOAT_KERNEL)(
     const float* Input,
     const float* Filter,
@@ -397,13 +476,21 @@ typedef void(MLASCALL MLAS_COMPUTE_UNARY_FLOAT_KERNEL)(
     float* Output,
     size_t N);
 
+typedef void(MLASCALL MLAS_ACTIVATION_FLOAT_KERNEL)(
+    const MLAS_ACTIVATION* Activation,
+    float* Buffer,
+    const float* Bias,
+    size_t M,
+    size_t N,
+    size_t ldc);
+
 typedef float(MLASCALL MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL)(
     const float* Input,
-    float* Output,
     size_t N,
-    const float* NegativeMaximum);
+    float* Maximum);
 
 typedef void(MLASCALL MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL)(
+    const float* Input,
     float* Output,
     size_t N,
     const float* Parameters);
@@ -584,8 +671,8 @@ MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeLogisticF32KernelFma3;
 MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeTanhF32KernelFma3;
 MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32KernelFma3;
 MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32KernelAvx512F;
-MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeSoftmaxOutputF32KernelAvx;
-MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeLogSoftmaxOutputF32KernelAvx;
+MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeSoftmaxOutputF32KernelFma3;
+MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeLogSoftmaxOutputF32KernelFma3;
 MLAS_QLINEAR_BINARY_OP_S8_KERNEL MlasQLinearAddS8KernelAvx2;
 MLAS_QLINEAR_BINARY_OP_U8_KERNEL MlasQLinearAddU8KernelAvx2;
 MLAS_QUANTIZE_LINEAR_S8_KERNEL MlasQuantizeLinearS8KernelAvx512F;
@@ -598,8 +685,89 @@ MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL MlasReduceMinimumMaximumF32Kernel;
 MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL MlasReduceMaximumF32KernelAvx;
 MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL MlasReduceMinimumMaximumF32KernelAvx;
 #endif
+
+MLAS_ACTIVATION_FLOAT_KERNEL MlasActivationFloatKernel;
+#if defined(MLAS_TARGET_AMD64)
+MLAS_ACTIVATION_FLOAT_KERNEL MlasActivationFloatKernelAvx;
+MLAS_ACTIVATION_FLOAT_KERNEL MlasActivationFloatKernelFma3;
+#endif
 }
 
+//
+// Define the constants of the transcendental functions, which are shared by
+// the kernels of each instruction set.
+//
+// The exponential function reduces the input to exp(r) * 2^n with
+// |r| <= ln(2) / 2 and evaluates exp(r) with a Taylor polynomial.
+//
+// The tanh function uses a rational approximation over the range [-9, 9],
+// outside of which tanh(x) rounds to -1 or 1.
+//
+// The erf function uses a Taylor polynomial in x^2 below the split boundary,
+// else the Abramowitz and Stegun approximation 7.1.26.
+//
+
+struct MLAS_EXP_CONSTANTS {
+  float LowerRange;
+  float UpperRange;
+  float Log2Reciprocal;
+  float Log2High;
+  float Log2Low;
+  float RoundingBias;
+  float poly_6;
+  float poly_5;
+  float poly_4;
+  float poly_3;
+  float poly_2;
+  float poly_1;
+  float poly_0;
+};
+
+struct MLAS_TANH_CONSTANTS {
+  float LowerRange;
+  float UpperRange;
+  float alpha_13;
+  float alpha_11;
+  float alpha_9;
+  float alpha_7;
+  float alpha_5;
+  float alpha_3;
+  float alpha_1;
+  float beta_6;
+  float beta_4;
+  float beta_2;
+  float beta_0;
+};
+
+struct MLAS_ERF_CONSTANTS {
+  float SplitBoundary;
+  float small_10;
+  float small_9;
+  float small_8;
+  float small_7;
+  float small_6;
+  float small_5;
+  float small_4;
+  float small_3;
+  float small_2;
+  float small_1;
+  float small_0;
+  float p;
+  float a5;
+  float a4;
+  float a3;
+  float a2;
+  float a1;
+};
+
+MLAS_INTERNAL_DATA const MLAS_EXP_CONSTANTS MlasExpConstants;
+MLAS_INTERNAL_DATA const MLAS_TANH_CONSTANTS MlasTanhConstants;
+MLAS_INTERNAL_DATA const MLAS_ERF_CONSTANTS MlasErfConstants;
+
+#if defined(MLAS_TARGET_AMD64)
+MLAS_INTERNAL_DATA const uint32_t MlasMaskMoveTableAvx[16];
+#endif
+
 //
 // Define the default preferred byte alignment for buffers.
 //
@@ -626,6 +794,27 @@ MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL MlasReduceMinimumMaximumF32KernelAvx;
 #define MLAS_DGEMM_THREAD_COMPLEXITY (64 * 1024)
 #define MLAS_QGEMM_THREAD_COMPLEXITY (64 * 1024)
 
+//
+// Define the target number of per-thread elements to pack before using
+// another thread to pack additional blocks of a matrix.
+//
+
+#define MLAS_SGEMM_PACKB_THREAD_COMPLEXITY (256 * 1024)
+
+//
+// Define the target number of per-thread elements of the elementwise compute
+// routines before using another thread to compute additional elements.
+//
+
+#define MLAS_COMPUTE_UNARY_THREAD_COMPLEXITY (64 * 1024)
+
+//
+// Define the target number of per-thread elements of the softmax routines,
+// which make two passes over the data, before using another thread.
+//
+
+#define MLAS_COMPUTE_SOFTMAX_THREAD_COMPLEXITY (32 * 1024)
+
 //
 // Single-threaded single precision matrix/matrix multiply operation.
 //
@@ -643,7 +832,113 @@ void MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc);
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr);
+
+//
+// Single-threaded single precision matrix/matrix multiply operation with
+// matrix B packed by MlasGemmPackB or by a routine that produces the same
+// layout.
+//
+
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    size_t AlignedN,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue);
+
+//
+// Selects the grid of segments used to partition a SGEMM operation across
+// threads.
+//
+
+void
+MlasSgemmPartitionThreads(
+    size_t M,
+    size_t N,
+    size_t K,
+    ptrdiff_t ThreadCount,
+    ptrdiff_t* ThreadCountM,
+    ptrdiff_t* ThreadCountN);
+
+//
+// Single-threaded single precision matrix/matrix multiply operation with
+// matrix A packed by MlasGemmPackA.
+//
+
+void
+MlasSgemmPackedAOperation(
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* PackedA,
+    size_t PackedM,
+    size_t StartM,
+    const float* B,
+    size_t ldb,
+    bool BIsPacked,
+    size_t RangeStartN,
+    size_t AlignedN,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue);
+
+//
+// Applies the epilogue of a SGEMM operation to a block of the output matrix.
+//
+
+void
+MlasSgemmApplyEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    float* C,
+    size_t ldc,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN);
+
+//
+// Depthwise convolution of one NCHWc block of channels on the calling thread.
+// Used by MlasConv for depthwise convolutions of NCHW tensors.
+//
+
+void
+MlasNchwcConvDepthwiseBlock(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    const MLAS_ACTIVATION* Activation);
+
+//
+// Transposes a matrix whose rows may be embedded in a larger buffer. Used by
+// the buffer reordering routines and the depthwise convolution.
+//
+
+void
+MLASCALL
+MlasTransposeStrided(
+    const uint32_t* Input,
+    size_t InputStride,
+    uint32_t* Output,
+    size_t OutputStride,
+    size_t M,
+    size_t N);
 
 //
 // Quantized integer matrix/matrix dispatch structure.
@@ -741,10 +1036,6 @@ struct MLAS_CONV_SYM_POST_PROCESS_PARAMS {
 // Environment information class.
 //
 
-enum MlasCoreType { mlas_core_unknown = 0,
-                    mlas_core_little = 2,
-                    mlas_core_big = 3 };
-
 struct MLAS_PLATFORM {
   MLAS_PLATFORM(void);
 
@@ -793,6 +1084,7 @@ struct MLAS_PLATFORM {
   MLAS_COMPUTE_UNARY_FLOAT_KERNEL* ComputeExpF32Kernel;
   MLAS_COMPUTE_UNARY_FLOAT_KERNEL* LogisticKernelRoutine;
   MLAS_COMPUTE_UNARY_FLOAT_KERNEL* TanhKernelRoutine;
+  MLAS_ACTIVATION_FLOAT_KERNEL* ActivationFloatKernel;
   MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL* ComputeSumExpF32Kernel;
   MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL* ComputeSoftmaxOutputF32Kernel;
   MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL* ComputeLogSoftmaxOutputF32Kernel;
@@ -803,10 +1095,13 @@ struct MLAS_PLATFORM {
   uint32_t NchwcBlockSize;
   uint32_t PreferredBufferAlignment;
   int32_t MaximumThreadCount;
+  size_t L2CacheSize;
 #elif defined(MLAS_TARGET_ARM64)
   static constexpr int32_t MaximumThreadCount = MLAS_MAXIMUM_THREAD_COUNT * 4;
+  static constexpr size_t L2CacheSize = MLAS_DEFAULT_L2_CACHE_SIZE;
 #else
   static constexpr int32_t MaximumThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+  static constexpr size_t L2CacheSize = MLAS_DEFAULT_L2_CACHE_SIZE;
 #endif
 };
 
@@ -839,22 +1134,89 @@ MlasDivRoundup(size_t up, size_t down) {
  *
  * @param ThreadPool [IN]          Optional thread pool. Ignored when using OpenMP
  * @param Iterations [IN]          Total number of iterations
- * @param Work [IN]                Logic for computing a range of iterations [begin, end)
+ * @param Work [IN]                Logic for computing a range of iterations [begin, end).
+ *                                 The callable is referenced, not copied, and
+ *                                 must outlive the call.
  */
 void MlasTrySimpleParallel(
     MLAS_THREADPOOL* ThreadPool,
     const std::ptrdiff_t Iterations,
-    const std::function<void(std::ptrdiff_t tid)>& Work);
+    MLAS_FUNCTION_REF<void(std::ptrdiff_t tid)> Work);
+
+//
+// Applies an elementwise compute kernel to a buffer, using worker threads for
+// segments of MLAS_COMPUTE_UNARY_THREAD_COMPLEXITY or more elements.
+//
+
+void
+MlasComputeUnary(
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL* Kernel,
+    const float* Input,
+    float* Output,
+    size_t N,
+    MLAS_THREADPOOL* ThreadPool);
+
+//
+// Processor topology support.
+//
+
+#define MLAS_CPU_CAPACITY_SCALE 1024
+
+struct MLAS_CPU_INFO {
+  uint32_t Index;
+  MlasCoreType CoreType;
+  uint32_t Capacity;  // relative to MLAS_CPU_CAPACITY_SCALE
+  uint32_t NumaNode;  // index into MLAS_CPU_TOPOLOGY::NumaNodeIds
+};
+
+struct MLAS_CPU_TOPOLOGY {
+  std::vector<MLAS_CPU_INFO> Cpus;  // sorted by logical processor index
+  bool IsHybrid;
+
+  //
+  // Stores the operating system identifier of each NUMA node that contains
+  // an available processor. The NUMA topology is simulated if the
+  // MLAS_NUMA_NODES environment variable is set, in which case the nodes do
+  // not correspond to memory.
+  //
+
+  std::vector<uint32_t> NumaNodeIds;
+  bool IsNumaSimulated;
+};
+
+const MLAS_CPU_TOPOLOGY&
+MlasGetCpuTopology(
+    void);
+
+inline size_t
+MlasGetNumaNodeCount(
+    void) {
+  return MlasGetCpuTopology().NumaNodeIds.size();
+}
+
+uint32_t
+MlasGetCurrentCpuCapacity(
+    void);
+
+uint32_t
+MlasGetCurrentNumaNode(
+    void);
+
+bool
+MlasSetCurrentThreadAffinity(
+    MlasCoreType CoreType,
+    int32_t NumaNode);
+
+void
+MlasBindMemoryToNumaNode(
+    void* Buffer,
+    size_t BufferSize,
+    int32_t NumaNode);
 
 inline ptrdiff_t
 MlasGetMaximumThreadCount(
     MLAS_THREADPOOL* ThreadPool) {
-#if defined(BUILD_MLAS_NO_ONNXRUNTIME)
-  MLAS_UNREFERENCED_PARAMETER(ThreadPool);
-  return 1;
-#else
   return onnxruntime::concurrency::ThreadPool::DegreeOfParallelism(ThreadPool);
-#endif
 }
 
 inline void
@@ -876,6 +1238,28 @@ MlasPartitionWork(
   }
 }
 
+//
+// Partitions work in proportion to a weight per thread, such as the capacity
+// of the core running the thread. The thread receives the share of the work
+// that corresponds to [WeightStart, WeightStart + Weight) of TotalWeight, so
+// accumulating the weights of the preceding threads yields contiguous ranges
+// that cover all of the work.
+//
+
+inline void
+MlasPartitionWorkWeighted(
+    uint64_t WeightStart,
+    uint64_t Weight,
+    uint64_t TotalWeight,
+    size_t TotalWork,
+    size_t* WorkIndex,
+    size_t* WorkRemaining) {
+  const size_t WorkEnd = size_t(uint64_t(TotalWork) * (WeightStart + Weight) / TotalWeight);
+
+  *WorkIndex = size_t(uint64_t(TotalWork) * WeightStart / TotalWeight);
+  *WorkRemaining = WorkEnd - *WorkIndex;
+}
+
 //
 // Define the minimum floating point value (and its bit value equivalent) that
 // has no fractional bits. This number can be used for fast rounding of floating
@@ -1757,6 +2141,148 @@ MlasPowerOf2Float32x4(MLAS_FLOAT32X4 Vector) {
   return MlasReinterpretAsFloat32x4(MlasShiftLeftInt32x4<23>(emm0));
 }
 
+//
+// Elementwise transcendental functions.
+//
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasExpFloat32x4(MLAS_FLOAT32X4 Value) {
+  //
+  // Results below 2^-125 are flushed to zero and results above FLT_MAX are
+  // infinity. The input is clamped so that 2^(n - 1) is a normal number, and
+  // the result is scaled by 2^(n - 1) and then doubled.
+  //
+
+  MLAS_FLOAT32X4 LowerRange = MlasBroadcastFloat32x4(MlasExpConstants.LowerRange);
+  MLAS_FLOAT32X4 UpperRange = MlasBroadcastFloat32x4(MlasExpConstants.UpperRange);
+
+  MLAS_FLOAT32X4 UnderflowMask = MlasGreaterThanFloat32x4(LowerRange, Value);
+  MLAS_FLOAT32X4 OverflowMask = MlasGreaterThanFloat32x4(Value, UpperRange);
+
+  Value = MlasMaximumFloat32x4(LowerRange, Value);
+  Value = MlasMinimumFloat32x4(UpperRange, Value);
+
+  MLAS_FLOAT32X4 RoundingBias = MlasBroadcastFloat32x4(MlasExpConstants.RoundingBias);
+  MLAS_FLOAT32X4 n = MlasMultiplyAddFloat32x4(Value, MlasExpConstants.Log2Reciprocal, RoundingBias);
+  n = MlasSubtractFloat32x4(n, RoundingBias);
+
+  MLAS_FLOAT32X4 r = MlasMultiplyAddFloat32x4(n, MlasExpConstants.Log2High, Value);
+  r = MlasMultiplyAddFloat32x4(n, MlasExpConstants.Log2Low, r);
+
+  MLAS_FLOAT32X4 p;
+  p = MlasMultiplyAddFloat32x4(r, MlasBroadcastFloat32x4(MlasExpConstants.poly_6),
+                               MlasBroadcastFloat32x4(MlasExpConstants.poly_5));
+  p = MlasMultiplyAddFloat32x4(p, r, MlasExpConstants.poly_4);
+  p = MlasMultiplyAddFloat32x4(p, r, MlasExpConstants.poly_3);
+  p = MlasMultiplyAddFloat32x4(p, r, MlasExpConstants.poly_2);
+  p = MlasMultiplyAddFloat32x4(p, r, MlasExpConstants.poly_1);
+  p = MlasMultiplyAddFloat32x4(p, r, MlasExpConstants.poly_0);
+
+  p = MlasMultiplyFloat32x4(p, MlasPowerOf2Float32x4(MlasSubtractFloat32x4(n, MlasBroadcastFloat32x4(1.0f))));
+  p = MlasAddFloat32x4(p, p);
+
+  p = MlasAndNotFloat32x4(UnderflowMask, p);
+  p = MlasBlendFloat32x4(p, MlasBroadcastFloat32x4(std::numeric_limits<float>::infinity()), OverflowMask);
+
+  return p;
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasTanhFloat32x4(MLAS_FLOAT32X4 Value) {
+  //
+  // The rational approximation is below one at the clamped range, so the
+  // result is set to +/-1 for the inputs beyond the range.
+  //
+
+  MLAS_FLOAT32X4 SignMask = MlasBroadcastFloat32x4(-0.0f);
+  MLAS_FLOAT32X4 SaturatedMask = MlasGreaterThanFloat32x4(MlasAndNotFloat32x4(SignMask, Value),
+                                                          MlasBroadcastFloat32x4(MlasTanhConstants.UpperRange));
+
+  Value = MlasClampFloat32x4(Value, MlasTanhConstants.LowerRange, MlasTanhConstants.UpperRange);
+
+  MLAS_FLOAT32X4 ValueSquared = MlasMultiplyFloat32x4(Value, Value);
+
+  MLAS_FLOAT32X4 p;
+  p = MlasMultiplyAddFloat32x4(ValueSquared, MlasBroadcastFloat32x4(MlasTanhConstants.alpha_13),
+                               MlasBroadcastFloat32x4(MlasTanhConstants.alpha_11));
+  p = MlasMultiplyAddFloat32x4(p, ValueSquared, MlasTanhConstants.alpha_9);
+  p = MlasMultiplyAddFloat32x4(p, ValueSquared, MlasTanhConstants.alpha_7);
+  p = MlasMultiplyAddFloat32x4(p, ValueSquared, MlasTanhConstants.alpha_5);
+  p = MlasMultiplyAddFloat32x4(p, ValueSquared, MlasTanhConstants.alpha_3);
+  p = MlasMultiplyAddFloat32x4(p, ValueSquared, MlasTanhConstants.alpha_1);
+  p = MlasMultiplyFloat32x4(p, Value);
+
+  MLAS_FLOAT32X4 q;
+  q = MlasMultiplyAddFloat32x4(ValueSquared, MlasBroadcastFloat32x4(MlasTanhConstants.beta_6),
+                               MlasBroadcastFloat32x4(MlasTanhConstants.beta_4));
+  q = MlasMultiplyAddFloat32x4(q, ValueSquared, MlasTanhConstants.beta_2);
+  q = MlasMultiplyAddFloat32x4(q, ValueSquared, MlasTanhConstants.beta_0);
+
+  MLAS_FLOAT32X4 Saturated = MlasOrFloat32x4(MlasBroadcastFloat32x4(1.0f), MlasAndFloat32x4(Value, SignMask));
+
+  return MlasBlendFloat32x4(MlasDivideFloat32x4(p, q), Saturated, SaturatedMask);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasLogisticFloat32x4(MLAS_FLOAT32X4 Value) {
+  MLAS_FLOAT32X4 One = MlasBroadcastFloat32x4(1.0f);
+  MLAS_FLOAT32X4 NegativeExp = MlasExpFloat32x4(MlasXorFloat32x4(Value, MlasBroadcastFloat32x4(-0.0f)));
+  return MlasDivideFloat32x4(One, MlasAddFloat32x4(One, NegativeExp));
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasErfFloat32x4(MLAS_FLOAT32X4 Value) {
+  MLAS_FLOAT32X4 SignMask = MlasBroadcastFloat32x4(-0.0f);
+  MLAS_FLOAT32X4 One = MlasBroadcastFloat32x4(1.0f);
+
+  MLAS_FLOAT32X4 AbsValue = MlasAndNotFloat32x4(SignMask, Value);
+  MLAS_FLOAT32X4 ValueSquared = MlasMultiplyFloat32x4(Value, Value);
+
+  //
+  // Evaluate x * P(x^2) for the small range.
+  //
+
+  MLAS_FLOAT32X4 s;
+  s = MlasMultiplyAddFloat32x4(ValueSquared, MlasBroadcastFloat32x4(MlasErfConstants.small_10),
+                               MlasBroadcastFloat32x4(MlasErfConstants.small_9));
+  s = MlasMultiplyAddFloat32x4(s, ValueSquared, MlasErfConstants.small_8);
+  s = MlasMultiplyAddFloat32x4(s, ValueSquared, MlasErfConstants.small_7);
+  s = MlasMultiplyAddFloat32x4(s, ValueSquared, MlasErfConstants.small_6);
+  s = MlasMultiplyAddFloat32x4(s, ValueSquared, MlasErfConstants.small_5);
+  s = MlasMultiplyAddFloat32x4(s, ValueSquared, MlasErfConstants.small_4);
+  s = MlasMultiplyAddFloat32x4(s, ValueSquared, MlasErfConstants.small_3);
+  s = MlasMultiplyAddFloat32x4(s, ValueSquared, MlasErfConstants.small_2);
+  s = MlasMultiplyAddFloat32x4(s, ValueSquared, MlasErfConstants.small_1);
+  s = MlasMultiplyAddFloat32x4(s, ValueSquared, MlasErfConstants.small_0);
+  s = MlasMultiplyFloat32x4(s, Value);
+
+  //
+  // Evaluate 1 - t * P(t) * exp(-x^2) with t = 1 / (1 + p * |x|) for the
+  // large range.
+  //
+
+  MLAS_FLOAT32X4 t = MlasDivideFloat32x4(One, MlasMultiplyAddFloat32x4(AbsValue, MlasErfConstants.p, One));
+
+  MLAS_FLOAT32X4 l;
+  l = MlasMultiplyAddFloat32x4(t, MlasBroadcastFloat32x4(MlasErfConstants.a5),
+                               MlasBroadcastFloat32x4(MlasErfConstants.a4));
+  l = MlasMultiplyAddFloat32x4(l, t, MlasErfConstants.a3);
+  l = MlasMultiplyAddFloat32x4(l, t, MlasErfConstants.a2);
+  l = MlasMultiplyAddFloat32x4(l, t, MlasErfConstants.a1);
+  l = MlasMultiplyFloat32x4(l, t);
+  l = MlasMultiplyFloat32x4(l, MlasExpFloat32x4(MlasXorFloat32x4(ValueSquared, SignMask)));
+  l = MlasSubtractFloat32x4(One, l);
+  l = MlasOrFloat32x4(l, MlasAndFloat32x4(Value, SignMask));
+
+  MLAS_FLOAT32X4 LargeMask = MlasGreaterThanFloat32x4(AbsValue, MlasBroadcastFloat32x4(MlasErfConstants.SplitBoundary));
+
+  return MlasBlendFloat32x4(s, l, LargeMask);
+}
+
 //
 // Cross-platform wrappers for 64-bit vector intrinsics.
 //
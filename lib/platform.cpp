@@ -147,6 +147,79 @@ MlasReadExtendedControlRegister(
 #endif
 }
 
+#if defined(MLAS_TARGET_AMD64)
+
+size_t
+MlasGetL2CacheSize(
+    void)
+/*++
+
+Routine Description:
+
+    This routine queries the size of the L2 data cache of a core using the
+    deterministic cache parameters leaf. Intel processors report the caches
+    through leaf 4 and AMD processors through leaf 0x8000001D, using the same
+    register layout.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the size of the L2 cache in bytes.
+
+--*/
+{
+  const unsigned CacheLeafs[] = {4, 0x8000001D};
+
+  for (unsigned CacheLeaf : CacheLeafs) {
+    unsigned MaximumLeaf[4];
+#if defined(_WIN32)
+    __cpuid((int*)MaximumLeaf, int(CacheLeaf & 0x80000000));
+#else
+    __cpuid(CacheLeaf & 0x80000000, MaximumLeaf[0], MaximumLeaf[1], MaximumLeaf[2], MaximumLeaf[3]);
+#endif
+
+    if (MaximumLeaf[0] < CacheLeaf) {
+      continue;
+    }
+
+    for (unsigned SubLeaf = 0; SubLeaf < 16; SubLeaf++) {
+      unsigned CacheInfo[4];
+#if defined(_WIN32)
+      __cpuidex((int*)CacheInfo, int(CacheLeaf), int(SubLeaf));
+#else
+      __cpuid_count(CacheLeaf, SubLeaf, CacheInfo[0], CacheInfo[1], CacheInfo[2], CacheInfo[3]);
+#endif
+
+      const unsigned CacheType = CacheInfo[0] & 0x1F;
+      const unsigned CacheLevel = (CacheInfo[0] >> 5) & 0x7;
+
+      if (CacheType == 0) {
+        break;
+      }
+
+      //
+      // Select the L2 data or unified cache.
+      //
+
+      if (CacheLevel == 2 && CacheType != 2) {
+        const size_t Ways = ((CacheInfo[1] >> 22) & 0x3FF) + 1;
+        const size_t Partitions = ((CacheInfo[1] >> 12) & 0x3FF) + 1;
+        const size_t LineSize = (CacheInfo[1] & 0xFFF) + 1;
+        const size_t Sets = size_t(CacheInfo[2]) + 1;
+
+        return Ways * Partitions * LineSize * Sets;
+      }
+    }
+  }
+
+  return MLAS_DEFAULT_L2_CACHE_SIZE;
+}
+
+#endif  // MLAS_TARGET_AMD64
+
 #endif  // MLAS_TARGET_AMD64_IX86
 
 MLAS_PLATFORM::MLAS_PLATFORM(
@@ -178,10 +251,22 @@ Return Value:
 #if defined(MLAS_TARGET_AMD64)
 
   this->ConvNchwFloatKernel = MlasConvNchwFloatKernelSse;
+  this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelSse;
+  this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelSse;
+  this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelSse;
+  this->ActivationFloatKernel = MlasActivationFloatKernel;
+  this->ComputeExpF32Kernel = MlasComputeExpF32Kernel;
+  this->TanhKernelRoutine = MlasTanhKernel;
+  this->LogisticKernelRoutine = MlasLogisticKernel;
+  this->ErfKernelRoutine = MlasErfKernel;
+  this->ComputeSumExpF32Kernel = MlasComputeSumExpF32Kernel;
+  this->ComputeSoftmaxOutputF32Kernel = MlasComputeSoftmaxOutputF32Kernel;
+  this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32Kernel;
   this->NchwcBlockSize = 8;
   this->PreferredBufferAlignment = MLAS_DEFAULT_PREFERRED_BUFFER_ALIGNMENT;
 
   this->MaximumThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+  this->L2CacheSize = MlasGetL2CacheSize();
 
 #endif
 
@@ -211,6 +296,10 @@ Return Value:
       this->KernelM1Routine = MlasSgemmKernelM1Avx;
       this->KernelM1TransposeBRoutine = MlasSgemmKernelM1TransposeBAvx;
       this->ConvNchwFloatKernel = MlasConvNchwFloatKernelAvx;
+      this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelAvx;
+      this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelAvx;
+      this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelAvx;
+      this->ActivationFloatKernel = MlasActivationFloatKernelAvx;
 
       //
       // Check if the processor supports AVX2/FMA3 features.
@@ -226,6 +315,17 @@ Return Value:
       if (((Cpuid1[2] & 0x1000) != 0) && ((Cpuid7[1] & 0x20) != 0)) {
         this->GemmFloatKernel = MlasGemmFloatKernelFma3;
         this->ConvNchwFloatKernel = MlasConvNchwFloatKernelFma3;
+        this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelFma3;
+        this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelFma3;
+        this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelFma3;
+        this->ActivationFloatKernel = MlasActivationFloatKernelFma3;
+        this->ComputeExpF32Kernel = MlasComputeExpF32KernelFma3;
+        this->TanhKernelRoutine = MlasComputeTanhF32KernelFma3;
+        this->LogisticKernelRoutine = MlasComputeLogisticF32KernelFma3;
+        this->ErfKernelRoutine = MlasErfKernelFma3;
+        this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+        this->ComputeSoftmaxOutputF32Kernel = MlasComputeSoftmaxOutputF32KernelFma3;
+        this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32KernelFma3;
 
         //
         // Check if the processor supports Hybrid core architecture.
@@ -0,0 +1,707 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    reorder.cpp
+
+Abstract:
+
+    This module implements routines to reorder buffers to and from blocked
+    formats.
+
+    The routines are bound by memory bandwidth, so the NCHW conversions are
+    built on the 4x4 block transposes of MlasTransposeStrided and the whole
+    tensor conversions are partitioned across the thread pool.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the minimum number of elements to reorder per work item, so that the
+// cost of dispatching to a worker thread is amortized.
+//
+
+#define MLAS_REORDER_MINIMUM_ELEMENTS_PER_THREAD 16384
+
+//
+// Define the parameters to execute segments of a reorder operation on worker
+// threads.
+//
+
+struct MLAS_REORDER_WORK_BLOCK {
+    ptrdiff_t tids;
+    const float* S;
+    float* D;
+    size_t BatchCount;
+    size_t Channels;
+    size_t SpatialSize;
+    size_t BlockSize;
+};
+
+MLAS_FORCEINLINE
+void
+MlasReorderTransposeFloat(
+    const float* S,
+    size_t InputStride,
+    float* D,
+    size_t OutputStride,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTransposeStrided(reinterpret_cast<const uint32_t*>(S), InputStride,
+        reinterpret_cast<uint32_t*>(D), OutputStride, M, N);
+}
+
+MLAS_FORCEINLINE
+void
+MlasReorderCopyFloat(
+    const float* S,
+    float* D,
+    size_t CopyCount,
+    size_t ZeroCount
+    )
+/*++
+
+Routine Description:
+
+    This routine copies a run of elements and then zero fills the elements
+    that follow up to the end of the channel block.
+
+Arguments:
+
+    S - Supplies the address of the source elements.
+
+    D - Supplies the address of the destination elements.
+
+    CopyCount - Supplies the number of elements to copy.
+
+    ZeroCount - Supplies the number of elements to zero fill.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (CopyCount >= 4) {
+
+        MlasStoreFloat32x4(D, MlasLoadFloat32x4(S));
+
+        S += 4;
+        D += 4;
+        CopyCount -= 4;
+    }
+
+    while (CopyCount > 0) {
+
+        *D++ = *S++;
+        CopyCount -= 1;
+    }
+
+    while (ZeroCount > 0) {
+
+        *D++ = 0.0f;
+        ZeroCount -= 1;
+    }
+}
+
+void
+MlasReorderPrepareWorkBlock(
+    MLAS_REORDER_WORK_BLOCK* WorkBlock,
+    const int64_t* Shape,
+    const float* S,
+    float* D,
+    size_t TotalWork,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine captures the parameters of a NCHW tensor for a reorder
+    operation and computes the number of work items to partition the
+    operation into.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the reorder parameters.
+
+    Shape - Supplies the shape of the NCHW tensor.
+
+    S - Supplies the source buffer.
+
+    D - Supplies the destination buffer.
+
+    TotalWork - Supplies the number of units of work to partition.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    WorkBlock->S = S;
+    WorkBlock->D = D;
+    WorkBlock->BatchCount = size_t(Shape[0]);
+    WorkBlock->Channels = size_t(Shape[1]);
+    WorkBlock->SpatialSize = size_t(Shape[2]) * size_t(Shape[3]);
+    WorkBlock->BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t TotalElements = WorkBlock->BatchCount *
+        MlasDivRoundup(WorkBlock->Channels, WorkBlock->BlockSize) *
+        WorkBlock->BlockSize * WorkBlock->SpatialSize;
+
+    ptrdiff_t TargetThreadCount =
+        MlasGetMaximumThreadCount(ThreadPool) * MLAS_THREADED_WORK_ITEMS_PER_THREAD;
+
+    const size_t MaximumThreadCount =
+        std::max<size_t>(TotalElements / MLAS_REORDER_MINIMUM_ELEMENTS_PER_THREAD, 1);
+
+    if (size_t(TargetThreadCount) > MaximumThreadCount) {
+        TargetThreadCount = ptrdiff_t(MaximumThreadCount);
+    }
+
+    if (size_t(TargetThreadCount) > TotalWork) {
+        TargetThreadCount = ptrdiff_t(TotalWork);
+    }
+
+    WorkBlock->tids = TargetThreadCount;
+}
+
+void
+MlasReorderInputNchwThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NCHW to NCHWc reorder operation. The work is partitioned over the spatial
+    positions of each block of channels.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_REORDER_WORK_BLOCK*)Context;
+
+    const size_t BlockSize = WorkBlock->BlockSize;
+    const size_t InputChannels = WorkBlock->Channels;
+    const size_t InputSize = WorkBlock->SpatialSize;
+    const size_t ChannelBlocks = MlasDivRoundup(InputChannels, BlockSize);
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->tids, WorkBlock->BatchCount * ChannelBlocks * InputSize,
+        &WorkIndex, &WorkRemaining);
+
+    while (WorkRemaining > 0) {
+
+        const size_t Plane = WorkIndex / InputSize;
+        const size_t SpatialIndex = WorkIndex % InputSize;
+        const size_t SpatialCount = std::min(WorkRemaining, InputSize - SpatialIndex);
+
+        const size_t Batch = Plane / ChannelBlocks;
+        const size_t Channel = (Plane % ChannelBlocks) * BlockSize;
+        const size_t ChannelCount = std::min(InputChannels - Channel, BlockSize);
+
+        const float* s = WorkBlock->S + (Batch * InputChannels + Channel) * InputSize + SpatialIndex;
+        float* d = WorkBlock->D + (Plane * InputSize + SpatialIndex) * BlockSize;
+
+        MlasReorderTransposeFloat(s, InputSize, d, BlockSize, ChannelCount, SpatialCount);
+
+        //
+        // Zero fill the channels beyond the end of a partial channel block.
+        //
+
+        if (ChannelCount < BlockSize) {
+
+            for (size_t n = 0; n < SpatialCount; n++) {
+                std::fill_n(d + n * BlockSize + ChannelCount, BlockSize - ChannelCount, 0.0f);
+            }
+        }
+
+        WorkIndex += SpatialCount;
+        WorkRemaining -= SpatialCount;
+    }
+}
+
+void
+MLASCALL
+MlasReorderInputNchw(
+    const int64_t* InputShape,
+    const float* S,
+    float* D,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders an input buffer from NCHW to NCHWc format.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor (NCHW). The channel
+        count of the output buffer is padded to the block size and the padding
+        channels are zero filled.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_REORDER_WORK_BLOCK WorkBlock;
+
+    const size_t TotalWork = size_t(InputShape[0]) *
+        MlasDivRoundup(size_t(InputShape[1]), MlasNchwcGetBlockSize()) *
+        size_t(InputShape[2]) * size_t(InputShape[3]);
+
+    MlasReorderPrepareWorkBlock(&WorkBlock, InputShape, S, D, TotalWork, ThreadPool);
+
+    if (WorkBlock.tids == 0) {
+        return;
+    }
+
+    MlasExecuteThreaded(MlasReorderInputNchwThreaded, &WorkBlock, WorkBlock.tids, ThreadPool);
+}
+
+void
+MLASCALL
+MlasReorderInputNhwc(
+    const float* S,
+    float* D,
+    size_t InputChannels,
+    size_t RowCount,
+    size_t FullRowCount
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders a segment of an input buffer from NHWC to NCHWc
+    format. The caller partitions the spatial positions of the input tensor
+    into segments, so this routine does no threading of its own.
+
+Arguments:
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+    InputChannels - Supplies the number of NHWC channels.
+
+    RowCount - Supplies the number of NHWC rows (spatial positions) to
+        process.
+
+    FullRowCount - Supplies the total number of NHWC rows in the tensor,
+        which is the distance between channel blocks of the destination
+        buffer.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    //
+    // Process each row in turn, so that the source buffer is read
+    // sequentially and each block of channels is written sequentially.
+    //
+
+    for (size_t row = 0; row < RowCount; row++) {
+
+        float* d = D;
+
+        for (size_t c = 0; c < InputChannels; c += BlockSize) {
+
+            const size_t ChannelCount = std::min(InputChannels - c, BlockSize);
+
+            MlasReorderCopyFloat(S + c, d, ChannelCount, BlockSize - ChannelCount);
+
+            d += FullRowCount * BlockSize;
+        }
+
+        S += InputChannels;
+        D += BlockSize;
+    }
+}
+
+void
+MlasReorderOutputNchwThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NCHWc to NCHW reorder operation. The work is partitioned over the spatial
+    positions of each block of channels.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_REORDER_WORK_BLOCK*)Context;
+
+    const size_t BlockSize = WorkBlock->BlockSize;
+    const size_t OutputChannels = WorkBlock->Channels;
+    const size_t OutputSize = WorkBlock->SpatialSize;
+    const size_t ChannelBlocks = MlasDivRoundup(OutputChannels, BlockSize);
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->tids, WorkBlock->BatchCount * ChannelBlocks * OutputSize,
+        &WorkIndex, &WorkRemaining);
+
+    while (WorkRemaining > 0) {
+
+        const size_t Plane = WorkIndex / OutputSize;
+        const size_t SpatialIndex = WorkIndex % OutputSize;
+        const size_t SpatialCount = std::min(WorkRemaining, OutputSize - SpatialIndex);
+
+        const size_t Batch = Plane / ChannelBlocks;
+        const size_t Channel = (Plane % ChannelBlocks) * BlockSize;
+        const size_t ChannelCount = std::min(OutputChannels - Channel, BlockSize);
+
+        const float* s = WorkBlock->S + (Plane * OutputSize + SpatialIndex) * BlockSize;
+        float* d = WorkBlock->D + (Batch * OutputChannels + Channel) * OutputSize + SpatialIndex;
+
+        MlasReorderTransposeFloat(s, BlockSize, d, OutputSize, SpatialCount, ChannelCount);
+
+        WorkIndex += SpatialCount;
+        WorkRemaining -= SpatialCount;
+    }
+}
+
+void
+MLASCALL
+MlasReorderOutputNchw(
+    const int64_t* OutputShape,
+    const float* S,
+    float* D,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders an output buffer from NCHWc to NCHW format.
+
+Arguments:
+
+    OutputShape - Supplies the shape of the output tensor (NCHW). The channel
+        count of the source buffer is padded to the block size.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_REORDER_WORK_BLOCK WorkBlock;
+
+    const size_t TotalWork = size_t(OutputShape[0]) *
+        MlasDivRoundup(size_t(OutputShape[1]), MlasNchwcGetBlockSize()) *
+        size_t(OutputShape[2]) * size_t(OutputShape[3]);
+
+    MlasReorderPrepareWorkBlock(&WorkBlock, OutputShape, S, D, TotalWork, ThreadPool);
+
+    if (WorkBlock.tids == 0) {
+        return;
+    }
+
+    MlasExecuteThreaded(MlasReorderOutputNchwThreaded, &WorkBlock, WorkBlock.tids, ThreadPool);
+}
+
+void
+MlasReorderOutputNhwcThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NCHWc to NHWC reorder operation. The work is partitioned over the spatial
+    positions of the batches.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_REORDER_WORK_BLOCK*)Context;
+
+    const size_t BlockSize = WorkBlock->BlockSize;
+    const size_t OutputChannels = WorkBlock->Channels;
+    const size_t OutputSize = WorkBlock->SpatialSize;
+    const size_t ChannelBlocks = MlasDivRoundup(OutputChannels, BlockSize);
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->tids, WorkBlock->BatchCount * OutputSize,
+        &WorkIndex, &WorkRemaining);
+
+    while (WorkRemaining > 0) {
+
+        const size_t Batch = WorkIndex / OutputSize;
+        const size_t SpatialIndex = WorkIndex % OutputSize;
+        const size_t SpatialCount = std::min(WorkRemaining, OutputSize - SpatialIndex);
+
+        const float* S = WorkBlock->S + (Batch * ChannelBlocks * OutputSize + SpatialIndex) * BlockSize;
+        float* D = WorkBlock->D + (Batch * OutputSize + SpatialIndex) * OutputChannels;
+
+        //
+        // Gather the channel blocks of each spatial position into a
+        // contiguous row of the destination buffer.
+        //
+
+        for (size_t n = 0; n < SpatialCount; n++) {
+
+            const float* s = S;
+            float* d = D;
+
+            for (size_t c = 0; c < OutputChannels; c += BlockSize) {
+
+                MlasReorderCopyFloat(s, d, std::min(OutputChannels - c, BlockSize), 0);
+
+                s += OutputSize * BlockSize;
+                d += BlockSize;
+            }
+
+            S += BlockSize;
+            D += OutputChannels;
+        }
+
+        WorkIndex += SpatialCount;
+        WorkRemaining -= SpatialCount;
+    }
+}
+
+void
+MLASCALL
+MlasReorderOutputNhwc(
+    const int64_t* OutputShape,
+    const float* S,
+    float* D,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders an output buffer from NCHWc to NHWC format.
+
+Arguments:
+
+    OutputShape - Supplies the shape of the output tensor (NCHW). The channel
+        count of the source buffer is padded to the block size.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_REORDER_WORK_BLOCK WorkBlock;
+
+    const size_t TotalWork = size_t(OutputShape[0]) * size_t(OutputShape[2]) * size_t(OutputShape[3]);
+
+    MlasReorderPrepareWorkBlock(&WorkBlock, OutputShape, S, D, TotalWork, ThreadPool);
+
+    if (WorkBlock.tids == 0) {
+        return;
+    }
+
+    MlasExecuteThreaded(MlasReorderOutputNhwcThreaded, &WorkBlock, WorkBlock.tids, ThreadPool);
+}
+
+void
+MLASCALL
+MlasReorderFilterOIHWBiBo(
+    const int64_t* FilterShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders a filter buffer from OIHW to OIHWBiBo format, the
+    format used by the NCHWc convolution when the input is in NCHWc format.
+
+Arguments:
+
+    FilterShape - Supplies the shape of the filter tensor (OIHW). The output
+        and input channel counts of the destination buffer are padded to the
+        block size and the padding channels are zero filled.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t OutputChannels = size_t(FilterShape[0]);
+    const size_t InputChannels = size_t(FilterShape[1]);
+    const size_t KernelSize = size_t(FilterShape[2]) * size_t(FilterShape[3]);
+
+    const size_t InputChannelBlocks = MlasDivRoundup(InputChannels, BlockSize);
+    const size_t OutputChannelBlocks = MlasDivRoundup(OutputChannels, BlockSize);
+
+    //
+    // Zero fill the destination buffer if either channel count is not a
+    // multiple of the block size, so that the padding channels are cleared.
+    //
+
+    if ((OutputChannels % BlockSize) != 0 || (InputChannels % BlockSize) != 0) {
+        std::fill_n(D, OutputChannelBlocks * InputChannelBlocks * KernelSize * BlockSize * BlockSize, 0.0f);
+    }
+
+    for (size_t o = 0; o < OutputChannels; o += BlockSize) {
+
+        const size_t OutputCount = std::min(OutputChannels - o, BlockSize);
+
+        for (size_t i = 0; i < InputChannels; i++) {
+
+            //
+            // Transpose the kernel elements of the block of output channels
+            // for this input channel, so that each kernel position becomes a
+            // vector of output channels.
+            //
+
+            const float* s = S + (o * InputChannels + i) * KernelSize;
+            float* d = D + (((o / BlockSize) * InputChannelBlocks + (i / BlockSize)) * KernelSize * BlockSize +
+                (i % BlockSize)) * BlockSize;
+
+            MlasReorderTransposeFloat(s, InputChannels * KernelSize, d, BlockSize * BlockSize,
+                OutputCount, KernelSize);
+        }
+    }
+}
+
+void
+MLASCALL
+MlasReorderFilterOIHWBo(
+    const int64_t* FilterShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders a filter buffer from OIHW to OIHWBo format, the
+    format used by the NCHWc convolution when the input is in NCHW format and
+    by the depthwise convolution.
+
+Arguments:
+
+    FilterShape - Supplies the shape of the filter tensor (OIHW). The output
+        channel count of the destination buffer is padded to the block size
+        and the padding channels are zero filled.
+
+    S - Supplies the address of the source tensor.
+
+    D - Supplies the address of the destination tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t OutputChannels = size_t(FilterShape[0]);
+    const size_t InputSize = size_t(FilterShape[1]) * size_t(FilterShape[2]) * size_t(FilterShape[3]);
+
+    for (size_t o = 0; o < OutputChannels; o += BlockSize) {
+
+        const size_t OutputCount = std::min(OutputChannels - o, BlockSize);
+
+        float* d = D + o * InputSize;
+
+        //
+        // Zero fill the destination block if the block of output channels is
+        // partial, so that the padding channels are cleared.
+        //
+
+        if (OutputCount < BlockSize) {
+            std::fill_n(d, InputSize * BlockSize, 0.0f);
+        }
+
+        MlasReorderTransposeFloat(S + o * InputSize, InputSize, d, BlockSize, OutputCount, InputSize);
+    }
+}
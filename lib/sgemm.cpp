@@ -474,19 +474,27 @@ Return Value:
 
 #if defined(MLAS_TARGET_AMD64)
 
+        //
+        // Use the assembly routine if the platform provides one, else fall
+        // back to the intrinsics implementation below.
+        //
+
         MLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE* SgemmTransposePackB16x4Routine =
             GetMlasPlatform().TransposePackB16x4Routine;
 
-        while (x >= 4) {
+        if (SgemmTransposePackB16x4Routine != nullptr) {
 
-            SgemmTransposePackB16x4Routine(&D[0], &b[0], ldb);
+            while (x >= 4) {
 
-            D += 16 * 4;
-            b += 4;
-            x -= 4;
+                SgemmTransposePackB16x4Routine(&D[0], &b[0], ldb);
+
+                D += 16 * 4;
+                b += 4;
+                x -= 4;
+            }
         }
 
-#else
+#endif
 
         while (x >= 4) {
 
@@ -497,8 +505,6 @@ Return Value:
             x -= 4;
         }
 
-#endif
-
         while (x > 0) {
 
             float t0 = b[0];
@@ -1003,6 +1009,123 @@ Return Value:
 
 #endif
 
+void
+MlasSgemmApplyEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    float* C,
+    size_t ldc,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the epilogue of a SGEMM operation to a block of the
+    output matrix.
+
+    The residual matrix and a per column bias vector are added first. A per
+    row bias vector is added by the activation routine in the same pass as
+    the activation.
+
+Arguments:
+
+    Epilogue - Supplies the epilogue.
+
+    C - Supplies the address of the block of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    StartM - Supplies the row of the epilogue that corresponds to the first
+        row of the block.
+
+    StartN - Supplies the column of the epilogue that corresponds to the
+        first column of the block.
+
+    CountM - Supplies the number of rows of the block.
+
+    CountN - Supplies the number of columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* ColumnBias = nullptr;
+    const float* RowBias = nullptr;
+
+    if (Epilogue->Bias != nullptr) {
+        if (Epilogue->BiasKind == MlasSgemmBiasPerColumn) {
+            ColumnBias = Epilogue->Bias + StartN;
+        } else {
+            RowBias = Epilogue->Bias + StartM;
+        }
+    }
+
+    const float* Residual = nullptr;
+
+    if (Epilogue->Residual != nullptr) {
+        Residual = Epilogue->Residual + StartM * Epilogue->ldr + StartN;
+    }
+
+    if (ColumnBias != nullptr || Residual != nullptr) {
+
+        float* c = C;
+
+        for (size_t m = 0; m < CountM; m++) {
+
+            size_t n = 0;
+
+            while (n + 4 <= CountN) {
+
+                MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(&c[n]);
+
+                if (ColumnBias != nullptr) {
+                    Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(&ColumnBias[n]));
+                }
+
+                if (Residual != nullptr) {
+                    Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(&Residual[n]));
+                }
+
+                MlasStoreFloat32x4(&c[n], Vector);
+
+                n += 4;
+            }
+
+            while (n < CountN) {
+
+                if (ColumnBias != nullptr) {
+                    c[n] += ColumnBias[n];
+                }
+
+                if (Residual != nullptr) {
+                    c[n] += Residual[n];
+                }
+
+                n += 1;
+            }
+
+            if (Residual != nullptr) {
+                Residual += Epilogue->ldr;
+            }
+
+            c += ldc;
+        }
+    }
+
+    if (Epilogue->Activation != nullptr) {
+        MlasActivation(Epilogue->Activation, C, RowBias, CountM, CountN, ldc);
+    } else if (RowBias != nullptr) {
+        MLAS_ACTIVATION IdentityActivation;
+        IdentityActivation.ActivationKind = MlasIdentityActivation;
+        MlasActivation(&IdentityActivation, C, RowBias, CountM, CountN, ldc);
+    }
+}
+
 MLAS_FORCEINLINE
 float*
 MlasSgemmKernelLoop(
@@ -1015,7 +1138,10 @@ MlasSgemmKernelLoop(
     size_t lda,
     size_t ldc,
     float alpha,
-    bool ZeroMode
+    bool ZeroMode,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    size_t StartM,
+    size_t StartN
     )
 /*++
 
@@ -1024,6 +1150,10 @@ Routine Description:
     This routine steps through the rows of the input and output matrices calling
     the kernel until all rows have been processed.
 
+    If this is the last slice along the K dimension, the epilogue is applied
+    to the rows of the output matrix computed by each kernel call while the
+    rows are still in the cache.
+
 Arguments:
 
     A - Supplies the address of matrix A.
@@ -1051,6 +1181,14 @@ Arguments:
     ZeroMode - Supplies true if the output matrix must be zero initialized,
         else false if the output matrix is accumulated into.
 
+    Epilogue - Optionally supplies the epilogue to apply to the output matrix.
+
+    StartM - Supplies the row of the epilogue that corresponds to the first
+        row of matrix C.
+
+    StartN - Supplies the column of the epilogue that corresponds to the
+        first column of matrix C.
+
 Return Value:
 
     Returns the next address of matrix C.
@@ -1071,6 +1209,11 @@ Return Value:
         }
 #endif
 
+        if (Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C, ldc, StartM, StartN, RowsHandled, CountN);
+            StartM += RowsHandled;
+        }
+
         C += ldc * RowsHandled;
         A += lda * RowsHandled;
         CountM -= RowsHandled;
@@ -1093,7 +1236,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
     )
 /*++
 
@@ -1131,6 +1275,9 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Optionally supplies the operations to apply to matrix C after
+        the multiply.
+
 Return Value:
 
     None.
@@ -1147,6 +1294,9 @@ Return Value:
 
     if (K == 0) {
         MlasSgemmMultiplyBeta(C, M, N, ldc, beta);
+        if (Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C, ldc, 0, 0, M, N);
+        }
         return;
     }
 
@@ -1170,6 +1320,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, ldc, 0, 0, 1, N);
+            }
             return;
         }
 
@@ -1177,6 +1330,9 @@ Return Value:
 
         if (TransB == CblasNoTrans) {
             MlasGemvFloatKernel(A, B, C, K, N, ldb, (beta == 0.0f));
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, ldc, 0, 0, 1, N);
+            }
             return;
         }
 
@@ -1205,6 +1361,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(B, A, C, K, M, lda, beta);
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, ldc, 0, 0, M, 1);
+            }
             return;
         }
 
@@ -1283,9 +1442,12 @@ Return Value:
 
             float* c = C + n;
 
+            const MLAS_SGEMM_EPILOGUE* SliceEpilogue = (k + CountK == K) ? Epilogue : nullptr;
+
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SliceEpilogue, 0, n);
 
             } else {
 
@@ -1309,7 +1471,8 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SliceEpilogue, M - RowsRemaining - RowsTransposed, n);
                 }
             }
 
@@ -1332,7 +1495,8 @@ MlasSgemmPackedOperation(
     size_t AlignedN,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
     )
 /*++
 
@@ -1372,6 +1536,9 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Optionally supplies the operations to apply to matrix C after
+        the multiply.
+
 Return Value:
 
     None.
@@ -1418,9 +1585,12 @@ Return Value:
             const float* pb = (const float*)PackedB + AlignedN * k + CountK * SliceStartN;
             float* c = C + n;
 
+            const MLAS_SGEMM_EPILOGUE* SliceEpilogue = (k + CountK == K) ? Epilogue : nullptr;
+
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SliceEpilogue, 0, n);
 
             } else {
 
@@ -1444,7 +1614,8 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SliceEpilogue, M - RowsRemaining - RowsTransposed, n);
                 }
             }
 
@@ -1454,179 +1625,552 @@ Return Value:
 }
 
 void
-MlasSgemmThreaded(
-    const ptrdiff_t ThreadCountM,
-    const ptrdiff_t ThreadCountN,
-    const CBLAS_TRANSPOSE TransA,
-    const CBLAS_TRANSPOSE TransB,
-    const size_t M,
-    const size_t N,
-    const size_t K,
-
-    const MLAS_SGEMM_DATA_PARAMS* DataParams,
-    ptrdiff_t ThreadId
+MlasSgemmPackedAOperation(
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* PackedA,
+    size_t PackedM,
+    size_t StartM,
+    const float* B,
+    size_t ldb,
+    bool BIsPacked,
+    size_t RangeStartN,
+    size_t AlignedN,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
     )
 /*++
 
 Routine Description:
 
-    This routine is invoked from a worker thread to execute a segment of a
-    SGEMM operation.
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) for a range of rows of matrix A that has been packed
+    using MlasGemmPackA.
+
+    Packed matrix A is stored as slices of MLAS_SGEMM_PACKED_STRIDEK columns,
+    where each slice holds all rows of the slice contiguously. The operation
+    steps along the K dimension in the same slices, so each slice of matrix A
+    is passed to the kernel without copying.
 
 Arguments:
 
-    ThreadCountM - Supplies the total thread partition on the M dimension.
+    TransB - Supplies the transpose operation for matrix B if matrix B is not
+        packed.
 
-    ThreadCountN - Supplies the total thread partition on the N dimension.
+    M - Supplies the number of rows of the range of matrix A and matrix C.
 
-    TransA - Supplies the transpose operation on A matrix
+    N - Supplies the number of columns of matrix B and matrix C.
 
-    TransB - Supplies the transpose operation on B matrix
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
 
-    M, N, K - Supplies the shape of the multiplication
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
 
-    DataParams - Supplies the data position and layout of the matrices
+    PackedA - Supplies the address of packed matrix A.
 
-    ThreadId - Supplies the current index of the threaded operation.
+    PackedM - Supplies the total number of rows of packed matrix A.
 
-Return Value:
+    StartM - Supplies the first row of the range of packed matrix A.
 
-    None.
+    B - Supplies the address of matrix B, or of packed matrix B.
 
---*/
-{
+    ldb - Supplies the first dimension of matrix B if matrix B is not packed.
 
-    const ptrdiff_t ThreadIdM = ThreadId / ThreadCountN;
-    const ptrdiff_t ThreadIdN = ThreadId % ThreadCountN;
+    BIsPacked - Supplies true if matrix B has been packed using
+        MlasGemmPackB.
 
-    //
-    // Partition the operation along the M dimension.
-    //
+    RangeStartN - Supplies the starting column from packed matrix B.
 
-    size_t RangeStartM;
-    size_t RangeCountM;
+    AlignedN - Supplies the total number of aligned columns for packed
+        matrix B.
 
-    MlasPartitionWork(ThreadIdM, ThreadCountM, M, &RangeStartM, &RangeCountM);
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
-    //
-    // Partition the operation along the N dimension.
-    //
+    C - Supplies the address of matrix C.
 
-    size_t RangeStartN;
-    size_t RangeCountN;
+    ldc - Supplies the first dimension of matrix C.
 
-    const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
-        MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    Epilogue - Optionally supplies the operations to apply to matrix C after
+        the multiply.
 
-    MlasPartitionWork(ThreadIdN, ThreadCountN, BlockedN, &RangeStartN,
-        &RangeCountN);
+Return Value:
 
-    RangeStartN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
-    RangeCountN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    None.
 
-    RangeCountN = std::min(N - RangeStartN, RangeCountN);
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
+
+    if (K == 0) {
+        MlasSgemmMultiplyBeta(C, M, N, ldc, beta);
+        if (Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C, ldc, 0, 0, M, N);
+        }
+        return;
+    }
 
     //
-    // Dispatch the partitioned operation.
+    // Compute the stride to step through slices of matrix B along the N
+    // dimension. The K stride is fixed by the layout of packed matrix A, so
+    // the N stride is sized for the local packed buffer to hold a panel of
+    // matrix B.
     //
 
-    const size_t lda = DataParams->lda;
-    const size_t ldc = DataParams->ldc;
-
-    const float* A = DataParams->A + RangeStartM * ((TransA == CblasNoTrans) ? lda : 1);
-    float* C = DataParams->C + RangeStartM * ldc + RangeStartN;
-
-    if (DataParams->BIsPacked) {
-
-        MlasSgemmPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
-            K, DataParams->alpha, A, lda, DataParams->B,
-            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc);
+    size_t StrideN = MLAS_SGEMM_PACKED_STRIDEN;
 
-    } else {
+    if (!BIsPacked) {
 
-        const size_t ldb = DataParams->ldb;
+        const size_t StrideK = std::min(K, size_t(MLAS_SGEMM_PACKED_STRIDEK));
 
-        const float* B = (const float*)DataParams->B + RangeStartN * ((TransB == CblasNoTrans) ? 1 : ldb);
+        StrideN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
 
-        MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, K,
-            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc);
+        while (StrideN * 2 * StrideK <= MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK) {
+            StrideN *= 2;
+        }
     }
-}
-#if defined(_MSC_VER) && !defined(__clang__)
-#pragma warning(push)
-// Chance of arithmetic overflow could be reduced
-#pragma warning(disable : 26451)
-#endif
-void
-MLASCALL
-MlasGemmBatch(
-    CBLAS_TRANSPOSE TransA,
-    CBLAS_TRANSPOSE TransB,
-    size_t M,
-    size_t N,
-    size_t K,
-    const MLAS_SGEMM_DATA_PARAMS* Data,
-    size_t BatchSize,
-    MLAS_THREADPOOL* ThreadPool
-    )
-{
 
     //
-    // Compute the number of target threads given the complexity of the SGEMM
-    // operation. Small requests should run using the single threaded path.
+    // Step through each slice of matrix B along the N dimension.
     //
 
-    const double Complexity = double(M) * double(N) * double(K);
+    size_t CountN;
 
-    ptrdiff_t TargetThreadCount;
+    for (size_t n = 0; n < N; n += CountN) {
 
-    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
-        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
-    } else {
-        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
-    }
+        CountN = std::min(N - n, StrideN);
 
-    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+        //
+        // Multiply the output matrix by beta as needed.
+        //
 
-    if (TargetThreadCount >= MaximumThreadCount) {
-        TargetThreadCount = MaximumThreadCount;
-    }
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
 
-    //
-    // Segment the operation across multiple threads.
-    //
-    // N.B. Currently, the operation is segmented as a 1D partition, which
-    // works okay for operations involving skinny matrices.
-    //
+        //
+        // Step through each slice of matrix A and matrix B along the K
+        // dimension.
+        //
 
-    ptrdiff_t ThreadsPerGemm = (TargetThreadCount + BatchSize - 1) / BatchSize;
-    ptrdiff_t ThreadCountM;
-    ptrdiff_t ThreadCountN;
+        size_t CountK;
+        bool ZeroMode = (beta == 0.0f);
 
-    if (N > M) {
+        for (size_t k = 0; k < K; k += CountK) {
 
-        const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
-            MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+            CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
 
-        if (size_t(ThreadsPerGemm) > BlockedN) {
-            ThreadsPerGemm = ptrdiff_t(BlockedN);
-        }
+            const float* pb;
 
-        ThreadCountM = 1;
-        ThreadCountN = ThreadsPerGemm;
+            if (BIsPacked) {
 
-    } else {
+                pb = B + AlignedN * k + CountK * (RangeStartN + n);
 
-        if (size_t(ThreadsPerGemm) > M) {
-            ThreadsPerGemm = ptrdiff_t(M);
-        }
+            } else {
+
+                if (TransB == CblasNoTrans) {
+                    MlasSgemmCopyPackB(PanelB, B + n + k * ldb, ldb, CountN, CountK);
+                } else {
+                    MlasSgemmTransposePackB(PanelB, B + k + n * ldb, ldb, CountN, CountK);
+                }
+
+                pb = PanelB;
+            }
+
+            const float* pa = PackedA + PackedM * k + StartM * CountK;
+            const MLAS_SGEMM_EPILOGUE* SliceEpilogue = (k + CountK == K) ? Epilogue : nullptr;
 
-        ThreadCountM = ThreadsPerGemm;
-        ThreadCountN = 1;
+            MlasSgemmKernelLoop(pa, pb, C + n, CountK, M, CountN, CountK, ldc, alpha, ZeroMode,
+                SliceEpilogue, 0, n);
+
+            ZeroMode = false;
+        }
     }
+}
 
-    MlasTrySimpleParallel(ThreadPool,
-        ThreadsPerGemm * static_cast<ptrdiff_t>(BatchSize),
+//
+// Define the alignment of each copy of a replicated packed B buffer, so that
+// each copy can be placed on the pages of a NUMA node.
+//
+
+#define MLAS_SGEMM_PACKB_REPLICA_ALIGNMENT 4096
+
+size_t
+MlasSgemmPackBReplicaStride(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the distance in bytes between the copies of a
+    replicated packed B buffer.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the distance in bytes between the copies.
+
+--*/
+{
+    return (MlasGemmPackBSize(N, K) + MLAS_SGEMM_PACKB_REPLICA_ALIGNMENT - 1) &
+        ~size_t(MLAS_SGEMM_PACKB_REPLICA_ALIGNMENT - 1);
+}
+
+const void*
+MlasSgemmGetPackBReplica(
+    const void* PackedB,
+    size_t N,
+    size_t K,
+    size_t NumaNode
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the copy of a replicated packed B buffer for a NUMA
+    node.
+
+Arguments:
+
+    PackedB - Supplies the address of the replicated packed B buffer.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    NumaNode - Supplies the index of the NUMA node.
+
+Return Value:
+
+    Returns the address of the copy.
+
+--*/
+{
+    const uintptr_t Replicas = (uintptr_t(PackedB) + MLAS_SGEMM_PACKB_REPLICA_ALIGNMENT - 1) &
+        ~uintptr_t(MLAS_SGEMM_PACKB_REPLICA_ALIGNMENT - 1);
+
+    return reinterpret_cast<const void*>(Replicas + NumaNode * MlasSgemmPackBReplicaStride(N, K));
+}
+
+void
+MlasSgemmThreaded(
+    const ptrdiff_t ThreadCountM,
+    const ptrdiff_t ThreadCountN,
+    const CBLAS_TRANSPOSE TransA,
+    const CBLAS_TRANSPOSE TransB,
+    const size_t M,
+    const size_t N,
+    const size_t K,
+
+    const MLAS_SGEMM_DATA_PARAMS* DataParams,
+    ptrdiff_t ThreadId
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    SGEMM operation.
+
+Arguments:
+
+    ThreadCountM - Supplies the total thread partition on the M dimension.
+
+    ThreadCountN - Supplies the total thread partition on the N dimension.
+
+    TransA - Supplies the transpose operation on A matrix
+
+    TransB - Supplies the transpose operation on B matrix
+
+    M, N, K - Supplies the shape of the multiplication
+
+    DataParams - Supplies the data position and layout of the matrices
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+
+    const ptrdiff_t ThreadIdM = ThreadId / ThreadCountN;
+    const ptrdiff_t ThreadIdN = ThreadId % ThreadCountN;
+
+    //
+    // Partition the operation along the M dimension.
+    //
+
+    size_t RangeStartM;
+    size_t RangeCountM;
+
+    MlasPartitionWork(ThreadIdM, ThreadCountM, M, &RangeStartM, &RangeCountM);
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    size_t RangeStartN;
+    size_t RangeCountN;
+
+    const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    MlasPartitionWork(ThreadIdN, ThreadCountN, BlockedN, &RangeStartN,
+        &RangeCountN);
+
+    RangeStartN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    RangeCountN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    RangeCountN = std::min(N - RangeStartN, RangeCountN);
+
+    //
+    // Dispatch the partitioned operation.
+    //
+
+    const size_t lda = DataParams->lda;
+    const size_t ldc = DataParams->ldc;
+
+    const float* A = DataParams->A + RangeStartM * ((TransA == CblasNoTrans) ? lda : 1);
+    float* C = DataParams->C + RangeStartM * ldc + RangeStartN;
+
+    //
+    // Offset the epilogue to the partition of matrix C.
+    //
+
+    MLAS_SGEMM_EPILOGUE RangeEpilogue;
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr;
+
+    if (DataParams->Epilogue != nullptr) {
+
+        RangeEpilogue = *DataParams->Epilogue;
+
+        if (RangeEpilogue.Bias != nullptr) {
+            RangeEpilogue.Bias += (RangeEpilogue.BiasKind == MlasSgemmBiasPerRow) ? RangeStartM : RangeStartN;
+        }
+
+        if (RangeEpilogue.Residual != nullptr) {
+            RangeEpilogue.Residual += RangeStartM * RangeEpilogue.ldr + RangeStartN;
+        }
+
+        Epilogue = &RangeEpilogue;
+    }
+
+    //
+    // Use the copy of a replicated packed B buffer that is local to the NUMA
+    // node of this thread.
+    //
+
+    const void* PackedB = DataParams->B;
+
+    if (DataParams->BIsPacked && DataParams->BNumaPlacement == MlasNumaPlacementReplicate) {
+
+        const size_t NumaNode = std::min(size_t(MlasGetCurrentNumaNode()), MlasGetNumaNodeCount() - 1);
+
+        PackedB = MlasSgemmGetPackBReplica(PackedB, N, K, NumaNode);
+    }
+
+    if (DataParams->AIsPacked) {
+
+        const float* B = (const float*)PackedB;
+
+        if (!DataParams->BIsPacked) {
+            B += RangeStartN * ((TransB == CblasNoTrans) ? 1 : DataParams->ldb);
+        }
+
+        MlasSgemmPackedAOperation(TransB, RangeCountM, RangeCountN, K, DataParams->alpha,
+            DataParams->A, M, RangeStartM, B, DataParams->ldb, DataParams->BIsPacked,
+            RangeStartN, BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc,
+            Epilogue);
+
+    } else if (DataParams->BIsPacked) {
+
+        MlasSgemmPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
+            K, DataParams->alpha, A, lda, PackedB,
+            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc, Epilogue);
+
+    } else {
+
+        const size_t ldb = DataParams->ldb;
+
+        const float* B = (const float*)DataParams->B + RangeStartN * ((TransB == CblasNoTrans) ? 1 : ldb);
+
+        MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, K,
+            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc, Epilogue);
+    }
+}
+
+void
+MlasSgemmPartitionThreads(
+    size_t M,
+    size_t N,
+    size_t K,
+    ptrdiff_t ThreadCount,
+    ptrdiff_t* ThreadCountM,
+    ptrdiff_t* ThreadCountN
+    )
+/*++
+
+Routine Description:
+
+    This routine selects how to partition a SGEMM operation into a grid of
+    ThreadCountM by ThreadCountN segments.
+
+    A 1D partition is used if the matrix that is read by every segment fits
+    in the L2 cache. Otherwise, each segment would stream all of A or all of
+    B from memory, so the grid is chosen to minimize the total number of
+    elements of A and B read by the segments: each of the ThreadCountN
+    columns of segments reads all of A and each of the ThreadCountM rows of
+    segments reads all of B.
+
+Arguments:
+
+    M, N, K - Supplies the shape of the multiplication.
+
+    ThreadCount - Supplies the target number of segments.
+
+    ThreadCountM - Receives the number of segments along the M dimension.
+
+    ThreadCountN - Receives the number of segments along the N dimension.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    //
+    // Start from the 1D partition along the larger dimension.
+    //
+
+    size_t SharedMatrixSize;
+
+    if (N > M) {
+        *ThreadCountM = 1;
+        *ThreadCountN = std::min(ThreadCount, ptrdiff_t(BlockedN));
+        SharedMatrixSize = M * K * sizeof(float);
+    } else {
+        *ThreadCountM = std::min(ThreadCount, ptrdiff_t(M));
+        *ThreadCountN = 1;
+        SharedMatrixSize = K * N * sizeof(float);
+    }
+
+    if (ThreadCount <= 2 || SharedMatrixSize <= GetMlasPlatform().L2CacheSize) {
+        return;
+    }
+
+    //
+    // Search the grids that use at least 7/8 of the target segments. Using
+    // slightly fewer segments is cheap relative to the memory traffic saved,
+    // as each thread executes multiple segments.
+    //
+
+    double BestCost = double(*ThreadCountN) * double(M) + double(*ThreadCountM) * double(N);
+    ptrdiff_t BestSegments = *ThreadCountM * *ThreadCountN;
+
+    for (ptrdiff_t CountM = 1; CountM <= ThreadCount && size_t(CountM) <= M; CountM++) {
+
+        const ptrdiff_t CountN = std::min(ThreadCount / CountM, ptrdiff_t(BlockedN));
+        const ptrdiff_t Segments = CountM * CountN;
+
+        if (Segments * 8 < ThreadCount * 7 && Segments < BestSegments) {
+            continue;
+        }
+
+        const double Cost = double(CountN) * double(M) + double(CountM) * double(N);
+
+        if (Cost < BestCost || (Cost == BestCost && Segments > BestSegments)) {
+            BestCost = Cost;
+            BestSegments = Segments;
+            *ThreadCountM = CountM;
+            *ThreadCountN = CountN;
+        }
+    }
+}
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#pragma warning(push)
+// Chance of arithmetic overflow could be reduced
+#pragma warning(disable : 26451)
+#endif
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+
+    //
+    // Compute the number of target threads given the complexity of the SGEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K);
+
+    ptrdiff_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Generate multiple work items per thread if the operation is large
+    // enough, but keep the complexity of each work item above the threading
+    // threshold.
+    //
+
+    ptrdiff_t TargetWorkItemCount = TargetThreadCount;
+
+    if (TargetThreadCount > 1) {
+
+        TargetWorkItemCount = std::min(TargetThreadCount * MLAS_THREADED_WORK_ITEMS_PER_THREAD,
+            ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1);
+    }
+
+    //
+    // Segment the operation across multiple threads as a 2D grid.
+    //
+
+    ptrdiff_t ThreadsPerGemm = (TargetWorkItemCount + BatchSize - 1) / BatchSize;
+    ptrdiff_t ThreadCountM;
+    ptrdiff_t ThreadCountN;
+
+    MlasSgemmPartitionThreads(M, N, K, ThreadsPerGemm, &ThreadCountM, &ThreadCountN);
+
+    ThreadsPerGemm = ThreadCountM * ThreadCountN;
+
+    MlasTrySimpleParallel(ThreadPool,
+        ThreadsPerGemm * static_cast<ptrdiff_t>(BatchSize),
         [=](ptrdiff_t tid)
     {
         ptrdiff_t GemmIdx = tid / ThreadsPerGemm;
@@ -1635,9 +2179,125 @@ MlasGemmBatch(
             TransA, TransB, M, N, K, &(Data[GemmIdx]), ThreadIdx);
     });
 }
-#if defined(_MSC_VER) && !defined(__clang__)
-#pragma warning(pop)
-#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#pragma warning(pop)
+#endif
+
+#if defined(BUILD_MLAS_NO_ONNXRUNTIME)
+
+MLAS_TASK*
+MLASCALL
+MlasGemmBatchAsync(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool,
+    MLAS_TASK* Predecessor
+    )
+/*++
+
+Routine Description:
+
+    This routine starts a batch of SGEMM operations on the dispatcher thread
+    of the thread pool and returns without waiting for the operations.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    Data - Supplies the array of data parameters. The array is copied.
+
+    BatchSize - Supplies the number of multiplications in the batch.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr to
+        select the default thread pool.
+
+    Predecessor - Optionally supplies an operation that must complete before
+        this operation starts.
+
+Return Value:
+
+    Returns the handle of the operation, to be released by MlasReleaseTask.
+
+--*/
+{
+    std::vector<MLAS_SGEMM_DATA_PARAMS> DataCopy(Data, Data + BatchSize);
+
+    return MlasScheduleTask(ThreadPool, Predecessor, [=]() {
+        MlasGemmBatch(TransA, TransB, M, N, K, DataCopy.data(), BatchSize, ThreadPool);
+    });
+}
+
+#endif
+
+void
+MlasSgemmPackBBlock(
+    CBLAS_TRANSPOSE TransB,
+    const float* B,
+    size_t ldb,
+    float* PackedSliceB,
+    size_t k,
+    size_t CountK,
+    size_t n,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine packs a block of matrix B to its location in the slice of the
+    packed buffer for rows [k, k + CountK) of matrix B.
+
+    Within a slice, each group of 16 columns is stored as CountK contiguous
+    rows, so a block that starts at a multiple of 16 columns is packed to an
+    offset of n * CountK elements.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedSliceB - Supplies the address of the slice of packed matrix B.
+
+    k - Supplies the first row of the slice.
+
+    CountK - Supplies the number of rows of the slice.
+
+    n - Supplies the first column of the block, which must be a multiple of
+        MLAS_SGEMM_STRIDEN_THREAD_ALIGN.
+
+    CountN - Supplies the number of columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float* D = PackedSliceB + n * CountK;
+
+    if (TransB == CblasNoTrans) {
+        MlasSgemmCopyPackB(D, B + k * ldb + n, ldb, CountN, CountK);
+    } else {
+        MlasSgemmTransposePackB(D, B + n * ldb + k, ldb, CountN, CountK);
+    }
+}
 
 size_t
 MLASCALL
@@ -1730,12 +2390,324 @@ Return Value:
 
         CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
 
-        if (TransB == CblasNoTrans) {
-            MlasSgemmCopyPackB((float*)PackedB, B + k * ldb, ldb, N, CountK);
+        MlasSgemmPackBBlock(TransB, B, ldb, (float*)PackedB + AlignedN * k, k, CountK, 0, N);
+    }
+}
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the contents of matrix B to the destination buffer
+    using the thread pool. The packed buffer is identical to the buffer
+    produced by the single threaded routine.
+
+    The operation is divided into blocks of a slice of matrix B along the K
+    dimension and a range of columns along the N dimension. Each block is
+    packed independently to its final location.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of packed matrix B.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedN =
+        (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+    //
+    // Compute the number of blocks given the size of matrix B. Small matrices
+    // are packed on the calling thread.
+    //
+
+    const double Complexity = double(N) * double(K);
+
+    const ptrdiff_t TargetWorkItemCount = std::min(
+        MlasGetMaximumThreadCount(ThreadPool) * MLAS_THREADED_WORK_ITEMS_PER_THREAD,
+        ptrdiff_t(Complexity / double(MLAS_SGEMM_PACKB_THREAD_COMPLEXITY)) + 1);
+
+    if (TargetWorkItemCount <= 1) {
+        MlasGemmPackB(TransB, N, K, B, ldb, PackedB);
+        return;
+    }
+
+    //
+    // Divide the slices along the K dimension first, then divide the columns
+    // of each slice in units of the packed column width.
+    //
+
+    const size_t SliceCountK = (K + MLAS_SGEMM_PACKED_STRIDEK - 1) / MLAS_SGEMM_PACKED_STRIDEK;
+    const size_t ColumnBlockCount = AlignedN / MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    size_t BlockCountN = (size_t(TargetWorkItemCount) + SliceCountK - 1) / SliceCountK;
+
+    if (BlockCountN > ColumnBlockCount) {
+        BlockCountN = ColumnBlockCount;
+    }
+
+    const size_t StrideN = ((ColumnBlockCount + BlockCountN - 1) / BlockCountN) * MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    BlockCountN = (N + StrideN - 1) / StrideN;
+
+    MlasTrySimpleParallel(ThreadPool, ptrdiff_t(SliceCountK * BlockCountN), [&](ptrdiff_t tid) {
+
+        const size_t k = size_t(tid) / BlockCountN * MLAS_SGEMM_PACKED_STRIDEK;
+        const size_t CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
+
+        const size_t n = size_t(tid) % BlockCountN * StrideN;
+        const size_t CountN = std::min(N - n, StrideN);
+
+        MlasSgemmPackBBlock(TransB, B, ldb, (float*)PackedB + AlignedN * k, k, CountK, n, CountN);
+    });
+}
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K,
+    MLAS_NUMA_PLACEMENT Placement
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the packed matrix B buffer
+    with the specified NUMA placement.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    Placement - Supplies the NUMA placement of the buffer.
+
+Return Value:
+
+    Returns the size in bytes for the packed matrix B buffer.
+
+--*/
+{
+    if (Placement != MlasNumaPlacementReplicate) {
+        return MlasGemmPackBSize(N, K);
+    }
+
+    //
+    // Reserve space to align the first copy to the replica alignment.
+    //
+
+    return MlasGetNumaNodeCount() * MlasSgemmPackBReplicaStride(N, K) +
+        MLAS_SGEMM_PACKB_REPLICA_ALIGNMENT;
+}
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB,
+    MLAS_NUMA_PLACEMENT Placement,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the contents of matrix B to the destination buffer and
+    places the buffer on the memory of the NUMA nodes. The destination buffer
+    should be sized based on MlasGemmPackBSize() with the same placement.
+
+    The memory policy of the pages is set before the pages are written, so
+    pages that are not yet present are allocated on the intended node and
+    pages that are already present are migrated.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of packed matrix B.
+
+    Placement - Supplies the NUMA placement of the buffer.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Placement == MlasNumaPlacementDefault) {
+        MlasGemmPackB(TransB, N, K, B, ldb, PackedB, ThreadPool);
+        return;
+    }
+
+    if (Placement == MlasNumaPlacementInterleave) {
+        MlasBindMemoryToNumaNode(PackedB, MlasGemmPackBSize(N, K), -1);
+        MlasGemmPackB(TransB, N, K, B, ldb, PackedB, ThreadPool);
+        return;
+    }
+
+    //
+    // Pack the first copy and duplicate it to the copies of the other nodes.
+    //
+
+    const size_t NumaNodeCount = MlasGetNumaNodeCount();
+    const size_t ReplicaStride = MlasSgemmPackBReplicaStride(N, K);
+
+    for (size_t NumaNode = 0; NumaNode < NumaNodeCount; NumaNode++) {
+
+        void* Replica = const_cast<void*>(MlasSgemmGetPackBReplica(PackedB, N, K, NumaNode));
+
+        MlasBindMemoryToNumaNode(Replica, ReplicaStride, int32_t(NumaNode));
+
+        if (NumaNode == 0) {
+            MlasGemmPackB(TransB, N, K, B, ldb, Replica, ThreadPool);
+        } else {
+            std::copy_n(static_cast<const uint8_t*>(MlasSgemmGetPackBReplica(PackedB, N, K, 0)),
+                MlasGemmPackBSize(N, K), static_cast<uint8_t*>(Replica));
+        }
+    }
+}
+
+size_t
+MLASCALL
+MlasGemmPackASize(
+    size_t M,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the packed matrix A buffer.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A.
+
+    K - Supplies the number of columns of matrix A.
+
+Return Value:
+
+    Returns the size in bytes for the packed matrix A buffer.
+
+--*/
+{
+    const size_t BytesRequired = M * K * sizeof(float);
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+    const size_t AlignedBytesRequired = (BytesRequired + BufferAlignment - 1) &
+        ~(BufferAlignment - 1);
+
+    return AlignedBytesRequired;
+}
+
+void
+MLASCALL
+MlasGemmPackA(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t K,
+    const float* A,
+    size_t lda,
+    void* PackedA
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the contents of matrix A to the destination buffer. The
+    destination buffer should be sized based on MlasGemmPackASize().
+
+    Matrix A is stored as slices of MLAS_SGEMM_PACKED_STRIDEK columns. Each
+    slice holds the rows of the slice contiguously, so the kernels read a
+    slice of matrix A sequentially. The transpose operation is applied while
+    packing.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of op(A).
+
+    K - Supplies the number of columns of op(A).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedA - Supplies the address of packed matrix A.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float* D = (float*)PackedA;
+
+    //
+    // Step through each slice of matrix A along the K dimension.
+    //
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
+
+        if (TransA == CblasNoTrans) {
+
+            for (size_t m = 0; m < M; m++) {
+                std::copy_n(A + m * lda + k, CountK, D + m * CountK);
+            }
+
         } else {
-            MlasSgemmTransposePackB((float*)PackedB, B + k, ldb, N, CountK);
+
+            MlasSgemmTransposeA(D, A + k * lda, lda, M, CountK);
         }
 
-        PackedB = (float*)PackedB + AlignedN * CountK;
+        D += M * CountK;
     }
 }
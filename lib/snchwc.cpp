@@ -0,0 +1,1112 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    snchwc.cpp
+
+Abstract:
+
+    This module implements the single precision operations using the NCHWc
+    blocking format.
+
+    Tensors in the NCHWc format store the channels in blocks of
+    MlasNchwcGetBlockSize() channels, so the elements of a block for a spatial
+    position are contiguous. The channel counts of the tensors must be a
+    multiple of the block size, except for the input of a convolution that
+    reads a NCHW tensor.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the base parameters for the NCHWc operations.
+//
+
+struct MLAS_NCHWC_WORK_BLOCK {
+    ptrdiff_t tids;
+    size_t BatchCount;
+    size_t InputChannels;
+    size_t InputShape[2];
+    size_t InputSize;
+    size_t OutputChannels;
+    size_t OutputShape[2];
+    size_t OutputSize;
+    size_t KernelShape[2];
+    size_t DilationShape[2];
+    size_t Padding[4];
+    size_t StrideShape[2];
+    size_t OutputCountLeftPad[2];
+    size_t OutputCount[2];
+    size_t OutputCountRightPad[2];
+};
+
+//
+// Define the parameters to execute segments of a NCHWc convolution operation
+// on worker threads.
+//
+
+struct MLAS_NCHWC_CONV_WORK_BLOCK : MLAS_NCHWC_WORK_BLOCK {
+    const float* Input;
+    const float* Filter;
+    const float* Bias;
+    const MLAS_ACTIVATION* Activation;
+    float* Output;
+    size_t GroupCount;
+    bool ZeroMode;
+};
+
+size_t
+MLASCALL
+MlasNchwcGetBlockSize(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the NCHWc block size for the platform.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the NCHWc block size for the platform. If NCHWc support is not
+    available for the platform, then returns one.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    return GetMlasPlatform().NchwcBlockSize;
+#else
+    return 1;
+#endif
+}
+
+void
+MlasNchwcPrepareWorkBlock(
+    MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape
+    )
+/*++
+
+Routine Description:
+
+    This routine prepares for a NCHWc operation by computing required
+    parameters including the number of output elements along each spatial
+    dimension that are affected by the padding.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the common NCHWc
+        parameters.
+
+    InputShape - Supplies the shape of the input tensor.
+
+    KernelShape - Supplies the shape of the kernel transform.
+
+    DilationShape - Supplies the shape of the dilation.
+
+    Padding - Supplies the number of padding elements at the edge of the input
+        tensor.
+
+    StrideShape - Supplies the shape of the stride.
+
+    OutputShape - Supplies the shape of the output tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Extract and skip over the batch and channel counts.
+    //
+
+    WorkBlock->BatchCount = size_t(InputShape[0]);
+    WorkBlock->InputChannels = size_t(InputShape[1]);
+    WorkBlock->OutputChannels = size_t(OutputShape[1]);
+
+    InputShape += 2;
+    OutputShape += 2;
+
+    //
+    // Extract the shape information along each spatial dimension.
+    //
+
+    size_t InputSize = 1;
+    size_t OutputSize = 1;
+
+    for (size_t dim = 0; dim < 2; dim++) {
+
+        const size_t InputValue = size_t(InputShape[dim]);
+        const size_t OutputValue = size_t(OutputShape[dim]);
+
+        WorkBlock->InputShape[dim] = InputValue;
+        WorkBlock->OutputShape[dim] = OutputValue;
+
+        InputSize *= InputValue;
+        OutputSize *= OutputValue;
+
+        WorkBlock->KernelShape[dim] = size_t(KernelShape[dim]);
+        WorkBlock->DilationShape[dim] = (DilationShape != nullptr) ? size_t(DilationShape[dim]) : 1;
+
+        if (Padding != nullptr) {
+            WorkBlock->Padding[dim] = size_t(Padding[dim]);
+            WorkBlock->Padding[dim + 2] = size_t(Padding[dim + 2]);
+        } else {
+            WorkBlock->Padding[dim] = 0;
+            WorkBlock->Padding[dim + 2] = 0;
+        }
+
+        WorkBlock->StrideShape[dim] = (StrideShape != nullptr) ? size_t(StrideShape[dim]) : 1;
+    }
+
+    WorkBlock->InputSize = InputSize;
+    WorkBlock->OutputSize = OutputSize;
+
+    //
+    // Compute the number of output elements affected by left and right
+    // padding.
+    //
+
+    for (size_t dim = 0; dim < 2; dim++) {
+
+        const size_t SpanValue =
+            WorkBlock->DilationShape[dim] * (WorkBlock->KernelShape[dim] - 1) + 1;
+        const size_t StrideValue = WorkBlock->StrideShape[dim];
+        const size_t PaddingLeftValue = WorkBlock->Padding[dim];
+        const size_t InputValue = WorkBlock->InputShape[dim];
+
+        size_t OutputCountWithLeftPad;
+
+        if (InputValue + PaddingLeftValue >= SpanValue) {
+            OutputCountWithLeftPad = (InputValue + PaddingLeftValue - SpanValue) / StrideValue + 1;
+        } else {
+            OutputCountWithLeftPad = 0;
+        }
+
+        size_t OutputCountLeftPad = (PaddingLeftValue + StrideValue - 1) / StrideValue;
+
+        if (OutputCountLeftPad > OutputCountWithLeftPad) {
+            OutputCountLeftPad = OutputCountWithLeftPad;
+        }
+
+        const size_t OutputValue = WorkBlock->OutputShape[dim];
+
+        WorkBlock->OutputCountLeftPad[dim] = OutputCountLeftPad;
+        WorkBlock->OutputCount[dim] = OutputCountWithLeftPad - OutputCountLeftPad;
+        WorkBlock->OutputCountRightPad[dim] = OutputValue - OutputCountWithLeftPad;
+    }
+}
+
+//
+// Base implementation for neural network algorithms (convolution and pooling).
+//
+
+struct MLAS_NCHWC_NN_ALGORITHM
+{
+    static constexpr size_t HeightShapeIndex = 0;
+    static constexpr size_t WidthShapeIndex = 1;
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    //
+    // Capture these values from the work block for use as local constants.
+    //
+
+    const size_t BatchCount;
+    const size_t InputChannels;
+    const size_t OutputChannels;
+    const size_t InputHeight;
+    const size_t InputWidth;
+    const size_t InputSize;
+    const size_t OutputHeight;
+    const size_t OutputWidth;
+    const size_t OutputSize;
+    const size_t KernelHeight;
+    const size_t KernelWidth;
+    const size_t KernelSize;
+    const size_t DilationHeight;
+    const size_t DilationWidth;
+    const size_t PaddingLeftY;
+    const size_t PaddingLeftX;
+    const size_t StrideHeight;
+    const size_t StrideWidth;
+    const size_t OutputCountLeftPadY;
+    const size_t OutputCountY;
+    const size_t OutputCountLeftPadX;
+    const size_t OutputCountX;
+    const size_t OutputCountRightPadX;
+
+    MLAS_NCHWC_NN_ALGORITHM(const MLAS_NCHWC_WORK_BLOCK* WorkBlock) :
+        BatchCount(WorkBlock->BatchCount),
+        InputChannels(WorkBlock->InputChannels),
+        OutputChannels(WorkBlock->OutputChannels),
+        InputHeight(WorkBlock->InputShape[HeightShapeIndex]),
+        InputWidth(WorkBlock->InputShape[WidthShapeIndex]),
+        InputSize(WorkBlock->InputSize),
+        OutputHeight(WorkBlock->OutputShape[HeightShapeIndex]),
+        OutputWidth(WorkBlock->OutputShape[WidthShapeIndex]),
+        OutputSize(WorkBlock->OutputSize),
+        KernelHeight(WorkBlock->KernelShape[HeightShapeIndex]),
+        KernelWidth(WorkBlock->KernelShape[WidthShapeIndex]),
+        KernelSize(KernelHeight * KernelWidth),
+        DilationHeight(WorkBlock->DilationShape[HeightShapeIndex]),
+        DilationWidth(WorkBlock->DilationShape[WidthShapeIndex]),
+        PaddingLeftY(WorkBlock->Padding[HeightShapeIndex]),
+        PaddingLeftX(WorkBlock->Padding[WidthShapeIndex]),
+        StrideHeight(WorkBlock->StrideShape[HeightShapeIndex]),
+        StrideWidth(WorkBlock->StrideShape[WidthShapeIndex]),
+        OutputCountLeftPadY(WorkBlock->OutputCountLeftPad[HeightShapeIndex]),
+        OutputCountY(WorkBlock->OutputCount[HeightShapeIndex]),
+        OutputCountLeftPadX(WorkBlock->OutputCountLeftPad[WidthShapeIndex]),
+        OutputCountX(WorkBlock->OutputCount[WidthShapeIndex]),
+        OutputCountRightPadX(WorkBlock->OutputCountRightPad[WidthShapeIndex])
+    {
+    }
+};
+
+constexpr size_t MLAS_NCHWC_NN_ALGORITHM::HeightShapeIndex;
+constexpr size_t MLAS_NCHWC_NN_ALGORITHM::WidthShapeIndex;
+
+template<typename AlgorithmType>
+void
+MlasNchwcThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+{
+    AlgorithmType((decltype(AlgorithmType::WorkBlock))Context).Execute(Index);
+}
+
+//
+// Base implementation for convolution algorithms.
+//
+
+struct MLAS_NCHWC_CONV_ALGORITHM : MLAS_NCHWC_NN_ALGORITHM
+{
+    //
+    // Define the number of filter blocks that are computed by a single call
+    // to a convolution kernel.
+    //
+
+    static constexpr size_t FilterSetSize = 4;
+
+    const MLAS_NCHWC_CONV_WORK_BLOCK* WorkBlock;
+    const size_t GroupCount;
+    const MLAS_ACTIVATION* Activation;
+    const MLAS_ACTIVATION_KIND ActivationKind;
+    const bool ZeroMode;
+
+    //
+    // Capture the buffer pointers from the work block.
+    //
+    // These fields are updated as the threads step through the convolution
+    // operation.
+    //
+
+    const float* Input;
+    const float* Filter;
+    const float* Bias;
+    float* Output;
+
+    //
+    // Stores the current position of the thread within the operation.
+    //
+
+    const size_t FilterSetCount;
+    size_t FilterSet;
+    size_t FilterCount;
+    size_t Group;
+    size_t ph;
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MLAS_NCHWC_CONV_ALGORITHM(const MLAS_NCHWC_CONV_WORK_BLOCK* WorkBlock) :
+        MLAS_NCHWC_NN_ALGORITHM(WorkBlock),
+        WorkBlock(WorkBlock),
+        GroupCount(WorkBlock->GroupCount),
+        Activation(WorkBlock->Activation),
+        ActivationKind(Activation->ActivationKind),
+        ZeroMode(WorkBlock->ZeroMode),
+        FilterSetCount(MlasDivRoundup(OutputChannels / BlockSize, FilterSetSize))
+    {
+        Input = WorkBlock->Input;
+        Filter = WorkBlock->Filter;
+        Bias = WorkBlock->Bias;
+        Output = WorkBlock->Output;
+    }
+
+    unsigned
+    ComputeKernelFlags(
+        size_t ic,
+        size_t ChannelCount
+        )
+    {
+        unsigned KernelFlags = 0;
+
+        //
+        // Accumulate into the output buffer if this is not the first input
+        // channel of the convolution or if the caller requested accumulation.
+        //
+
+        if (ic != 0 || !ZeroMode) {
+            KernelFlags |= MLAS_CONV_KERNEL_FLAG_ACCUMULATE_OUTPUT;
+        }
+
+        //
+        // The bias and activation are applied after the last input channel.
+        //
+
+        if (ic + ChannelCount == InputChannels) {
+
+            if (Bias != nullptr) {
+                KernelFlags |= MLAS_CONV_KERNEL_FLAG_BIAS_ADDITION;
+            }
+
+            if (ActivationKind == MlasReluActivation) {
+                KernelFlags |= MLAS_CONV_KERNEL_FLAG_RELU_ACTIVATION;
+            } else if (ActivationKind != MlasIdentityActivation) {
+                KernelFlags |= MLAS_CONV_KERNEL_FLAG_OTHER_ACTIVATION;
+            }
+        }
+
+        return KernelFlags;
+    }
+
+    void
+    SeekWork(
+        size_t WorkIndex
+        )
+    {
+        //
+        // Extract the batch, group, filter set, and output row from the work
+        // index.
+        //
+
+        ph = WorkIndex % OutputHeight;
+        const size_t BatchGroupFilterSet = WorkIndex / OutputHeight;
+
+        FilterSet = BatchGroupFilterSet % FilterSetCount;
+        const size_t BatchGroup = BatchGroupFilterSet / FilterSetCount;
+
+        Group = BatchGroup % GroupCount;
+
+        FilterCount = std::min(FilterSetSize, (OutputChannels / BlockSize) - FilterSet * FilterSetSize);
+
+        //
+        // Compute the convolution buffer pointers for the position.
+        //
+
+        const size_t FilterSetChannels = FilterSetSize * BlockSize;
+
+        Input = WorkBlock->Input + BatchGroup * InputChannels * InputSize;
+        Output = WorkBlock->Output + BatchGroup * OutputChannels * OutputSize +
+            FilterSet * FilterSetChannels * OutputSize;
+        Filter = WorkBlock->Filter + Group * OutputChannels * InputChannels * KernelSize +
+            FilterSet * FilterSetChannels * InputChannels * KernelSize;
+
+        Bias = WorkBlock->Bias;
+
+        if (Bias != nullptr) {
+            Bias += Group * OutputChannels + FilterSet * FilterSetChannels;
+        }
+    }
+
+    void
+    PrepareWork(
+        ptrdiff_t Index
+        )
+    {
+        const size_t TotalWork = ((BatchCount * GroupCount) * FilterSetCount) * OutputHeight;
+
+        MlasPartitionWork(Index, WorkBlock->tids, TotalWork, &WorkIndex, &WorkRemaining);
+
+        if (WorkRemaining > 0) {
+            SeekWork(WorkIndex);
+        }
+    }
+
+    void
+    CompleteWork(
+        size_t WorkThisIteration
+        )
+    {
+        ph += WorkThisIteration;
+        WorkIndex += WorkThisIteration;
+        WorkRemaining -= WorkThisIteration;
+
+        //
+        // Advance to the next filter set, group, or batch when all output rows
+        // of the current filter set have been computed.
+        //
+
+        if (ph == OutputHeight && WorkRemaining > 0) {
+            SeekWork(WorkIndex);
+        }
+    }
+
+    void
+    DoActivation(
+        float* output,
+        size_t FilterCount,
+        size_t BlockedOutputWidth
+        )
+    {
+        //
+        // Invoke the activation routine in place on the output rows. The
+        // kernels write one output row to each NCHWc plane of the filter set,
+        // so the stride is the blocked size of a plane.
+        //
+
+        MlasActivation(Activation, output, nullptr, FilterCount, BlockedOutputWidth,
+            BlockSize * OutputSize);
+    }
+
+    void
+    AdjustForPadding(
+        size_t FilterRowStride,
+        size_t* ih,
+        size_t* EffectiveKernelHeight,
+        const float** filter
+        )
+    {
+        //
+        // If the output row uses one or more input padding rows, then skip the
+        // kernel rows that are in the padding region. Padding rows at the top
+        // advance the first input row and the filter, padding rows at the
+        // bottom reduce the kernel height.
+        //
+
+        if ((ph - OutputCountLeftPadY) >= OutputCountY) {
+
+            size_t ihStep = *ih;
+
+            for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+                if (ihStep >= InputHeight) {
+
+                    if (ihStep == *ih) {
+                        *ih += DilationHeight;
+                        *filter += FilterRowStride;
+                    }
+
+                    *EffectiveKernelHeight -= 1;
+                }
+
+                ihStep += DilationHeight;
+            }
+        }
+    }
+};
+
+constexpr size_t MLAS_NCHWC_CONV_ALGORITHM::FilterSetSize;
+
+//
+// Convolution algorithm for a NCHWc input tensor with a filter in the
+// OIHWBiBo format.
+//
+
+struct MLAS_NCHWC_CONV_NCHWC_ALGORITHM : MLAS_NCHWC_CONV_ALGORITHM
+{
+    MLAS_NCHWC_CONV_NCHWC_ALGORITHM(const MLAS_NCHWC_CONV_WORK_BLOCK* WorkBlock) :
+        MLAS_NCHWC_CONV_ALGORITHM(WorkBlock)
+    {
+    }
+
+    void
+    Execute(
+        ptrdiff_t Index
+        )
+    {
+        const size_t StrideWidthBytes = BlockSize * StrideWidth * sizeof(float);
+        const size_t DilationWidthBytes = BlockSize * DilationWidth * sizeof(float);
+        const size_t FilterStrideBytes = BlockSize * InputChannels * KernelSize * sizeof(float);
+        const size_t OutputStrideBytes = BlockSize * OutputSize * sizeof(float);
+        const size_t InputWidthBytes = BlockSize * InputWidth * sizeof(float);
+        const size_t DilatedInputWidthBytes = BlockSize * DilationHeight * InputWidth * sizeof(float);
+        const size_t InputStrideBytes = DilatedInputWidthBytes - KernelWidth * DilationWidthBytes;
+
+#if defined(MLAS_TARGET_AMD64)
+        MLAS_CONV_FLOAT_KERNEL* Kernel = GetMlasPlatform().ConvNchwcFloatKernel;
+#else
+        MLAS_CONV_FLOAT_KERNEL* Kernel = MlasConvNchwcFloatKernel;
+#endif
+
+        PrepareWork(Index);
+
+        while (WorkRemaining > 0) {
+
+            //
+            // Compute the first input row and kernel height, skipping any
+            // kernel rows in the padding region.
+            //
+
+            size_t ih = ph * StrideHeight - PaddingLeftY;
+            size_t EffectiveKernelHeight = KernelHeight;
+            const float* filter = Filter;
+
+            AdjustForPadding(BlockSize * BlockSize * KernelWidth, &ih, &EffectiveKernelHeight, &filter);
+
+            //
+            // Invoke the convolution kernel for each input channel block. The
+            // output row stays in the cache across the input channel blocks.
+            //
+
+            float* output = Output + BlockSize * ph * OutputWidth;
+
+            for (size_t ic = 0; ic < InputChannels; ic += BlockSize) {
+
+                const float* input = Input + ic * InputSize + BlockSize * ih * InputWidth;
+
+                unsigned KernelFlags = ComputeKernelFlags(ic, BlockSize);
+
+                Kernel(input - BlockSize * PaddingLeftX, filter, output, StrideWidthBytes,
+                    DilationWidthBytes, FilterCount, InputStrideBytes, FilterStrideBytes,
+                    OutputStrideBytes, EffectiveKernelHeight, KernelWidth, input,
+                    InputWidthBytes, DilatedInputWidthBytes, OutputCountLeftPadX,
+                    OutputCountX, OutputCountRightPadX, Bias, KernelFlags);
+
+                if ((KernelFlags & MLAS_CONV_KERNEL_FLAG_OTHER_ACTIVATION) != 0) {
+                    DoActivation(output, FilterCount, BlockSize * OutputWidth);
+                }
+
+                filter += BlockSize * BlockSize * KernelSize;
+            }
+
+            CompleteWork(1);
+        }
+    }
+};
+
+//
+// Convolution algorithm for a NCHW input tensor with a filter in the OIHWBo
+// format. This is used when the number of input channels is less than the
+// block size, typically for the first layer of a model.
+//
+
+struct MLAS_NCHWC_CONV_NCHW_ALGORITHM : MLAS_NCHWC_CONV_ALGORITHM
+{
+    MLAS_NCHWC_CONV_NCHW_ALGORITHM(const MLAS_NCHWC_CONV_WORK_BLOCK* WorkBlock) :
+        MLAS_NCHWC_CONV_ALGORITHM(WorkBlock)
+    {
+    }
+
+    void
+    Execute(
+        ptrdiff_t Index
+        )
+    {
+        const size_t StrideWidthBytes = StrideWidth * sizeof(float);
+        const size_t DilationWidthBytes = DilationWidth * sizeof(float);
+        const size_t FilterStrideBytes = BlockSize * InputChannels * KernelSize * sizeof(float);
+        const size_t OutputStrideBytes = BlockSize * OutputSize * sizeof(float);
+        const size_t InputWidthBytes = InputWidth * sizeof(float);
+        const size_t DilatedInputWidthBytes = DilationHeight * InputWidth * sizeof(float);
+        const size_t InputStrideBytes = DilatedInputWidthBytes - KernelWidth * DilationWidthBytes;
+
+#if defined(MLAS_TARGET_AMD64)
+        MLAS_CONV_FLOAT_KERNEL* Kernel = GetMlasPlatform().ConvNchwFloatKernel;
+#else
+        MLAS_CONV_FLOAT_KERNEL* Kernel = MlasConvNchwFloatKernel;
+#endif
+
+        PrepareWork(Index);
+
+        while (WorkRemaining > 0) {
+
+            //
+            // Compute the first input row and kernel height, skipping any
+            // kernel rows in the padding region.
+            //
+
+            size_t ih = ph * StrideHeight - PaddingLeftY;
+            size_t EffectiveKernelHeight = KernelHeight;
+            const float* filter = Filter;
+
+            AdjustForPadding(BlockSize * KernelWidth, &ih, &EffectiveKernelHeight, &filter);
+
+            //
+            // Invoke the convolution kernel for each input channel.
+            //
+
+            float* output = Output + BlockSize * ph * OutputWidth;
+
+            for (size_t ic = 0; ic < InputChannels; ic++) {
+
+                const float* input = Input + ic * InputSize + ih * InputWidth;
+
+                unsigned KernelFlags = ComputeKernelFlags(ic, 1);
+
+                Kernel(input - PaddingLeftX, filter, output, StrideWidthBytes,
+                    DilationWidthBytes, FilterCount, InputStrideBytes, FilterStrideBytes,
+                    OutputStrideBytes, EffectiveKernelHeight, KernelWidth, input,
+                    InputWidthBytes, DilatedInputWidthBytes, OutputCountLeftPadX,
+                    OutputCountX, OutputCountRightPadX, Bias, KernelFlags);
+
+                if ((KernelFlags & MLAS_CONV_KERNEL_FLAG_OTHER_ACTIVATION) != 0) {
+                    DoActivation(output, FilterCount, BlockSize * OutputWidth);
+                }
+
+                filter += BlockSize * KernelSize;
+            }
+
+            CompleteWork(1);
+        }
+    }
+};
+
+//
+// Convolution algorithm for a NCHWc input tensor with a 1x1 filter in the
+// OIHWBiBo format and no padding.
+//
+
+struct MLAS_NCHWC_CONV_POINTWISE_ALGORITHM : MLAS_NCHWC_CONV_ALGORITHM
+{
+    //
+    // Define the number of input channels that are processed by a single
+    // call to the kernel, so that the output rows stay in the cache while the
+    // kernel accumulates the input channels.
+    //
+
+    static constexpr size_t MaximumInputChannelBatch = 128;
+
+    MLAS_NCHWC_CONV_POINTWISE_ALGORITHM(const MLAS_NCHWC_CONV_WORK_BLOCK* WorkBlock) :
+        MLAS_NCHWC_CONV_ALGORITHM(WorkBlock)
+    {
+    }
+
+    void
+    Execute(
+        ptrdiff_t Index
+        )
+    {
+        const size_t StrideWidthBytes = BlockSize * StrideWidth * sizeof(float);
+        const size_t InputStrideBytes = BlockSize * InputSize * sizeof(float);
+        const size_t FilterStrideBytes = BlockSize * InputChannels * sizeof(float);
+        const size_t OutputStrideBytes = BlockSize * OutputSize * sizeof(float);
+
+#if defined(MLAS_TARGET_AMD64)
+        MLAS_CONV_POINTWISE_FLOAT_KERNEL* Kernel = GetMlasPlatform().ConvPointwiseFloatKernel;
+#else
+        MLAS_CONV_POINTWISE_FLOAT_KERNEL* Kernel = MlasConvPointwiseFloatKernel;
+#endif
+
+        PrepareWork(Index);
+
+        while (WorkRemaining > 0) {
+
+            //
+            // Compute the number of output rows to process in this iteration.
+            // With unit strides, consecutive output rows read consecutive
+            // input rows, so the rows are processed as a single row.
+            //
+
+            size_t WorkThisIteration;
+
+            if (StrideHeight == 1 && StrideWidth == 1) {
+                WorkThisIteration = std::min(WorkRemaining, OutputHeight - ph);
+            } else {
+                WorkThisIteration = 1;
+            }
+
+            const size_t OutputThisIteration = WorkThisIteration * OutputWidth;
+
+            //
+            // Invoke the convolution kernel for each batch of input channels.
+            //
+
+            const float* input = Input + BlockSize * (ph * StrideHeight * InputWidth);
+            const float* filter = Filter;
+            float* output = Output + BlockSize * ph * OutputWidth;
+
+            for (size_t ic = 0; ic < InputChannels; ic += MaximumInputChannelBatch) {
+
+                const size_t InputChannelBatch = std::min(InputChannels - ic, MaximumInputChannelBatch);
+
+                unsigned KernelFlags = ComputeKernelFlags(ic, InputChannelBatch);
+
+                Kernel(input, filter, output, StrideWidthBytes, InputChannelBatch / BlockSize,
+                    FilterCount, InputStrideBytes, FilterStrideBytes, OutputStrideBytes,
+                    OutputThisIteration, Bias, KernelFlags);
+
+                if ((KernelFlags & MLAS_CONV_KERNEL_FLAG_OTHER_ACTIVATION) != 0) {
+                    DoActivation(output, FilterCount, BlockSize * OutputThisIteration);
+                }
+
+                input += MaximumInputChannelBatch * InputSize;
+                filter += BlockSize * MaximumInputChannelBatch;
+            }
+
+            CompleteWork(WorkThisIteration);
+        }
+    }
+};
+
+constexpr size_t MLAS_NCHWC_CONV_POINTWISE_ALGORITHM::MaximumInputChannelBatch;
+
+//
+// Convolution algorithm for a depthwise separable convolution of a NCHWc
+// input tensor with a filter in the OIHWBo format, where each group has one
+// input and one output channel. The groups are processed a block at a time.
+//
+
+struct MLAS_NCHWC_CONV_DEPTHWISE_ALGORITHM : MLAS_NCHWC_CONV_ALGORITHM
+{
+    MLAS_NCHWC_CONV_DEPTHWISE_ALGORITHM(const MLAS_NCHWC_CONV_WORK_BLOCK* WorkBlock) :
+        MLAS_NCHWC_CONV_ALGORITHM(WorkBlock)
+    {
+    }
+
+    void
+    Execute(
+        ptrdiff_t Index
+        )
+    {
+        const size_t GroupBlockCount = GroupCount / BlockSize;
+
+        const size_t StrideWidthBytes = BlockSize * StrideWidth * sizeof(float);
+        const size_t DilationWidthBytes = BlockSize * DilationWidth * sizeof(float);
+        const size_t InputWidthBytes = BlockSize * InputWidth * sizeof(float);
+        const size_t DilatedInputWidthBytes = BlockSize * DilationHeight * InputWidth * sizeof(float);
+        const size_t InputStrideBytes = DilatedInputWidthBytes - KernelWidth * DilationWidthBytes;
+
+#if defined(MLAS_TARGET_AMD64)
+        MLAS_CONV_DEPTHWISE_FLOAT_KERNEL* Kernel = GetMlasPlatform().ConvDepthwiseFloatKernel;
+#else
+        MLAS_CONV_DEPTHWISE_FLOAT_KERNEL* Kernel = MlasConvDepthwiseFloatKernel;
+#endif
+
+        //
+        // Partition the work as rows of blocks of groups. The filter and bias
+        // of a block of groups are at the same offset as its input and output
+        // channels.
+        //
+
+        const size_t TotalWork = BatchCount * GroupBlockCount * OutputHeight;
+
+        size_t WorkIndex;
+
+        MlasPartitionWork(Index, WorkBlock->tids, TotalWork, &WorkIndex, &WorkRemaining);
+
+        ph = WorkIndex % OutputHeight;
+        const size_t BatchGroup = WorkIndex / OutputHeight;
+        size_t GroupBlock = BatchGroup % GroupBlockCount;
+
+        Input += BatchGroup * BlockSize * InputSize;
+        Output += BatchGroup * BlockSize * OutputSize;
+        Filter += GroupBlock * BlockSize * KernelSize;
+
+        if (Bias != nullptr) {
+            Bias += GroupBlock * BlockSize;
+        }
+
+        unsigned KernelFlags = ComputeKernelFlags(0, InputChannels);
+
+        while (WorkRemaining > 0) {
+
+            //
+            // Compute the first input row and kernel height, skipping any
+            // kernel rows in the padding region.
+            //
+
+            size_t ih = ph * StrideHeight - PaddingLeftY;
+            size_t EffectiveKernelHeight = KernelHeight;
+            const float* filter = Filter;
+
+            AdjustForPadding(BlockSize * KernelWidth, &ih, &EffectiveKernelHeight, &filter);
+
+            const float* input = Input + BlockSize * ih * InputWidth;
+            float* output = Output + BlockSize * ph * OutputWidth;
+
+            Kernel(input - BlockSize * PaddingLeftX, filter, output, StrideWidthBytes,
+                DilationWidthBytes, InputStrideBytes, EffectiveKernelHeight, KernelWidth, input,
+                InputWidthBytes, DilatedInputWidthBytes, OutputCountLeftPadX, OutputCountX,
+                OutputCountRightPadX, Bias, KernelFlags);
+
+            if ((KernelFlags & MLAS_CONV_KERNEL_FLAG_OTHER_ACTIVATION) != 0) {
+                DoActivation(output, 1, BlockSize * OutputWidth);
+            }
+
+            //
+            // Advance to the next block of groups after the last output row.
+            //
+
+            WorkRemaining--;
+
+            if (++ph == OutputHeight) {
+
+                Input += BlockSize * InputSize;
+                Output += BlockSize * OutputSize;
+                Filter += BlockSize * KernelSize;
+
+                if (Bias != nullptr) {
+                    Bias += BlockSize;
+                }
+
+                if (++GroupBlock == GroupBlockCount) {
+
+                    Filter = WorkBlock->Filter;
+                    Bias = WorkBlock->Bias;
+
+                    GroupBlock = 0;
+                }
+
+                ph = 0;
+            }
+        }
+    }
+};
+
+void
+MLASCALL
+MlasNchwcConv(
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    size_t GroupCount,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    const MLAS_ACTIVATION* Activation,
+    bool ZeroMode,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the NCHWc convolution operation.
+
+    The algorithm is selected from the shape of a group:
+
+        - If the group has at least a block of input channels, the input
+          tensor is in the NCHWc format and the filter is in the OIHWBiBo
+          format. Kernels of 1x1 without padding use the pointwise kernel.
+
+        - If each group has one input and one output channel (a depthwise
+          separable convolution), the input tensor is in the NCHWc format and
+          the filter is in the OIHWBo format.
+
+        - Otherwise, the convolution must have a single group, the input tensor
+          is in the NCHW format and the filter is in the OIHWBo format.
+
+    The output tensor is always in the NCHWc format.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor (NCHW, with the
+        channel count padded to the block size for a NCHWc input tensor).
+
+    KernelShape - Supplies the shape of the kernel transform.
+
+    DilationShape - Supplies the shape of the dilation.
+
+    Padding - Supplies the number of padding elements at the edge of the input
+        tensor.
+
+    StrideShape - Supplies the shape of the stride.
+
+    OutputShape - Supplies the shape of the output tensor (NCHW, with the
+        channel count padded to the block size).
+
+    GroupCount - Supplies the number of channel groups.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    Output - Supplies the output tensor.
+
+    Activation - Supplies the parameters for the activation to apply to the
+        convolution output.
+
+    ZeroMode - Supplies true if the output tensor must be zero initialized
+        first, else false if the output tensor is accumulated into. This flag is
+        used to implement Conv/Sum fusion.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_NCHWC_CONV_WORK_BLOCK WorkBlock;
+
+    //
+    // Capture the convolution specific parameters to the work block.
+    //
+
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.GroupCount = GroupCount;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Activation = Activation;
+    WorkBlock.ZeroMode = ZeroMode;
+
+    //
+    // Capture the generic shape parameters to the work block.
+    //
+
+    MlasNchwcPrepareWorkBlock(&WorkBlock, InputShape, KernelShape, DilationShape,
+        Padding, StrideShape, OutputShape);
+
+    WorkBlock.InputChannels /= GroupCount;
+    WorkBlock.OutputChannels /= GroupCount;
+
+    //
+    // Determine the type of convolution to perform based on the shape of the
+    // filter and input channel count.
+    //
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    MLAS_THREADED_ROUTINE* ThreadedRoutine;
+    size_t TotalWork;
+
+    if (WorkBlock.InputChannels >= BlockSize) {
+
+        if (WorkBlock.KernelShape[0] == 1 && WorkBlock.KernelShape[1] == 1 &&
+            WorkBlock.Padding[0] == 0 && WorkBlock.Padding[1] == 0 &&
+            WorkBlock.Padding[2] == 0 && WorkBlock.Padding[3] == 0) {
+            ThreadedRoutine = MlasNchwcThreaded<MLAS_NCHWC_CONV_POINTWISE_ALGORITHM>;
+        } else {
+            ThreadedRoutine = MlasNchwcThreaded<MLAS_NCHWC_CONV_NCHWC_ALGORITHM>;
+        }
+
+    } else if (WorkBlock.InputChannels == 1 && WorkBlock.OutputChannels == 1) {
+
+        ThreadedRoutine = MlasNchwcThreaded<MLAS_NCHWC_CONV_DEPTHWISE_ALGORITHM>;
+
+    } else {
+
+        ThreadedRoutine = MlasNchwcThreaded<MLAS_NCHWC_CONV_NCHW_ALGORITHM>;
+    }
+
+    //
+    // Compute the number of output rows to partition across the threads.
+    //
+
+    if (ThreadedRoutine == MlasNchwcThreaded<MLAS_NCHWC_CONV_DEPTHWISE_ALGORITHM>) {
+        TotalWork = (GroupCount / BlockSize);
+    } else {
+        TotalWork = GroupCount * MlasDivRoundup(WorkBlock.OutputChannels / BlockSize,
+            MLAS_NCHWC_CONV_ALGORITHM::FilterSetSize);
+    }
+
+    TotalWork *= WorkBlock.BatchCount * WorkBlock.OutputShape[0];
+
+    //
+    // Schedule the operation across a set of worker threads. Each thread
+    // processes a contiguous range of output rows.
+    //
+
+    ptrdiff_t TargetThreadCount =
+        MlasGetMaximumThreadCount(ThreadPool) * MLAS_THREADED_WORK_ITEMS_PER_THREAD;
+
+    if (size_t(TargetThreadCount) > TotalWork) {
+        TargetThreadCount = ptrdiff_t(TotalWork);
+    }
+
+    if (TargetThreadCount == 0) {
+        return;
+    }
+
+    WorkBlock.tids = TargetThreadCount;
+
+    MlasExecuteThreaded(ThreadedRoutine, &WorkBlock, WorkBlock.tids, ThreadPool);
+}
+
+void
+MlasNchwcConvDepthwiseBlock(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    const MLAS_ACTIVATION* Activation
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a depthwise convolution of one block of channels
+    on the calling thread, for MlasConv to convolve the blocks of a NCHW
+    tensor that it has reordered to the NCHWc format.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the parameters of the
+        2D depthwise convolution from MlasConvPrepare.
+
+    Input - Supplies the input tensor of the block (NCHWc).
+
+    Filter - Supplies the filter tensor of the block (OIHWBo).
+
+    Bias - Optionally supplies the bias vector of the block.
+
+    Output - Supplies the output tensor of the block (NCHWc).
+
+    Activation - Supplies the parameters for the activation to apply to the
+        convolution output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const int64_t BlockSize = int64_t(MlasNchwcGetBlockSize());
+
+    const int64_t InputShape[] = {1, BlockSize, int64_t(Parameters->InputShape[0]),
+        int64_t(Parameters->InputShape[1])};
+    const int64_t OutputShape[] = {1, BlockSize, int64_t(Parameters->OutputShape[0]),
+        int64_t(Parameters->OutputShape[1])};
+    const int64_t KernelShape[] = {int64_t(Parameters->KernelShape[0]), int64_t(Parameters->KernelShape[1])};
+    const int64_t DilationShape[] = {int64_t(Parameters->DilationShape[0]), int64_t(Parameters->DilationShape[1])};
+    const int64_t Padding[] = {int64_t(Parameters->Padding[0]), int64_t(Parameters->Padding[1]),
+        int64_t(Parameters->Padding[2]), int64_t(Parameters->Padding[3])};
+    const int64_t StrideShape[] = {int64_t(Parameters->StrideShape[0]), int64_t(Parameters->StrideShape[1])};
+
+    MLAS_NCHWC_CONV_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.GroupCount = size_t(BlockSize);
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Activation = Activation;
+    WorkBlock.ZeroMode = true;
+
+    MlasNchwcPrepareWorkBlock(&WorkBlock, InputShape, KernelShape, DilationShape,
+        Padding, StrideShape, OutputShape);
+
+    WorkBlock.InputChannels = 1;
+    WorkBlock.OutputChannels = 1;
+    WorkBlock.tids = 1;
+
+    MlasNchwcThreaded<MLAS_NCHWC_CONV_DEPTHWISE_ALGORITHM>(&WorkBlock, 0);
+}
@@ -0,0 +1,127 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    tanh.cpp
+
+Abstract:
+
+    This module implements the hyperbolic tangent function.
+
+    The input is clamped to [-9, 9], where tanh rounds to +/-1, and the
+    function is computed as x * P(x^2) / Q(x^2) with a degree 6/6 rational
+    approximation. The coefficients are normalized so that the constant term
+    of the denominator is one, which keeps the precision of denormal inputs.
+    The maximum error is 7 ulp, or an absolute error below 4e-7.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Bundles the floating point constants for use by kernels written in assembly.
+//
+
+MLAS_INTERNAL_DATA const MLAS_TANH_CONSTANTS MlasTanhConstants = {
+    -9.0f,
+    9.0f,
+    -5.64167624104448e-14f,
+    4.08741720740214e-11f,
+    -1.75837891824011e-08f,
+    1.04674991875042e-05f,
+    3.03609831531841e-03f,
+    1.30225533682343e-01f,
+    9.99999871947938e-01f,
+    2.44866093303625e-04f,
+    2.42227639977867e-02f,
+    4.63558385096345e-01f,
+    1.00000000000000e+00f,
+};
+
+void
+MLASCALL
+MlasTanhKernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the hyperbolic tangent function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasTanhFloat32x4(MlasLoadFloat32x4(Input)));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        MlasStoreLaneFloat32x4<0>(Output, MlasTanhFloat32x4(MlasBroadcastFloat32x4(*Input)));
+
+        Input += 1;
+        Output += 1;
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasComputeTanh(
+    const float* Input,
+    float* Output,
+    size_t N,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the hyperbolic tangent function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasComputeUnary(GetMlasPlatform().TanhKernelRoutine, Input, Output, N, ThreadPool);
+#else
+    MlasComputeUnary(MlasTanhKernel, Input, Output, N, ThreadPool);
+#endif
+}
@@ -33,28 +33,16 @@ MlasExecuteThreaded(
         return;
     }
 
-#if defined(BUILD_MLAS_NO_ONNXRUNTIME)
-    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
-
-    //
-    // Fallback to OpenMP or a serialized implementation.
-    //
-
-    //
-    // Execute the routine for the specified number of iterations.
-    //
-    for (ptrdiff_t tid = 0; tid < Iterations; tid++) {
-        ThreadedRoutine(Context, tid);
-    }
-#else
     //
     // Schedule the threaded iterations using the thread pool object.
     //
+    // N.B. When building outside of the ONNX Runtime source tree, a null
+    // thread pool refers to the library's default thread pool.
+    //
 
     MLAS_THREADPOOL::TrySimpleParallelFor(ThreadPool, Iterations, [&](ptrdiff_t tid) {
         ThreadedRoutine(Context, tid);
     });
-#endif
 }
 
 
@@ -62,7 +50,7 @@ void
 MlasTrySimpleParallel(
     MLAS_THREADPOOL * ThreadPool,
     const std::ptrdiff_t Iterations,
-    const std::function<void(std::ptrdiff_t tid)>& Work)
+    MLAS_FUNCTION_REF<void(std::ptrdiff_t tid)> Work)
 {
     //
     // Execute the routine directly if only one iteration is specified.
@@ -72,24 +60,13 @@ MlasTrySimpleParallel(
         return;
     }
 
-#if defined(BUILD_MLAS_NO_ONNXRUNTIME)
-    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
-
-    //
-    // Fallback to OpenMP or a serialized implementation.
-    //
-
-    //
-    // Execute the routine for the specified number of iterations.
-    //
-    for (ptrdiff_t tid = 0; tid < Iterations; tid++) {
-        Work(tid);
-    }
-#else
     //
     // Schedule the threaded iterations using the thread pool object.
     //
+    // N.B. The ONNX Runtime thread pool accepts a std::function. The function
+    // reference fits in its small object buffer, so no allocation occurs in
+    // either configuration.
+    //
 
     MLAS_THREADPOOL::TrySimpleParallelFor(ThreadPool, Iterations, Work);
-#endif
 }
@@ -0,0 +1,1065 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    threadpool.cpp
+
+Abstract:
+
+    This module implements the thread pool that is used when building MLAS
+    outside of the ONNX Runtime source tree.
+
+    The pool keeps a set of persistent worker threads that sleep until a
+    parallel loop is submitted. The submitting thread participates in the
+    loop.
+
+    The iterations of a loop are initially divided into equal contiguous
+    ranges, one per participating thread. With the work stealing schedule, a
+    thread that exhausts its own range steals half of the remaining range of
+    another thread, so threads that are preempted or run on slower cores do
+    not hold up completion of the loop. With the static schedule, each thread
+    only executes its initial range.
+
+    Asynchronous operations are executed by a dispatcher thread that acts as
+    the calling thread for the parallel loops of the operation, so the thread
+    that submitted the operation is free to do other work.
+
+--*/
+
+#include "mlasi.h"
+
+#if defined(BUILD_MLAS_NO_ONNXRUNTIME)
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace onnxruntime {
+namespace concurrency {
+
+//
+// Stores the thread pool that the current thread is executing a parallel loop
+// for, either as a worker thread of the pool or as the thread that submitted
+// the loop. Parallel loops submitted from inside a parallel loop are executed
+// inline to avoid deadlocking the pool.
+//
+
+static thread_local const ThreadPool* MlasCurrentThreadPool = nullptr;
+
+//
+// Define the number of polls that the spin then yield wait policy busy waits
+// before it starts yielding the processor.
+//
+
+#define MLAS_THREADPOOL_SPIN_COUNT_BEFORE_YIELD 64
+
+template <typename Predicate>
+bool
+MlasThreadPoolSpinWait(
+    MLAS_THREADPOOL_WAIT_POLICY WaitPolicy,
+    uint32_t SpinDurationMicroseconds,
+    Predicate Condition
+    )
+/*++
+
+Routine Description:
+
+    This routine polls a condition according to the wait policy until the
+    condition is satisfied or the spin duration expires.
+
+Arguments:
+
+    WaitPolicy - Supplies the wait policy.
+
+    SpinDurationMicroseconds - Supplies the maximum time to poll.
+
+    Condition - Supplies the condition to poll.
+
+Return Value:
+
+    Returns true if the condition was satisfied, else false if the caller
+    should sleep.
+
+--*/
+{
+    if (WaitPolicy == MlasThreadPoolWaitBlock || SpinDurationMicroseconds == 0) {
+        return Condition();
+    }
+
+    const auto Deadline = std::chrono::steady_clock::now() +
+        std::chrono::microseconds(SpinDurationMicroseconds);
+
+    for (uint32_t Poll = 0;; Poll++) {
+
+        if (Condition()) {
+            return true;
+        }
+
+        if (WaitPolicy == MlasThreadPoolWaitSpinThenYield &&
+            Poll >= MLAS_THREADPOOL_SPIN_COUNT_BEFORE_YIELD) {
+            std::this_thread::yield();
+        } else {
+#if defined(MLAS_TARGET_AMD64_IX86)
+            _mm_pause();
+#endif
+        }
+
+        //
+        // Limit how often the clock is read while busy waiting.
+        //
+
+        if ((Poll % 16) == 15 && std::chrono::steady_clock::now() >= Deadline) {
+            return Condition();
+        }
+    }
+}
+
+ThreadPool::ThreadPool(
+    int DegreeOfParallelism
+    )
+/*++
+
+Routine Description:
+
+    This routine creates the worker threads for the thread pool.
+
+Arguments:
+
+    DegreeOfParallelism - Supplies the number of threads that participate in
+        a parallel loop, including the calling thread. Values less than one
+        select the number of hardware threads.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (DegreeOfParallelism < 1) {
+        DegreeOfParallelism = int(std::thread::hardware_concurrency());
+    }
+
+    if (DegreeOfParallelism < 1) {
+        DegreeOfParallelism = 1;
+    }
+
+    const size_t WorkerCount = size_t(DegreeOfParallelism) - 1;
+
+    //
+    // On a hybrid processor, assign the worker threads to core types in
+    // order of decreasing capacity, leaving the first core for the calling
+    // thread.
+    //
+
+    const MLAS_CPU_TOPOLOGY& Topology = MlasGetCpuTopology();
+
+    if (Topology.IsHybrid && WorkerCount > 0) {
+
+        std::vector<MLAS_CPU_INFO> Cpus = Topology.Cpus;
+
+        std::stable_sort(Cpus.begin(), Cpus.end(), [](const MLAS_CPU_INFO& a, const MLAS_CPU_INFO& b) {
+            return a.Capacity > b.Capacity;
+        });
+
+        Hybrid_ = true;
+        WorkerCoreTypes_.resize(WorkerCount);
+        WorkerCapacities_.resize(WorkerCount);
+
+        for (size_t WorkerIndex = 0; WorkerIndex < WorkerCount; WorkerIndex++) {
+            const MLAS_CPU_INFO& CpuInfo = Cpus[(WorkerIndex + 1) % Cpus.size()];
+            WorkerCoreTypes_[WorkerIndex] = CpuInfo.CoreType;
+            WorkerCapacities_[WorkerIndex] = CpuInfo.Capacity;
+        }
+    }
+
+    //
+    // Spinning delays threads that share a processor with a spinning thread,
+    // so sleep immediately if the pool has more threads than processors.
+    // Otherwise, apply the wait policy from the environment.
+    //
+
+    if (unsigned(DegreeOfParallelism) > std::thread::hardware_concurrency()) {
+        WaitPolicy_ = MlasThreadPoolWaitBlock;
+    }
+
+    const char* WaitPolicy = std::getenv("MLAS_WAIT_POLICY");
+
+    if (WaitPolicy != nullptr) {
+        if (strcmp(WaitPolicy, "spin") == 0) {
+            WaitPolicy_ = MlasThreadPoolWaitSpin;
+        } else if (strcmp(WaitPolicy, "yield") == 0) {
+            WaitPolicy_ = MlasThreadPoolWaitSpinThenYield;
+        } else if (strcmp(WaitPolicy, "block") == 0) {
+            WaitPolicy_ = MlasThreadPoolWaitBlock;
+        }
+    }
+
+    const char* SpinDuration = std::getenv("MLAS_SPIN_DURATION_US");
+
+    if (SpinDuration != nullptr) {
+        SpinDurationMicroseconds_ = uint32_t(std::strtoul(SpinDuration, nullptr, 10));
+    }
+
+    //
+    // On a NUMA system, divide the threads evenly across the nodes, with the
+    // calling thread counted as part of the first node.
+    //
+
+    const size_t NumaNodeCount = MlasGetNumaNodeCount();
+
+    if (NumaNodeCount > 1 && WorkerCount > 0) {
+
+        Numa_ = true;
+        WorkerNumaNodes_.resize(WorkerCount);
+
+        for (size_t WorkerIndex = 0; WorkerIndex < WorkerCount; WorkerIndex++) {
+            WorkerNumaNodes_[WorkerIndex] = int32_t((WorkerIndex + 1) * NumaNodeCount / (WorkerCount + 1));
+        }
+    }
+
+    Queues_.reset(new WorkQueue[WorkerCount + 1]);
+
+    Workers_.reserve(WorkerCount);
+
+    for (size_t WorkerIndex = 0; WorkerIndex < WorkerCount; WorkerIndex++) {
+        Workers_.emplace_back(&ThreadPool::WorkerMain, this, WorkerIndex);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    //
+    // Stop the dispatcher thread first, as tasks that are still queued
+    // submit parallel loops to the worker threads.
+    //
+
+    {
+        std::lock_guard<std::mutex> Lock(TaskMutex_);
+        DispatcherShutdown_ = true;
+    }
+
+    TaskAvailable_.notify_one();
+
+    if (Dispatcher_.joinable()) {
+        Dispatcher_.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(Mutex_);
+        Shutdown_.store(true, std::memory_order_release);
+    }
+
+    WorkAvailable_.notify_all();
+
+    for (auto& Worker : Workers_) {
+        Worker.join();
+    }
+}
+
+int
+ThreadPool::DegreeOfParallelism(
+    const ThreadPool* tp
+    )
+{
+    if (tp == nullptr) {
+        tp = GetDefaultThreadPool();
+    }
+
+    return int(tp->Workers_.size()) + 1;
+}
+
+void
+ThreadPool::TrySimpleParallelFor(
+    ThreadPool* tp,
+    std::ptrdiff_t total,
+    MLAS_FUNCTION_REF<void(std::ptrdiff_t)> fn
+    )
+{
+    if (tp == nullptr) {
+        tp = GetDefaultThreadPool();
+    }
+
+    tp->ParallelFor(total, fn);
+}
+
+ThreadPool*
+ThreadPool::GetDefaultThreadPool(
+    void
+    )
+{
+    static ThreadPool DefaultThreadPool([]() {
+        const char* NumThreads = std::getenv("MLAS_NUM_THREADS");
+        return (NumThreads != nullptr) ? std::atoi(NumThreads) : 0;
+    }());
+
+    return &DefaultThreadPool;
+}
+
+void
+ThreadPool::Schedule(
+    MLAS_TASK* Task
+    )
+/*++
+
+Routine Description:
+
+    This routine queues a task to the dispatcher thread, creating the
+    dispatcher thread if this is the first task scheduled to the pool.
+
+Arguments:
+
+    Task - Supplies the task to execute.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    {
+        std::lock_guard<std::mutex> Lock(TaskMutex_);
+
+        if (!Dispatcher_.joinable()) {
+            Dispatcher_ = std::thread(&ThreadPool::DispatcherMain, this);
+        }
+
+        Tasks_.push_back(Task);
+    }
+
+    TaskAvailable_.notify_one();
+}
+
+bool
+ThreadPool::WorkQueue::PopFront(
+    std::ptrdiff_t* Index
+    )
+/*++
+
+Routine Description:
+
+    This routine takes the next iteration from the front of the work queue.
+    This routine is only called by the thread that owns the work queue.
+
+Arguments:
+
+    Index - Receives the index of the iteration.
+
+Return Value:
+
+    Returns true if an iteration was taken, else false if the queue is empty.
+
+--*/
+{
+    uint64_t Current = Range.load(std::memory_order_acquire);
+
+    for (;;) {
+
+        const uint32_t Begin = uint32_t(Current);
+        const uint32_t End = uint32_t(Current >> 32);
+
+        if (Begin >= End) {
+            return false;
+        }
+
+        const uint64_t Updated = (uint64_t(End) << 32) | (Begin + 1);
+
+        if (Range.compare_exchange_weak(Current, Updated, std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+            *Index = std::ptrdiff_t(Begin);
+            return true;
+        }
+    }
+}
+
+bool
+ThreadPool::WorkQueue::StealBack(
+    uint32_t* Begin,
+    uint32_t* End
+    )
+/*++
+
+Routine Description:
+
+    This routine steals the back half of the remaining iterations of the work
+    queue.
+
+Arguments:
+
+    Begin - Receives the first stolen iteration.
+
+    End - Receives the end of the stolen iterations.
+
+Return Value:
+
+    Returns true if iterations were stolen, else false if the queue is empty.
+
+--*/
+{
+    uint64_t Current = Range.load(std::memory_order_acquire);
+
+    for (;;) {
+
+        const uint32_t CurrentBegin = uint32_t(Current);
+        const uint32_t CurrentEnd = uint32_t(Current >> 32);
+
+        if (CurrentBegin >= CurrentEnd) {
+            return false;
+        }
+
+        const uint32_t Split = CurrentEnd - (CurrentEnd - CurrentBegin + 1) / 2;
+        const uint64_t Updated = (uint64_t(Split) << 32) | CurrentBegin;
+
+        if (Range.compare_exchange_weak(Current, Updated, std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+            *Begin = Split;
+            *End = CurrentEnd;
+            return true;
+        }
+    }
+}
+
+void
+ThreadPool::ParallelFor(
+    std::ptrdiff_t Iterations,
+    MLAS_FUNCTION_REF<void(std::ptrdiff_t)> Work
+    )
+/*++
+
+Routine Description:
+
+    This routine executes a parallel loop using the worker threads and the
+    calling thread.
+
+Arguments:
+
+    Iterations - Supplies the number of iterations of the loop.
+
+    Work - Supplies the function to invoke for each iteration.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Execute the loop on the calling thread if there is no parallelism
+    // available: the pool has no workers, the loop is nested inside another
+    // parallel loop, or another thread currently owns the pool. Loops that
+    // cannot be described by the packed work queue ranges are also executed
+    // inline.
+    //
+
+    std::unique_lock<std::mutex> SubmitLock(SubmitMutex_, std::defer_lock);
+
+    if (Iterations <= 1 || Workers_.empty() || MlasCurrentThreadPool != nullptr ||
+        uint64_t(Iterations) > UINT32_MAX || !SubmitLock.try_lock()) {
+
+        for (std::ptrdiff_t Index = 0; Index < Iterations; Index++) {
+            Work(Index);
+        }
+
+        return;
+    }
+
+    //
+    // Divide the iterations into a contiguous range for the calling thread
+    // and each participating worker thread, then publish the loop to the
+    // worker threads. Only wake as many workers as there are iterations
+    // beyond the one taken by the calling thread.
+    //
+
+    const size_t ParticipatingWorkers = std::min(Workers_.size(), size_t(Iterations - 1));
+
+    if (Hybrid_) {
+
+        //
+        // Divide the iterations in proportion to the capacity of the core
+        // types of the threads.
+        //
+
+        const uint32_t CallerCapacity = MlasGetCurrentCpuCapacity();
+        uint64_t TotalCapacity = CallerCapacity;
+
+        for (size_t WorkerIndex = 0; WorkerIndex < ParticipatingWorkers; WorkerIndex++) {
+            TotalCapacity += WorkerCapacities_[WorkerIndex];
+        }
+
+        uint64_t CapacityStart = 0;
+
+        for (size_t Participant = 0; Participant <= ParticipatingWorkers; Participant++) {
+
+            const uint32_t Capacity = (Participant == 0) ? CallerCapacity : WorkerCapacities_[Participant - 1];
+
+            size_t IterationBegin;
+            size_t IterationCount;
+
+            MlasPartitionWorkWeighted(CapacityStart, Capacity, TotalCapacity, size_t(Iterations),
+                                      &IterationBegin, &IterationCount);
+
+            Queues_[Participant].Reset(uint32_t(IterationBegin), uint32_t(IterationBegin + IterationCount));
+
+            CapacityStart += Capacity;
+        }
+
+    } else {
+
+        for (size_t Participant = 0; Participant <= ParticipatingWorkers; Participant++) {
+
+            size_t IterationBegin;
+            size_t IterationCount;
+
+            MlasPartitionWork(ptrdiff_t(Participant), ptrdiff_t(ParticipatingWorkers + 1), size_t(Iterations),
+                              &IterationBegin, &IterationCount);
+
+            Queues_[Participant].Reset(uint32_t(IterationBegin), uint32_t(IterationBegin + IterationCount));
+        }
+    }
+
+    Work_ = &Work;
+    WorkStealing_ = Schedule_.load(std::memory_order_relaxed) == MlasThreadPoolScheduleWorkStealing;
+    ParticipatingWorkers_ = ParticipatingWorkers;
+    ActiveWorkers_.store(ParticipatingWorkers, std::memory_order_relaxed);
+
+    //
+    // Publish the loop under the mutex so that a worker thread that is about
+    // to sleep observes the new generation, and only wake the worker threads
+    // if any are sleeping. Spinning worker threads observe the new generation
+    // directly.
+    //
+
+    bool WakeWorkers;
+
+    {
+        std::lock_guard<std::mutex> Lock(Mutex_);
+
+        const uint64_t Sequence = (Generation_.load(std::memory_order_relaxed) >> 32) + 1;
+
+        Generation_.store((Sequence << 32) | ParticipatingWorkers, std::memory_order_release);
+
+        WakeWorkers = (SleepingWorkers_ != 0);
+    }
+
+    if (WakeWorkers) {
+        WorkAvailable_.notify_all();
+    }
+
+    //
+    // Mark the calling thread as inside the pool while it runs its
+    // iterations, so a nested loop submitted from the work function does not
+    // attempt to lock the submit mutex that this thread already owns.
+    //
+
+    MlasCurrentThreadPool = this;
+
+    RunIterations(0);
+
+    MlasCurrentThreadPool = nullptr;
+
+    //
+    // Wait for the worker threads to finish their iterations. The work
+    // function is owned by the caller, so no worker may reference it after
+    // this routine returns.
+    //
+
+    auto WorkersComplete = [this]() {
+        return ActiveWorkers_.load(std::memory_order_acquire) == 0;
+    };
+
+    if (!MlasThreadPoolSpinWait(WaitPolicy_.load(std::memory_order_relaxed),
+                                SpinDurationMicroseconds_.load(std::memory_order_relaxed), WorkersComplete)) {
+
+        std::unique_lock<std::mutex> Lock(Mutex_);
+
+        WorkComplete_.wait(Lock, WorkersComplete);
+    }
+
+    Work_ = nullptr;
+}
+
+void
+ThreadPool::RunIterations(
+    size_t ParticipantIndex
+    )
+/*++
+
+Routine Description:
+
+    This routine executes iterations of the active parallel loop until no
+    work remains that the thread can take.
+
+Arguments:
+
+    ParticipantIndex - Supplies the index of the work queue owned by the
+        thread. The calling thread of the loop owns the first queue.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FUNCTION_REF<void(std::ptrdiff_t)> Work = *Work_;
+    WorkQueue& Queue = Queues_[ParticipantIndex];
+
+    for (;;) {
+
+        std::ptrdiff_t Index;
+
+        if (Queue.PopFront(&Index)) {
+            Work(Index);
+            continue;
+        }
+
+        if (!WorkStealing_ || !StealIterations(ParticipantIndex)) {
+            break;
+        }
+    }
+}
+
+bool
+ThreadPool::StealIterations(
+    size_t ParticipantIndex
+    )
+/*++
+
+Routine Description:
+
+    This routine steals iterations from the work queue of another thread
+    participating in the active parallel loop and moves them to the work
+    queue of the current thread.
+
+    Every iteration that is stolen is executed by the thief, so the loop has
+    completed once every participating thread has found all queues empty.
+
+Arguments:
+
+    ParticipantIndex - Supplies the index of the work queue owned by the
+        thread.
+
+Return Value:
+
+    Returns true if iterations were stolen, else false if no work remains.
+
+--*/
+{
+    const size_t ParticipantCount = ParticipatingWorkers_ + 1;
+
+    for (size_t Offset = 1; Offset < ParticipantCount; Offset++) {
+
+        const size_t VictimIndex = (ParticipantIndex + Offset) % ParticipantCount;
+
+        uint32_t Begin;
+        uint32_t End;
+
+        if (Queues_[VictimIndex].StealBack(&Begin, &End)) {
+            Queues_[ParticipantIndex].Reset(Begin, End);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+ThreadPool::WorkerMain(
+    size_t WorkerIndex
+    )
+/*++
+
+Routine Description:
+
+    This routine is the entry point for a worker thread.
+
+Arguments:
+
+    WorkerIndex - Supplies the index of the worker thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasCurrentThreadPool = this;
+
+    if (Hybrid_ || Numa_) {
+        MlasSetCurrentThreadAffinity(Hybrid_ ? WorkerCoreTypes_[WorkerIndex] : mlas_core_unknown,
+                                     Numa_ ? WorkerNumaNodes_[WorkerIndex] : -1);
+    }
+
+    uint64_t ObservedGeneration = 0;
+
+    for (;;) {
+
+        //
+        // Wait for a new parallel loop, first by polling the generation
+        // according to the wait policy and then by sleeping.
+        //
+
+        auto WorkAvailable = [&]() {
+            return Shutdown_.load(std::memory_order_acquire) ||
+                Generation_.load(std::memory_order_acquire) != ObservedGeneration;
+        };
+
+        if (!MlasThreadPoolSpinWait(WaitPolicy_.load(std::memory_order_relaxed),
+                                    SpinDurationMicroseconds_.load(std::memory_order_relaxed), WorkAvailable)) {
+
+            std::unique_lock<std::mutex> Lock(Mutex_);
+
+            SleepingWorkers_++;
+            WorkAvailable_.wait(Lock, WorkAvailable);
+            SleepingWorkers_--;
+        }
+
+        if (Shutdown_.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        ObservedGeneration = Generation_.load(std::memory_order_acquire);
+
+        if (WorkerIndex >= size_t(uint32_t(ObservedGeneration))) {
+            continue;
+        }
+
+        RunIterations(WorkerIndex + 1);
+
+        //
+        // Signal the calling thread if this is the last worker thread to
+        // finish. The mutex orders the signal with a calling thread that is
+        // about to sleep.
+        //
+
+        if (ActiveWorkers_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            {
+                std::lock_guard<std::mutex> Lock(Mutex_);
+            }
+            WorkComplete_.notify_one();
+        }
+    }
+}
+
+void
+ThreadPool::DispatcherMain(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine is the entry point for the dispatcher thread. Tasks are
+    executed in the order they were scheduled. Tasks that are still queued
+    when the pool is destroyed are executed before the thread exits.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (;;) {
+
+        MLAS_TASK* Task;
+
+        {
+            std::unique_lock<std::mutex> Lock(TaskMutex_);
+
+            TaskAvailable_.wait(Lock, [this]() { return DispatcherShutdown_ || !Tasks_.empty(); });
+
+            if (Tasks_.empty()) {
+                break;
+            }
+
+            Task = Tasks_.front();
+            Tasks_.pop_front();
+        }
+
+        if (Task->Predecessor != nullptr) {
+            MlasWaitTask(Task->Predecessor);
+            MlasReleaseTask(Task->Predecessor);
+            Task->Predecessor = nullptr;
+        }
+
+        Task->Work();
+        Task->Work = nullptr;
+
+        //
+        // Signal any waiting threads. The mutex orders the signal with a
+        // thread that is about to sleep.
+        //
+
+        {
+            std::lock_guard<std::mutex> Lock(Task->Mutex);
+            Task->Complete.store(true, std::memory_order_release);
+        }
+
+        Task->Completed.notify_all();
+
+        MlasReleaseTask(Task);
+    }
+}
+
+}  // namespace concurrency
+}  // namespace onnxruntime
+
+MLAS_TASK*
+MlasScheduleTask(
+    onnxruntime::concurrency::ThreadPool* ThreadPool,
+    MLAS_TASK* Predecessor,
+    std::function<void()> Work
+    )
+/*++
+
+Routine Description:
+
+    This routine creates a task for an asynchronous operation and schedules
+    the task on the dispatcher thread of the thread pool.
+
+Arguments:
+
+    ThreadPool - Supplies the thread pool object, or nullptr to select the
+        default thread pool.
+
+    Predecessor - Optionally supplies a task that must complete before the
+        work starts.
+
+    Work - Supplies the work of the operation.
+
+Return Value:
+
+    Returns the task, to be released by MlasReleaseTask.
+
+--*/
+{
+    if (ThreadPool == nullptr) {
+        ThreadPool = onnxruntime::concurrency::ThreadPool::GetDefaultThreadPool();
+    }
+
+    MLAS_TASK* Task = new MLAS_TASK;
+
+    Task->Work = std::move(Work);
+
+    //
+    // The task holds a reference to the predecessor, so the caller may
+    // release the predecessor before the task starts.
+    //
+
+    if (Predecessor != nullptr) {
+        Predecessor->ReferenceCount.fetch_add(1, std::memory_order_relaxed);
+        Task->Predecessor = Predecessor;
+    }
+
+    ThreadPool->Schedule(Task);
+
+    return Task;
+}
+
+void
+MLASCALL
+MlasWaitTask(
+    MLAS_TASK* Task
+    )
+/*++
+
+Routine Description:
+
+    This routine waits for an asynchronous operation to complete.
+
+Arguments:
+
+    Task - Supplies the task of the operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Task->Complete.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> Lock(Task->Mutex);
+
+    Task->Completed.wait(Lock, [Task]() { return Task->Complete.load(std::memory_order_acquire); });
+}
+
+bool
+MLASCALL
+MlasIsTaskComplete(
+    const MLAS_TASK* Task
+    )
+/*++
+
+Routine Description:
+
+    This routine returns whether an asynchronous operation has completed
+    without waiting.
+
+Arguments:
+
+    Task - Supplies the task of the operation.
+
+Return Value:
+
+    Returns true if the operation has completed.
+
+--*/
+{
+    return Task->Complete.load(std::memory_order_acquire);
+}
+
+void
+MLASCALL
+MlasReleaseTask(
+    MLAS_TASK* Task
+    )
+/*++
+
+Routine Description:
+
+    This routine releases the handle to an asynchronous operation. Releasing
+    the handle does not cancel the operation.
+
+Arguments:
+
+    Task - Supplies the task of the operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Task->ReferenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete Task;
+    }
+}
+
+MLAS_THREADPOOL*
+MLASCALL
+MlasCreateThreadPool(
+    size_t ThreadCount
+    )
+/*++
+
+Routine Description:
+
+    This routine creates a thread pool object.
+
+Arguments:
+
+    ThreadCount - Supplies the number of threads that participate in a
+        parallel operation, including the calling thread. Zero selects the
+        number of hardware threads.
+
+Return Value:
+
+    Returns the thread pool object.
+
+--*/
+{
+    return new MLAS_THREADPOOL(int(ThreadCount));
+}
+
+void
+MLASCALL
+MlasDestroyThreadPool(
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine destroys a thread pool object created by MlasCreateThreadPool.
+
+Arguments:
+
+    ThreadPool - Supplies the thread pool object.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    delete ThreadPool;
+}
+
+void
+MLASCALL
+MlasSetThreadPoolSchedule(
+    MLAS_THREADPOOL* ThreadPool,
+    MLAS_THREADPOOL_SCHEDULE Schedule
+    )
+/*++
+
+Routine Description:
+
+    This routine selects how the thread pool distributes the iterations of a
+    parallel loop.
+
+Arguments:
+
+    ThreadPool - Supplies the thread pool object, or nullptr to select the
+        default thread pool.
+
+    Schedule - Supplies the schedule for subsequent parallel loops.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (ThreadPool == nullptr) {
+        ThreadPool = MLAS_THREADPOOL::GetDefaultThreadPool();
+    }
+
+    ThreadPool->SetSchedule(Schedule);
+}
+
+void
+MLASCALL
+MlasSetThreadPoolWaitPolicy(
+    MLAS_THREADPOOL* ThreadPool,
+    MLAS_THREADPOOL_WAIT_POLICY WaitPolicy,
+    uint32_t SpinDurationMicroseconds
+    )
+/*++
+
+Routine Description:
+
+    This routine selects how idle threads of the thread pool wait for work.
+
+Arguments:
+
+    ThreadPool - Supplies the thread pool object, or nullptr to select the
+        default thread pool.
+
+    WaitPolicy - Supplies the wait policy.
+
+    SpinDurationMicroseconds - Supplies the time to spin before sleeping.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (ThreadPool == nullptr) {
+        ThreadPool = MLAS_THREADPOOL::GetDefaultThreadPool();
+    }
+
+    ThreadPool->SetWaitPolicy(WaitPolicy, SpinDurationMicroseconds);
+}
+
+#endif
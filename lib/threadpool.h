@@ -0,0 +1,296 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    threadpool.h
+
+Abstract:
+
+    This module contains the thread pool implementation that is used when
+    building MLAS outside of the ONNX Runtime source tree.
+
+    The class implements the subset of the ONNX Runtime thread pool contract
+    that is used by this library, so the threading support routines do not
+    need to distinguish between the two configurations.
+
+    Parallel loops are scheduled with per-thread work queues. Each thread
+    starts with a contiguous share of the iterations and threads that run out
+    of work steal from the queues of slower threads. On hybrid processors,
+    worker threads are bound to a core type and the initial shares are
+    proportional to the capacity of the cores. On NUMA systems, worker threads
+    are divided evenly across the nodes and bound to the processors of their
+    node.
+
+    Idle worker threads spin for a short time before sleeping, so loops that
+    are submitted back to back do not pay the latency of waking a thread.
+
+    Asynchronous operations are queued to a dispatcher thread that is created
+    on first use. The dispatcher executes the operations in submission order
+    and submits their parallel loops to the pool in place of the caller.
+
+--*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//
+// Define the default time that idle threads spin before sleeping.
+//
+
+#define MLAS_THREADPOOL_DEFAULT_SPIN_DURATION_US 50
+
+//
+// Stores the state of an asynchronous operation. The task is referenced by
+// the caller's handle and by the thread pool until it has executed.
+//
+
+struct MLAS_TASK {
+  std::function<void()> Work;
+  MLAS_TASK* Predecessor{nullptr};
+  std::atomic<uint32_t> ReferenceCount{2};
+  std::atomic<bool> Complete{false};
+  std::mutex Mutex;
+  std::condition_variable Completed;
+};
+
+namespace onnxruntime {
+namespace concurrency {
+
+class ThreadPool {
+ public:
+  //
+  // Creates a thread pool with the specified degree of parallelism. The
+  // calling thread of a parallel loop participates in the loop, so the pool
+  // creates one less worker thread than the degree of parallelism.
+  //
+
+  explicit ThreadPool(int DegreeOfParallelism);
+
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  //
+  // Returns the number of threads that participate in a parallel loop. A null
+  // thread pool refers to the process wide default thread pool.
+  //
+
+  static int
+  DegreeOfParallelism(
+      const ThreadPool* tp);
+
+  //
+  // Executes the function for each index in [0, total). The call returns once
+  // all iterations have completed. A null thread pool refers to the process
+  // wide default thread pool.
+  //
+  // N.B. The function is accepted by reference rather than as a
+  // std::function, so submitting a loop never allocates.
+  //
+
+  static void
+  TrySimpleParallelFor(
+      ThreadPool* tp,
+      std::ptrdiff_t total,
+      MLAS_FUNCTION_REF<void(std::ptrdiff_t)> fn);
+
+  //
+  // Returns the process wide default thread pool. The pool is sized from the
+  // MLAS_NUM_THREADS environment variable if present, else from the number of
+  // hardware threads.
+  //
+
+  static ThreadPool*
+  GetDefaultThreadPool(
+      void);
+
+  //
+  // Queues the task to the dispatcher thread of the pool. The dispatcher
+  // waits for the predecessor of the task, if any, then executes the task.
+  //
+
+  void
+  Schedule(
+      MLAS_TASK* Task);
+
+  void
+  SetSchedule(
+      MLAS_THREADPOOL_SCHEDULE Schedule) {
+    Schedule_.store(Schedule, std::memory_order_relaxed);
+  }
+
+  void
+  SetWaitPolicy(
+      MLAS_THREADPOOL_WAIT_POLICY WaitPolicy,
+      uint32_t SpinDurationMicroseconds) {
+    WaitPolicy_.store(WaitPolicy, std::memory_order_relaxed);
+    SpinDurationMicroseconds_.store(SpinDurationMicroseconds, std::memory_order_relaxed);
+  }
+
+ private:
+  //
+  // Stores the range of iterations [Begin, End) that is owned by a thread
+  // participating in a parallel loop. The owning thread takes iterations from
+  // the front of the range and other threads steal from the back of the
+  // range. Both bounds are packed into a single word so that either operation
+  // is a single compare and swap.
+  //
+
+  struct WorkQueue {
+    std::atomic<uint64_t> Range{0};
+    uint8_t Padding[64 - sizeof(std::atomic<uint64_t>)];
+
+    void
+    Reset(
+        uint32_t Begin,
+        uint32_t End) {
+      Range.store((uint64_t(End) << 32) | Begin, std::memory_order_release);
+    }
+
+    bool
+    PopFront(
+        std::ptrdiff_t* Index);
+
+    bool
+    StealBack(
+        uint32_t* Begin,
+        uint32_t* End);
+  };
+
+  void
+  ParallelFor(
+      std::ptrdiff_t Iterations,
+      MLAS_FUNCTION_REF<void(std::ptrdiff_t)> Work);
+
+  void
+  RunIterations(
+      size_t ParticipantIndex);
+
+  bool
+  StealIterations(
+      size_t ParticipantIndex);
+
+  void
+  WorkerMain(
+      size_t WorkerIndex);
+
+  void
+  DispatcherMain(
+      void);
+
+  std::vector<std::thread> Workers_;
+
+  //
+  // Stores the core type and capacity assigned to each worker thread on a
+  // hybrid processor.
+  //
+
+  bool Hybrid_{false};
+  std::vector<MlasCoreType> WorkerCoreTypes_;
+  std::vector<uint32_t> WorkerCapacities_;
+
+  //
+  // Stores the NUMA node assigned to each worker thread if the system has
+  // multiple NUMA nodes.
+  //
+
+  bool Numa_{false};
+  std::vector<int32_t> WorkerNumaNodes_;
+
+  //
+  // Stores a work queue for the calling thread followed by a work queue for
+  // each worker thread.
+  //
+
+  std::unique_ptr<WorkQueue[]> Queues_;
+
+  std::atomic<MLAS_THREADPOOL_SCHEDULE> Schedule_{MlasThreadPoolScheduleWorkStealing};
+
+  //
+  // Stores how idle worker threads wait for a parallel loop and how the
+  // calling thread waits for the worker threads to finish a loop.
+  //
+
+  std::atomic<MLAS_THREADPOOL_WAIT_POLICY> WaitPolicy_{MlasThreadPoolWaitSpinThenYield};
+  std::atomic<uint32_t> SpinDurationMicroseconds_{MLAS_THREADPOOL_DEFAULT_SPIN_DURATION_US};
+
+  //
+  // Serializes parallel loops submitted by different external threads.
+  //
+
+  std::mutex SubmitMutex_;
+
+  //
+  // Stores the sequence number of the latest parallel loop in the upper 32
+  // bits and the number of worker threads participating in the loop in the
+  // lower 32 bits. Spinning worker threads poll this value to detect new
+  // work without acquiring the mutex.
+  //
+
+  std::atomic<uint64_t> Generation_{0};
+  std::atomic<size_t> ActiveWorkers_{0};
+  std::atomic<bool> Shutdown_{false};
+
+  //
+  // Used by worker threads to sleep until a parallel loop is available and
+  // by the calling thread to sleep until the worker threads have finished.
+  // The number of sleeping worker threads is protected by the mutex and
+  // allows the calling thread to skip the wake up when all workers are
+  // spinning.
+  //
+
+  std::mutex Mutex_;
+  std::condition_variable WorkAvailable_;
+  std::condition_variable WorkComplete_;
+  size_t SleepingWorkers_{0};
+
+  //
+  // State of the active parallel loop. The state is written before the loop
+  // is published through the generation and is only read by the threads
+  // participating in the loop.
+  //
+
+  const MLAS_FUNCTION_REF<void(std::ptrdiff_t)>* Work_{nullptr};
+  size_t ParticipatingWorkers_{0};
+  bool WorkStealing_{false};
+
+  //
+  // State of the dispatcher thread that executes asynchronous operations.
+  // The thread is created when the first task is scheduled.
+  //
+
+  std::mutex TaskMutex_;
+  std::condition_variable TaskAvailable_;
+  std::deque<MLAS_TASK*> Tasks_;
+  std::thread Dispatcher_;
+  bool DispatcherShutdown_{false};
+};
+
+}  // namespace concurrency
+}  // namespace onnxruntime
+
+//
+// Creates a task that executes the work on the dispatcher thread of the
+// thread pool once the predecessor task, if any, has completed.
+//
+
+MLAS_TASK*
+MlasScheduleTask(
+    onnxruntime::concurrency::ThreadPool* ThreadPool,
+    MLAS_TASK* Predecessor,
+    std::function<void()> Work);
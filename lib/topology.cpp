@@ -0,0 +1,616 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    topology.cpp
+
+Abstract:
+
+    This module implements the detection of the processor topology that is
+    used to schedule work across threads.
+
+    On Linux, hybrid processors are detected from sysfs. Kernels that report
+    asymmetric capacities export cpu_capacity for each logical processor (for
+    example, ARM big.LITTLE). Intel hybrid processors export the logical
+    processors of each core type through the cpu_core and cpu_atom PMU
+    devices.
+
+    The NUMA nodes of the processors are also read from sysfs. Memory is
+    bound to nodes with the mbind system call, so the library does not
+    depend on libnuma.
+
+--*/
+
+#include "mlasi.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+//
+// Stores the NUMA node that the current thread is assigned to, or -1 if the
+// thread is not assigned to a node.
+//
+
+static thread_local int32_t MlasCurrentThreadNumaNode = -1;
+
+//
+// Define the capacity to assume for an efficient core relative to a
+// performance core when the operating system does not report capacities.
+// Efficient cores execute 256-bit vector instructions at half rate and at
+// a lower frequency, so this is an estimate of the throughput of the GEMM
+// kernels rather than of scalar code.
+//
+
+#define MLAS_LITTLE_CORE_CAPACITY (MLAS_CPU_CAPACITY_SCALE / 2)
+
+#if defined(__linux__)
+
+bool
+MlasReadSysfsValue(
+    const char* Path,
+    char* Buffer,
+    size_t BufferLength
+    )
+/*++
+
+Routine Description:
+
+    This routine reads the first line of a sysfs file.
+
+Arguments:
+
+    Path - Supplies the path of the file.
+
+    Buffer - Receives the contents of the file.
+
+    BufferLength - Supplies the length of the buffer.
+
+Return Value:
+
+    Returns true if the file was read, else false.
+
+--*/
+{
+    FILE* File = fopen(Path, "r");
+
+    if (File == nullptr) {
+        return false;
+    }
+
+    bool Succeeded = (fgets(Buffer, int(BufferLength), File) != nullptr);
+
+    fclose(File);
+
+    return Succeeded;
+}
+
+bool
+MlasReadSysfsCpuList(
+    const char* Path,
+    std::vector<bool>& CpuSet
+    )
+/*++
+
+Routine Description:
+
+    This routine reads a sysfs file that contains a list of logical
+    processors in the kernel's list format, for example "0-7,16-23".
+
+Arguments:
+
+    Path - Supplies the path of the file.
+
+    CpuSet - Receives a flag for each logical processor in the list.
+
+Return Value:
+
+    Returns true if the file was read, else false.
+
+--*/
+{
+    char Buffer[1024];
+
+    if (!MlasReadSysfsValue(Path, Buffer, sizeof(Buffer))) {
+        return false;
+    }
+
+    const char* p = Buffer;
+
+    while (*p >= '0' && *p <= '9') {
+
+        char* End;
+        unsigned long First = strtoul(p, &End, 10);
+        unsigned long Last = First;
+
+        p = End;
+
+        if (*p == '-') {
+            Last = strtoul(p + 1, &End, 10);
+            p = End;
+        }
+
+        for (unsigned long Cpu = First; Cpu <= Last && Cpu < CPU_SETSIZE; Cpu++) {
+            if (Cpu >= CpuSet.size()) {
+                CpuSet.resize(Cpu + 1, false);
+            }
+            CpuSet[Cpu] = true;
+        }
+
+        if (*p == ',') {
+            p++;
+        }
+    }
+
+    return true;
+}
+
+void
+MlasDetectCpuTopology(
+    MLAS_CPU_TOPOLOGY* Topology
+    )
+/*++
+
+Routine Description:
+
+    This routine detects the logical processors available to the process
+    and their core types from sysfs.
+
+Arguments:
+
+    Topology - Receives the processor topology.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    cpu_set_t AffinityMask;
+
+    CPU_ZERO(&AffinityMask);
+
+    if (sched_getaffinity(0, sizeof(AffinityMask), &AffinityMask) != 0) {
+        return;
+    }
+
+    for (uint32_t Cpu = 0; Cpu < CPU_SETSIZE; Cpu++) {
+        if (CPU_ISSET(Cpu, &AffinityMask)) {
+            Topology->Cpus.push_back({Cpu, mlas_core_unknown, MLAS_CPU_CAPACITY_SCALE, 0});
+        }
+    }
+
+    //
+    // Use the capacities reported by the kernel if available.
+    //
+
+    uint32_t MaximumCapacity = 0;
+    bool HasCapacity = !Topology->Cpus.empty();
+
+    for (auto& CpuInfo : Topology->Cpus) {
+
+        char Path[128];
+        char Buffer[32];
+
+        snprintf(Path, sizeof(Path), "/sys/devices/system/cpu/cpu%u/cpu_capacity", CpuInfo.Index);
+
+        if (!MlasReadSysfsValue(Path, Buffer, sizeof(Buffer))) {
+            HasCapacity = false;
+            break;
+        }
+
+        CpuInfo.Capacity = uint32_t(strtoul(Buffer, nullptr, 10));
+        MaximumCapacity = std::max(MaximumCapacity, CpuInfo.Capacity);
+    }
+
+    if (HasCapacity && MaximumCapacity != 0) {
+
+        for (auto& CpuInfo : Topology->Cpus) {
+            CpuInfo.Capacity = uint32_t(uint64_t(CpuInfo.Capacity) * MLAS_CPU_CAPACITY_SCALE / MaximumCapacity);
+            CpuInfo.CoreType = (CpuInfo.Capacity == MLAS_CPU_CAPACITY_SCALE) ? mlas_core_big : mlas_core_little;
+            Topology->IsHybrid |= (CpuInfo.CoreType == mlas_core_little);
+        }
+
+        return;
+    }
+
+    //
+    // Otherwise, use the core type PMU devices of Intel hybrid processors.
+    //
+
+    std::vector<bool> BigCores;
+    std::vector<bool> LittleCores;
+
+    if (!MlasReadSysfsCpuList("/sys/devices/cpu_core/cpus", BigCores) ||
+        !MlasReadSysfsCpuList("/sys/devices/cpu_atom/cpus", LittleCores)) {
+
+        for (auto& CpuInfo : Topology->Cpus) {
+            CpuInfo.Capacity = MLAS_CPU_CAPACITY_SCALE;
+        }
+
+        return;
+    }
+
+    for (auto& CpuInfo : Topology->Cpus) {
+
+        if (CpuInfo.Index < LittleCores.size() && LittleCores[CpuInfo.Index]) {
+            CpuInfo.CoreType = mlas_core_little;
+            CpuInfo.Capacity = MLAS_LITTLE_CORE_CAPACITY;
+            Topology->IsHybrid = true;
+        } else {
+            CpuInfo.CoreType = (CpuInfo.Index < BigCores.size() && BigCores[CpuInfo.Index]) ? mlas_core_big : mlas_core_unknown;
+            CpuInfo.Capacity = MLAS_CPU_CAPACITY_SCALE;
+        }
+    }
+}
+
+void
+MlasDetectNumaTopology(
+    MLAS_CPU_TOPOLOGY* Topology
+    )
+/*++
+
+Routine Description:
+
+    This routine detects the NUMA node of each logical processor available
+    to the process from sysfs. Nodes without an available processor are
+    ignored.
+
+Arguments:
+
+    Topology - Supplies the processor topology and receives the NUMA nodes.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    std::vector<bool> OnlineNodes;
+
+    if (!MlasReadSysfsCpuList("/sys/devices/system/node/online", OnlineNodes)) {
+        return;
+    }
+
+    for (uint32_t NodeId = 0; NodeId < OnlineNodes.size(); NodeId++) {
+
+        if (!OnlineNodes[NodeId]) {
+            continue;
+        }
+
+        char Path[128];
+        std::vector<bool> NodeCpus;
+
+        snprintf(Path, sizeof(Path), "/sys/devices/system/node/node%u/cpulist", NodeId);
+
+        if (!MlasReadSysfsCpuList(Path, NodeCpus)) {
+            continue;
+        }
+
+        const uint32_t NodeIndex = uint32_t(Topology->NumaNodeIds.size());
+        bool HasCpu = false;
+
+        for (auto& CpuInfo : Topology->Cpus) {
+            if (CpuInfo.Index < NodeCpus.size() && NodeCpus[CpuInfo.Index]) {
+                CpuInfo.NumaNode = NodeIndex;
+                HasCpu = true;
+            }
+        }
+
+        if (HasCpu) {
+            Topology->NumaNodeIds.push_back(NodeId);
+        }
+    }
+}
+
+#endif
+
+const MLAS_CPU_TOPOLOGY&
+MlasGetCpuTopology(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the topology of the logical processors that are
+    available to the process. The topology is detected on first use.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the processor topology.
+
+--*/
+{
+    static const MLAS_CPU_TOPOLOGY Topology = []() {
+        MLAS_CPU_TOPOLOGY Topology;
+        Topology.IsHybrid = false;
+        Topology.IsNumaSimulated = false;
+#if defined(__linux__)
+        MlasDetectCpuTopology(&Topology);
+#endif
+
+        //
+        // Simulate the requested number of NUMA nodes by dividing the
+        // processors into contiguous groups, else detect the NUMA nodes.
+        //
+
+        const char* SimulatedNodes = std::getenv("MLAS_NUMA_NODES");
+
+        if (SimulatedNodes != nullptr && std::atoi(SimulatedNodes) > 0) {
+
+            const size_t NodeCount = size_t(std::atoi(SimulatedNodes));
+
+            for (size_t NodeIndex = 0; NodeIndex < NodeCount; NodeIndex++) {
+                Topology.NumaNodeIds.push_back(uint32_t(NodeIndex));
+            }
+
+            for (size_t CpuIndex = 0; CpuIndex < Topology.Cpus.size(); CpuIndex++) {
+                Topology.Cpus[CpuIndex].NumaNode = uint32_t(CpuIndex * NodeCount / Topology.Cpus.size());
+            }
+
+            Topology.IsNumaSimulated = true;
+
+        } else {
+#if defined(__linux__)
+            MlasDetectNumaTopology(&Topology);
+#endif
+        }
+
+        //
+        // Fall back to a single node that contains all processors.
+        //
+
+        if (Topology.NumaNodeIds.empty()) {
+
+            Topology.NumaNodeIds.push_back(0);
+
+            for (auto& CpuInfo : Topology.Cpus) {
+                CpuInfo.NumaNode = 0;
+            }
+        }
+
+        return Topology;
+    }();
+
+    return Topology;
+}
+
+uint32_t
+MlasGetCurrentCpuCapacity(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the capacity of the logical processor that is
+    executing the current thread.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the capacity relative to MLAS_CPU_CAPACITY_SCALE.
+
+--*/
+{
+#if defined(__linux__)
+    const MLAS_CPU_TOPOLOGY& Topology = MlasGetCpuTopology();
+
+    if (Topology.IsHybrid) {
+
+        const int Cpu = sched_getcpu();
+
+        auto CpuInfo = std::lower_bound(Topology.Cpus.begin(), Topology.Cpus.end(), uint32_t(Cpu),
+            [](const MLAS_CPU_INFO& Info, uint32_t Index) { return Info.Index < Index; });
+
+        if (Cpu >= 0 && CpuInfo != Topology.Cpus.end() && CpuInfo->Index == uint32_t(Cpu)) {
+            return CpuInfo->Capacity;
+        }
+    }
+#endif
+
+    return MLAS_CPU_CAPACITY_SCALE;
+}
+
+uint32_t
+MlasGetCurrentNumaNode(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the NUMA node of the current thread. Thread pool
+    worker threads are assigned to a node, else the node is derived from
+    the logical processor that is executing the thread.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the index of the node in MLAS_CPU_TOPOLOGY::NumaNodeIds.
+
+--*/
+{
+    if (MlasCurrentThreadNumaNode >= 0) {
+        return uint32_t(MlasCurrentThreadNumaNode);
+    }
+
+#if defined(__linux__)
+    const MLAS_CPU_TOPOLOGY& Topology = MlasGetCpuTopology();
+
+    if (Topology.NumaNodeIds.size() > 1) {
+
+        const int Cpu = sched_getcpu();
+
+        auto CpuInfo = std::lower_bound(Topology.Cpus.begin(), Topology.Cpus.end(), uint32_t(Cpu),
+            [](const MLAS_CPU_INFO& Info, uint32_t Index) { return Info.Index < Index; });
+
+        if (Cpu >= 0 && CpuInfo != Topology.Cpus.end() && CpuInfo->Index == uint32_t(Cpu)) {
+            return CpuInfo->NumaNode;
+        }
+    }
+#endif
+
+    return 0;
+}
+
+bool
+MlasSetCurrentThreadAffinity(
+    MlasCoreType CoreType,
+    int32_t NumaNode
+    )
+/*++
+
+Routine Description:
+
+    This routine restricts the current thread to the logical processors of
+    the specified core type and NUMA node.
+
+Arguments:
+
+    CoreType - Supplies the core type, or mlas_core_unknown to allow any core
+        type.
+
+    NumaNode - Supplies the index of the NUMA node, or -1 to allow any node.
+        The thread is assigned to the node even if the affinity cannot be
+        changed, for example for a simulated node without processors.
+
+Return Value:
+
+    Returns true if the affinity of the thread was changed, else false.
+
+--*/
+{
+    if (NumaNode >= 0) {
+        MlasCurrentThreadNumaNode = NumaNode;
+    }
+
+#if defined(__linux__)
+    cpu_set_t AffinityMask;
+
+    CPU_ZERO(&AffinityMask);
+
+    bool HasCpu = false;
+
+    for (const auto& CpuInfo : MlasGetCpuTopology().Cpus) {
+        if ((CoreType == mlas_core_unknown || CpuInfo.CoreType == CoreType) &&
+            (NumaNode < 0 || CpuInfo.NumaNode == uint32_t(NumaNode))) {
+            CPU_SET(CpuInfo.Index, &AffinityMask);
+            HasCpu = true;
+        }
+    }
+
+    return HasCpu && sched_setaffinity(0, sizeof(AffinityMask), &AffinityMask) == 0;
+#else
+    MLAS_UNREFERENCED_PARAMETER(CoreType);
+
+    return false;
+#endif
+}
+
+void
+MlasBindMemoryToNumaNode(
+    void* Buffer,
+    size_t BufferSize,
+    int32_t NumaNode
+    )
+/*++
+
+Routine Description:
+
+    This routine sets the memory policy of the pages of a buffer so that the
+    pages are placed on a NUMA node or interleaved across all NUMA nodes.
+    Pages that are already present are migrated. Pages that are only
+    partially covered by the buffer are not changed.
+
+    This is a hint: the routine does nothing if the topology is simulated,
+    has a single node, or the policy cannot be applied.
+
+Arguments:
+
+    Buffer - Supplies the address of the buffer.
+
+    BufferSize - Supplies the size of the buffer in bytes.
+
+    NumaNode - Supplies the index of the NUMA node, or -1 to interleave the
+        pages across all nodes.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    const MLAS_CPU_TOPOLOGY& Topology = MlasGetCpuTopology();
+
+    if (Topology.IsNumaSimulated || Topology.NumaNodeIds.size() <= 1) {
+        return;
+    }
+
+    const uintptr_t PageSize = uintptr_t(sysconf(_SC_PAGESIZE));
+    const uintptr_t Start = (uintptr_t(Buffer) + PageSize - 1) & ~(PageSize - 1);
+    const uintptr_t End = (uintptr_t(Buffer) + BufferSize) & ~(PageSize - 1);
+
+    if (Start >= End) {
+        return;
+    }
+
+    //
+    // Build the mask of operating system node identifiers.
+    //
+
+    constexpr size_t BitsPerMask = sizeof(unsigned long) * 8;
+    constexpr size_t MaximumNodes = 1024;
+
+    unsigned long NodeMask[MaximumNodes / BitsPerMask] = {};
+
+    for (size_t NodeIndex = 0; NodeIndex < Topology.NumaNodeIds.size(); NodeIndex++) {
+
+        if (NumaNode >= 0 && NodeIndex != size_t(NumaNode)) {
+            continue;
+        }
+
+        const uint32_t NodeId = Topology.NumaNodeIds[NodeIndex];
+
+        if (NodeId < MaximumNodes) {
+            NodeMask[NodeId / BitsPerMask] |= 1UL << (NodeId % BitsPerMask);
+        }
+    }
+
+    //
+    // N.B. These values match the definitions from linux/mempolicy.h.
+    //
+
+    const int MpolPreferred = 1;
+    const int MpolInterleave = 3;
+    const unsigned MpolMfMove = 1 << 1;
+
+    syscall(SYS_mbind, Start, End - Start, (NumaNode >= 0) ? MpolPreferred : MpolInterleave,
+            NodeMask, MaximumNodes + 1, MpolMfMove);
+#else
+    MLAS_UNREFERENCED_PARAMETER(Buffer);
+    MLAS_UNREFERENCED_PARAMETER(BufferSize);
+    MLAS_UNREFERENCED_PARAMETER(NumaNode);
+#endif
+}
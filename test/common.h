@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <utility>
+#include <vector>
 
 inline std::pair<float, float> get_min_max(float* input, int n) {
   float xmin = 1e20f;
@@ -28,3 +30,92 @@ inline float get_max_diff(float* A, float* B, int n) {
 
   return diff;
 }
+
+// C = A * B
+inline void sgemm_ref(const float* A, const float* B, float* C, int m, int n, int k) {
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < n; ++j) {
+      float sum = 0;
+      for (int p = 0; p < k; ++p) {
+        sum += A[i * k + p] * B[p * n + j];
+      }
+      C[i * n + j] = sum;
+    }
+  }
+}
+
+// Fills the buffer with the repeating pattern (i % period) / period + offset.
+// The tests fill their operands with different periods, so that the products
+// do not repeat along a row.
+inline void fill_pattern(std::vector<float>& data, int period, float offset = 0.0f) {
+  for (size_t i = 0; i < data.size(); ++i) data[i] = float(i % period) / period + offset;
+}
+
+struct conv2d_shape {
+  int batch;
+  int groups;
+  int channels;  // per group
+  int filters;   // per group
+  int height;
+  int width;
+  int kernel_h;
+  int kernel_w;
+  int stride;
+  int dilation;
+  int pads[4];  // top, left, bottom, right
+};
+
+inline int conv2d_output_height(const conv2d_shape& s) {
+  return (s.height + s.pads[0] + s.pads[2] - s.dilation * (s.kernel_h - 1) - 1) / s.stride + 1;
+}
+
+inline int conv2d_output_width(const conv2d_shape& s) {
+  return (s.width + s.pads[1] + s.pads[3] - s.dilation * (s.kernel_w - 1) - 1) / s.stride + 1;
+}
+
+// Direct 2D convolution with groups and bias, accumulated into the output
+// scaled by beta. The tensors are NCHW, or NHWC if channels_last is set, and
+// the filter is OIHW.
+inline void conv2d_ref(const conv2d_shape& s, const float* input, const float* filter, const float* bias, float beta,
+                       float* output, bool channels_last = false) {
+  const int out_h = conv2d_output_height(s);
+  const int out_w = conv2d_output_width(s);
+  const size_t in_channels = size_t(s.groups) * s.channels;
+  const size_t out_channels = size_t(s.groups) * s.filters;
+
+  // element strides of a channel and of a pixel in each layout
+  const size_t in_channel_stride = channels_last ? 1 : size_t(s.height) * s.width;
+  const size_t in_pixel_stride = channels_last ? in_channels : 1;
+  const size_t out_channel_stride = channels_last ? 1 : size_t(out_h) * out_w;
+  const size_t out_pixel_stride = channels_last ? out_channels : 1;
+
+  for (int n = 0; n < s.batch; ++n) {
+    const float* in = input + size_t(n) * in_channels * s.height * s.width;
+    float* out = output + size_t(n) * out_channels * out_h * out_w;
+    for (int g = 0; g < s.groups; ++g) {
+      for (int f = 0; f < s.filters; ++f) {
+        const size_t oc = size_t(g) * s.filters + f;
+        const float* w = filter + oc * s.channels * s.kernel_h * s.kernel_w;
+        for (int oy = 0; oy < out_h; ++oy) {
+          for (int ox = 0; ox < out_w; ++ox) {
+            float sum = (bias != nullptr) ? bias[oc] : 0.0f;
+            for (int c = 0; c < s.channels; ++c) {
+              const size_t ic = size_t(g) * s.channels + c;
+              for (int ky = 0; ky < s.kernel_h; ++ky) {
+                for (int kx = 0; kx < s.kernel_w; ++kx) {
+                  int iy = oy * s.stride + ky * s.dilation - s.pads[0];
+                  int ix = ox * s.stride + kx * s.dilation - s.pads[1];
+                  if (iy < 0 || iy >= s.height || ix < 0 || ix >= s.width) continue;
+                  sum += in[ic * in_channel_stride + (size_t(iy) * s.width + ix) * in_pixel_stride] *
+                         w[(size_t(c) * s.kernel_h + ky) * s.kernel_w + kx];
+                }
+              }
+            }
+            float& o = out[oc * out_channel_stride + (size_t(oy) * out_w + ox) * out_pixel_stride];
+            o = sum + beta * o;
+          }
+        }
+      }
+    }
+  }
+}
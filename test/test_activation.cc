@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "common.h"
+
+static float reference_activation(const MLAS_ACTIVATION& activation, float x) {
+  switch (activation.ActivationKind) {
+    case MlasIdentityActivation:
+      return x;
+    case MlasReluActivation:
+      return std::max(x, 0.0f);
+    case MlasLeakyReluActivation:
+      return x > 0.0f ? x : x * activation.Parameters.LeakyRelu.alpha;
+    case MlasTanhActivation:
+      return std::tanh(x);
+    case MlasLogisticActivation:
+      return 1.0f / (1.0f + std::exp(-x));
+    case MlasClipActivation:
+      return std::min(std::max(x, activation.Parameters.Clip.minimum), activation.Parameters.Clip.maximum);
+    case MlasHardSigmoidActivation:
+      return std::min(std::max(x * activation.Parameters.HardSigmoid.alpha + activation.Parameters.HardSigmoid.beta,
+                               0.0f),
+                      1.0f);
+    case MlasGeluErfActivation:
+      return float(0.5 * x * (1.0 + std::erf(x / std::sqrt(2.0))));
+    case MlasGeluTanhActivation:
+      return float(0.5 * x * (1.0 + std::tanh(std::sqrt(2.0 / M_PI) * (x + 0.044715 * double(x) * x * x))));
+    case MlasSiluActivation:
+      return float(x / (1.0 + std::exp(-double(x))));
+    case MlasMishActivation:
+      return float(x * std::tanh(std::log1p(std::exp(double(x)))));
+    case MlasHardSwishActivation:
+      return x * std::min(std::max(x / 6.0f + 0.5f, 0.0f), 1.0f);
+  }
+  return x;
+}
+
+static std::vector<MLAS_ACTIVATION> make_activations() {
+  std::vector<MLAS_ACTIVATION> activations;
+  MLAS_ACTIVATION activation;
+
+  for (MLAS_ACTIVATION_KIND kind : {MlasIdentityActivation, MlasReluActivation, MlasTanhActivation,
+                                    MlasLogisticActivation, MlasGeluErfActivation, MlasGeluTanhActivation,
+                                    MlasSiluActivation, MlasMishActivation, MlasHardSwishActivation}) {
+    activation.ActivationKind = kind;
+    activations.push_back(activation);
+  }
+
+  activation.ActivationKind = MlasLeakyReluActivation;
+  activation.Parameters.LeakyRelu.alpha = 0.1f;
+  activations.push_back(activation);
+
+  activation.ActivationKind = MlasClipActivation;
+  activation.Parameters.Clip.minimum = -1.5f;
+  activation.Parameters.Clip.maximum = 6.0f;
+  activations.push_back(activation);
+
+  activation.ActivationKind = MlasHardSigmoidActivation;
+  activation.Parameters.HardSigmoid.alpha = 0.2f;
+  activation.Parameters.HardSigmoid.beta = 0.5f;
+  activations.push_back(activation);
+
+  return activations;
+}
+
+// Applies the activation to a M x N matrix with a leading dimension larger
+// than N, and returns the max abs diff against the reference. The elements
+// past N of each row must be left unchanged.
+static float run_activation(const MLAS_ACTIVATION& activation, int m, int n, bool bias) {
+  const int ldc = n + 3;
+
+  std::vector<float> buffer(size_t(m) * ldc);
+  std::vector<float> bias_data(m);
+
+  // cover the saturated ranges of tanh and logistic
+  for (size_t i = 0; i < buffer.size(); ++i) buffer[i] = float(int(i % 83) - 41) * 0.6f;
+  for (int i = 0; i < m; ++i) bias_data[i] = float(i % 5) - 2.0f;
+
+  std::vector<float> expected(buffer);
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < n; ++j) {
+      float& x = expected[size_t(i) * ldc + j];
+      x = reference_activation(activation, x + (bias ? bias_data[i] : 0.0f));
+    }
+  }
+
+  MlasActivation(&activation, buffer.data(), bias ? bias_data.data() : nullptr, m, n, ldc);
+
+  return get_max_diff(expected.data(), buffer.data(), int(buffer.size()));
+}
+
+// Runs a convolution with the activation fused, and returns the max abs diff
+// against the reference activation of the output of the same convolution.
+static float run_conv_activation(MLAS_THREADPOOL* tp, const MLAS_ACTIVATION& activation, int channels, int filters,
+                                 int height, int width, bool nhwc) {
+  const int64_t input_shape[] = {height, width};
+  const int64_t kernel_shape[] = {3, 3};
+  const int64_t dilation_shape[] = {1, 1};
+  const int64_t padding[] = {1, 1, 1, 1};
+  const int64_t stride_shape[] = {1, 1};
+  const int64_t output_shape[] = {height, width};
+
+  std::vector<float> input(size_t(channels) * height * width);
+  std::vector<float> filter(size_t(filters) * channels * 9);
+  std::vector<float> bias(filters);
+
+  fill_pattern(input, 13, -0.5f);
+  fill_pattern(filter, 7, -0.5f);
+  for (size_t i = 0; i < bias.size(); ++i) bias[i] = float(i % 3) - 1.0f;
+
+  MLAS_ACTIVATION identity;
+  identity.ActivationKind = MlasIdentityActivation;
+
+  std::vector<float> expected(size_t(filters) * height * width);
+  std::vector<float> output(expected.size());
+
+  for (const MLAS_ACTIVATION* a : {static_cast<const MLAS_ACTIVATION*>(&identity), &activation}) {
+    MLAS_CONV_PARAMETERS parameters;
+    size_t working_buffer_size;
+
+    MlasConvPrepare(&parameters, 2, 1, 1, channels, input_shape, kernel_shape, dilation_shape, padding, stride_shape,
+                    output_shape, filters, a, &working_buffer_size, 0.0f, tp, nhwc);
+
+    std::vector<float> working_buffer(working_buffer_size);
+
+    MlasConv(&parameters, input.data(), filter.data(), bias.data(), working_buffer.data(),
+             a == &identity ? expected.data() : output.data(), tp);
+  }
+
+  for (float& x : expected) x = reference_activation(activation, x);
+
+  return get_max_diff(expected.data(), output.data(), int(output.size()));
+}
+
+// Runs a GEMM with a per-column bias and the activation in the epilogue, and
+// returns the max abs diff against the reference activation of the output of
+// the same GEMM with only the bias.
+static float run_gemm_activation(MLAS_THREADPOOL* tp, const MLAS_ACTIVATION& activation, int m, int n, int k) {
+  std::vector<float> a(size_t(m) * k);
+  std::vector<float> b(size_t(k) * n);
+  std::vector<float> bias(n);
+
+  fill_pattern(a, 13, -0.5f);
+  fill_pattern(b, 7, -0.5f);
+  for (size_t i = 0; i < bias.size(); ++i) bias[i] = float(i % 9) - 4.0f;
+
+  MLAS_ACTIVATION identity;
+  identity.ActivationKind = MlasIdentityActivation;
+
+  std::vector<float> expected(size_t(m) * n);
+  std::vector<float> output(expected.size());
+
+  for (const MLAS_ACTIVATION* act : {static_cast<const MLAS_ACTIVATION*>(&identity), &activation}) {
+    MLAS_SGEMM_EPILOGUE epilogue;
+    epilogue.Bias = bias.data();
+    epilogue.BiasKind = MlasSgemmBiasPerColumn;
+    epilogue.Activation = act;
+
+    MLAS_SGEMM_DATA_PARAMS data;
+    data.A = a.data();
+    data.lda = k;
+    data.B = b.data();
+    data.ldb = n;
+    data.C = act == &identity ? expected.data() : output.data();
+    data.ldc = n;
+    data.Epilogue = &epilogue;
+
+    MlasGemmBatch(CblasNoTrans, CblasNoTrans, m, n, k, &data, 1, tp);
+  }
+
+  for (float& x : expected) x = reference_activation(activation, x);
+
+  return get_max_diff(expected.data(), output.data(), int(output.size()));
+}
+
+int main() {
+  int failures = 0;
+  const float tolerance = 1e-5f;
+
+  const std::vector<MLAS_ACTIVATION> activations = make_activations();
+
+  float diff = 0.0f;
+  for (const MLAS_ACTIVATION& activation : activations) {
+    for (int n : {1, 4, 7, 64, 69}) {
+      diff = std::max(diff, run_activation(activation, 5, n, false));
+      diff = std::max(diff, run_activation(activation, 5, n, true));
+    }
+  }
+
+  std::cout << "activation: " << diff << std::endl;
+
+  if (diff > tolerance) failures++;
+
+  for (size_t threads : {1, 3}) {
+    MLAS_THREADPOOL* tp = MlasCreateThreadPool(threads);
+
+    diff = 0.0f;
+    for (const MLAS_ACTIVATION& activation : activations) {
+      diff = std::max(diff, run_conv_activation(tp, activation, 16, 24, 11, 13, false));
+      diff = std::max(diff, run_conv_activation(tp, activation, 3, 5, 9, 10, false));
+      diff = std::max(diff, run_conv_activation(tp, activation, 8, 12, 7, 9, true));
+      diff = std::max(diff, run_gemm_activation(tp, activation, 37, 51, 29));
+    }
+
+    std::cout << "threads " << threads << ", conv and gemm activation: " << diff << std::endl;
+
+    if (diff > tolerance) failures++;
+
+    MlasDestroyThreadPool(tp);
+  }
+
+  return failures == 0 ? 0 : 1;
+}
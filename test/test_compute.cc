@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "common.h"
+
+typedef void(compute_routine)(const float* input, float* output, size_t n, MLAS_THREADPOOL* tp);
+
+static double reference_logistic(double x) { return 1.0 / (1.0 + std::exp(-x)); }
+
+// Returns the max error of the routine in units of the last place of the
+// reference. Results are allowed to be flushed to zero for references below
+// tiny.
+static double run_compute(MLAS_THREADPOOL* tp, compute_routine* routine, double (*reference)(double), float lo,
+                          float hi, size_t n, double tiny) {
+  std::vector<float> input(n);
+  std::vector<float> output(n, 99.0f);
+
+  for (size_t i = 0; i < n; ++i) input[i] = lo + (hi - lo) * float(i) / float(n - 1);
+
+  routine(input.data(), output.data(), n, tp);
+
+  double error = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    const double expected = reference(input[i]);
+    if (std::fabs(expected) < tiny) {
+      if (std::fabs(output[i]) > tiny) error = std::numeric_limits<double>::infinity();
+      continue;
+    }
+    int exponent;
+    std::frexp(expected, &exponent);
+    error = std::max(error, std::fabs(output[i] - expected) / std::ldexp(1.0, exponent - 24));
+  }
+
+  return error;
+}
+
+// Checks the special values: the saturated ranges, infinities and zero.
+static bool run_special_values() {
+  const float inf = std::numeric_limits<float>::infinity();
+  const float input[] = {0.0f, -200.0f, 200.0f, -inf, inf, -90.0f, 89.0f};
+  float output[7];
+
+  MlasComputeExp(input, output, 7);
+  bool ok = output[0] == 1.0f && output[1] == 0.0f && output[2] == inf && output[3] == 0.0f && output[4] == inf &&
+            output[5] == 0.0f && output[6] == inf;
+
+  MlasComputeTanh(input, output, 5);
+  ok = ok && output[0] == 0.0f && output[1] == -1.0f && output[2] == 1.0f && output[3] == -1.0f && output[4] == 1.0f;
+
+  MlasComputeLogistic(input, output, 5);
+  ok = ok && output[0] == 0.5f && output[1] == 0.0f && output[2] == 1.0f && output[3] == 0.0f && output[4] == 1.0f;
+
+  MlasComputeErf(input, output, 5);
+  ok = ok && output[0] == 0.0f && output[1] == -1.0f && output[2] == 1.0f && output[3] == -1.0f && output[4] == 1.0f;
+
+  return ok;
+}
+
+int main() {
+  int failures = 0;
+
+  if (!run_special_values()) {
+    std::cout << "special values: failed" << std::endl;
+    failures++;
+  }
+
+  const double tiny = std::ldexp(1.0, -125);
+
+  for (size_t threads : {1, 3}) {
+    MLAS_THREADPOOL* tp = MlasCreateThreadPool(threads);
+
+    // the odd sizes cover the vector remainders and a large size is split
+    // across the threads
+    for (size_t n : {size_t(2), size_t(7), size_t(13), size_t(4099), size_t(1000003)}) {
+      double exp_error = run_compute(tp, MlasComputeExp, std::exp, -100.0f, 88.0f, n, tiny);
+      double tanh_error = run_compute(tp, MlasComputeTanh, std::tanh, -12.0f, 12.0f, n, 0.0);
+      double logistic_error = run_compute(tp, MlasComputeLogistic, reference_logistic, -90.0f, 30.0f, n, tiny);
+      double erf_error = run_compute(tp, MlasComputeErf, std::erf, -5.0f, 5.0f, n, 0.0);
+
+      std::cout << "threads " << threads << ", n " << n << ", ulp exp: " << exp_error << " tanh: " << tanh_error
+                << " logistic: " << logistic_error << " erf: " << erf_error << std::endl;
+
+      if (exp_error > 2.0 || tanh_error > 7.0 || logistic_error > 3.0 || erf_error > 5.0) failures++;
+    }
+
+    MlasDestroyThreadPool(tp);
+  }
+
+  return failures == 0 ? 0 : 1;
+}
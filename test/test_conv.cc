@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "common.h"
+
+// Returns the shape of a 2D convolution with unit stride and padding that
+// keeps the output size.
+static conv2d_shape same_shape(int channels, int filters, int height, int width, int kernel_h, int kernel_w) {
+  return {1, 1, channels, filters, height, width, kernel_h, kernel_w, 1, 1,
+          {(kernel_h - 1) / 2, (kernel_w - 1) / 2, kernel_h / 2, kernel_w / 2}};
+}
+
+// Runs the convolution on the thread pool, prepared for the prepare thread
+// pool, optionally with a packed filter, NHWC tensors and an accumulated
+// output, and returns the max abs diff against the reference implementation.
+// The convolution fails if the expected algorithm is not selected.
+static float run_conv(MLAS_THREADPOOL* tp, MLAS_THREADPOOL* prepare_tp, const conv2d_shape& s,
+                      MLAS_CONV_ALGORITHM algorithm, bool packed_filter, float beta = 0.0f,
+                      bool channels_last = false) {
+  const int out_h = conv2d_output_height(s);
+  const int out_w = conv2d_output_width(s);
+  const size_t in_channels = size_t(s.groups) * s.channels;
+  const size_t out_channels = size_t(s.groups) * s.filters;
+
+  std::vector<float> input(s.batch * in_channels * s.height * s.width);
+  std::vector<float> filter(out_channels * s.channels * s.kernel_h * s.kernel_w);
+  std::vector<float> bias(out_channels);
+  std::vector<float> output0(s.batch * out_channels * out_h * out_w);
+
+  fill_pattern(input, 13, -0.5f);
+  fill_pattern(filter, 7, -0.5f);
+  fill_pattern(bias, 3);
+  fill_pattern(output0, 5);
+
+  std::vector<float> output1(output0);
+
+  conv2d_ref(s, input.data(), filter.data(), bias.data(), beta, output0.data(), channels_last);
+
+  const int64_t input_shape[] = {s.height, s.width};
+  const int64_t kernel_shape[] = {s.kernel_h, s.kernel_w};
+  const int64_t dilation_shape[] = {s.dilation, s.dilation};
+  const int64_t padding[] = {s.pads[0], s.pads[1], s.pads[2], s.pads[3]};
+  const int64_t stride_shape[] = {s.stride, s.stride};
+  const int64_t output_shape[] = {out_h, out_w};
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+
+  MLAS_CONV_PARAMETERS parameters;
+  size_t working_buffer_size;
+
+  MlasConvPrepare(&parameters, 2, s.batch, s.groups, s.channels, input_shape, kernel_shape, dilation_shape, padding,
+                  stride_shape, output_shape, s.filters, &activation, &working_buffer_size, beta, prepare_tp,
+                  channels_last);
+
+  if (parameters.Algorithm != algorithm) {
+    std::cout << "convolution algorithm " << int(algorithm) << " not selected" << std::endl;
+    return 1.0f;
+  }
+
+  std::vector<float> working_buffer(working_buffer_size);
+
+  // the packed filter of a NHWC convolution is packed with MlasGemmPackB and
+  // must be aligned
+  const size_t alignment = MlasGetPreferredBufferAlignment();
+  std::vector<uint8_t> packed_buffer(MlasConvPackFilterSize(&parameters) + alignment);
+  float* packed = reinterpret_cast<float*>((uintptr_t(packed_buffer.data()) + alignment - 1) & ~(alignment - 1));
+  const float* conv_filter = filter.data();
+
+  if (packed_filter) {
+    MlasConvPackFilter(&parameters, filter.data(), packed);
+    parameters.FilterIsPacked = true;
+    conv_filter = packed;
+  }
+
+  MlasConv(&parameters, input.data(), conv_filter, bias.data(), working_buffer.data(), output1.data(), tp);
+
+  return get_max_diff(output0.data(), output1.data(), int(output0.size()));
+}
+
+int main() {
+  const float tolerance = 1e-3f;
+  int failures = 0;
+
+  const MLAS_CONV_ALGORITHM segmented = MlasConvAlgorithmExpandThenGemmSegmented;
+  const MLAS_CONV_ALGORITHM implicit_gemm = MlasConvAlgorithmImplicitGemm;
+  const MLAS_CONV_ALGORITHM winograd = MlasConvAlgorithmWinograd;
+  const MLAS_CONV_ALGORITHM depthwise = MlasConvAlgorithmDepthwise;
+  const MLAS_CONV_ALGORITHM nhwc = MlasConvAlgorithmNhwcGemm;
+
+  // convolutions split into more segments than MLAS_MAXIMUM_THREAD_COUNT
+  for (size_t threads : {3, 40}) {
+    MLAS_THREADPOOL* tp = MlasCreateThreadPool(threads);
+
+    float diff_conv = run_conv(tp, tp, same_shape(16, 32, 56, 56, 3, 3), segmented, false);
+
+    // prepared for a smaller thread pool, so there are fewer working buffers
+    // than threads
+    MLAS_THREADPOOL* prepare_tp = MlasCreateThreadPool(2);
+    diff_conv = std::max(diff_conv, run_conv(tp, prepare_tp, same_shape(16, 32, 56, 56, 3, 3), segmented, false));
+    MlasDestroyThreadPool(prepare_tp);
+
+    float diff_packed = std::max(run_conv(tp, tp, same_shape(16, 32, 56, 56, 3, 3), segmented, true),
+                                 run_conv(tp, tp, same_shape(40, 24, 30, 30, 3, 3), segmented, true));
+
+    // more filters than output elements selects the implicit GEMM, including
+    // small output blocks with more than one packed slice along K
+    float diff_implicit = 0.0f;
+    for (bool packed_filter : {false, true}) {
+      diff_implicit = std::max({diff_implicit,
+                                run_conv(tp, tp, same_shape(48, 96, 7, 9, 3, 3), implicit_gemm, packed_filter),
+                                run_conv(tp, tp, same_shape(64, 64, 4, 4, 3, 3), implicit_gemm, packed_filter),
+                                run_conv(tp, tp, same_shape(28, 40, 5, 6, 5, 4), implicit_gemm, packed_filter),
+                                run_conv(tp, tp, same_shape(100, 48, 3, 5, 3, 3), implicit_gemm, packed_filter)});
+    }
+
+    // 3x3 convolutions with enough channels select the Winograd algorithm,
+    // including output sizes that are not a multiple of the tile size
+    float diff_winograd = std::max({run_conv(tp, tp, same_shape(32, 48, 56, 56, 3, 3), winograd, false),
+                                    run_conv(tp, tp, same_shape(40, 36, 13, 17, 3, 3), winograd, false),
+                                    run_conv(tp, tp, same_shape(40, 36, 13, 17, 3, 3), winograd, true)});
+
+    // batched depthwise convolutions with asymmetric padding, including a
+    // partial block of channels
+    float diff_depthwise =
+        std::max(run_conv(tp, tp, {2, 32, 1, 1, 28, 28, 3, 3, 1, 1, {1, 1, 2, 2}}, depthwise, false),
+                 run_conv(tp, tp, {3, 13, 1, 1, 17, 19, 5, 5, 2, 1, {2, 2, 3, 3}}, depthwise, true, 0.5f));
+
+    // batched, grouped NHWC convolutions, pointwise and with expanded inputs
+    float diff_nhwc =
+        std::max({run_conv(tp, tp, {2, 1, 48, 40, 14, 14, 1, 1, 1, 1, {0, 0, 0, 0}}, nhwc, false, 0.0f, true),
+                  run_conv(tp, tp, {1, 2, 24, 20, 9, 11, 1, 1, 2, 1, {0, 0, 0, 0}}, nhwc, true, 0.5f, true),
+                  run_conv(tp, tp, {2, 2, 16, 24, 30, 30, 3, 3, 1, 1, {1, 1, 1, 1}}, nhwc, false, 0.0f, true),
+                  run_conv(tp, tp, {3, 1, 5, 33, 17, 13, 5, 5, 2, 1, {2, 2, 2, 2}}, nhwc, true, 0.5f, true)});
+
+    std::cout << "threads " << threads << ": conv " << diff_conv << ", packed filter: " << diff_packed
+              << ", implicit gemm: " << diff_implicit << ", winograd: " << diff_winograd
+              << ", depthwise: " << diff_depthwise << ", nhwc: " << diff_nhwc << std::endl;
+
+    if (diff_conv > tolerance || diff_packed > tolerance || diff_implicit > tolerance ||
+        diff_winograd > tolerance || diff_depthwise > tolerance || diff_nhwc > tolerance) {
+      failures++;
+    }
+
+    MlasDestroyThreadPool(tp);
+  }
+
+  return failures == 0 ? 0 : 1;
+}
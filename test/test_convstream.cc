@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "common.h"
+
+struct stream_shape {
+  int dimensions;  // 1 for [time], 2 for [time, width]
+  int groups;
+  int channels;
+  int filters;
+  int frames;  // total frames of the stream
+  int chunk;   // frames per call
+  int width;
+  int kernel_time;
+  int kernel_width;
+  int dilation_time;
+  int pad_width;
+  int stride_width;
+  bool nhwc;
+  bool packed_filter;
+};
+
+// Copies the frames [start, start + count) of a tensor with frame_count
+// frames of frame_size elements per channel to a tensor with dst_frames
+// frames at dst_start, in the NCHW or NHWC layout.
+static void copy_frames(const float* src, int src_frames, int src_start, float* dst, int dst_frames, int dst_start,
+                        int count, int channels, int frame_size, bool nhwc) {
+  if (nhwc) {
+    std::copy_n(src + size_t(src_start) * frame_size * channels, size_t(count) * frame_size * channels,
+                dst + size_t(dst_start) * frame_size * channels);
+    return;
+  }
+  for (int c = 0; c < channels; ++c) {
+    std::copy_n(src + (size_t(c) * src_frames + src_start) * frame_size, size_t(count) * frame_size,
+                dst + (size_t(c) * dst_frames + dst_start) * frame_size);
+  }
+}
+
+// Streams a sequence through MlasConvStream in chunks of frames, twice with a
+// reset in between, and returns the max abs diff against a single MlasConv of
+// the whole sequence with causal padding along the time dimension.
+static float run_stream(MLAS_THREADPOOL* tp, const stream_shape& s) {
+  const int dims = s.dimensions;
+  const int width = dims == 2 ? s.width : 1;
+  const int out_width = dims == 2 ? (s.width + 2 * s.pad_width - s.kernel_width) / s.stride_width + 1 : 1;
+  const int in_channels = s.groups * s.channels;
+  const int out_channels = s.groups * s.filters;
+  const int history = (s.kernel_time - 1) * s.dilation_time;
+  const int kernel_size = s.kernel_time * (dims == 2 ? s.kernel_width : 1);
+
+  std::vector<float> input(size_t(in_channels) * s.frames * width);
+  std::vector<float> filter(size_t(out_channels) * s.channels * kernel_size);
+  std::vector<float> bias(out_channels);
+
+  fill_pattern(input, 13, -0.5f);
+  fill_pattern(filter, 7, -0.5f);
+  fill_pattern(bias, 3);
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+
+  const int64_t kernel_shape[] = {s.kernel_time, s.kernel_width};
+  const int64_t dilation_shape[] = {s.dilation_time, 1};
+
+  // reference: the whole sequence with the causal padding at the start
+  std::vector<float> expected(size_t(out_channels) * s.frames * out_width);
+  {
+    const int64_t input_shape[] = {s.frames, s.width};
+    const int64_t output_shape[] = {s.frames, out_width};
+    const int64_t padding_1d[] = {history, 0};
+    const int64_t padding_2d[] = {history, s.pad_width, 0, s.pad_width};
+    const int64_t stride_shape[] = {1, s.stride_width};
+
+    MLAS_CONV_PARAMETERS parameters;
+    size_t working_buffer_size;
+
+    MlasConvPrepare(&parameters, dims, 1, s.groups, s.channels, input_shape, kernel_shape, dilation_shape,
+                    dims == 2 ? padding_2d : padding_1d, stride_shape, output_shape, s.filters, &activation,
+                    &working_buffer_size, 0.0f, tp, s.nhwc);
+
+    std::vector<float> working_buffer(working_buffer_size);
+
+    MlasConv(&parameters, input.data(), filter.data(), bias.data(), working_buffer.data(), expected.data(), tp);
+  }
+
+  const int64_t input_shape[] = {s.chunk, s.width};
+  const int64_t padding_1d[] = {0, 0};
+  const int64_t padding_2d[] = {0, s.pad_width, 0, s.pad_width};
+  const int64_t stride_shape[] = {1, s.stride_width};
+
+  MLAS_CONV_STREAM_PARAMETERS parameters;
+  size_t state_size;
+  size_t working_buffer_size;
+
+  MlasConvStreamPrepare(&parameters, dims, s.groups, s.channels, input_shape, kernel_shape, dilation_shape,
+                        dims == 2 ? padding_2d : padding_1d, stride_shape, s.filters, &activation, &state_size,
+                        &working_buffer_size, tp, s.nhwc);
+
+  if (parameters.HistoryFrames != size_t(history) || parameters.OutputFrameSize != size_t(out_width)) {
+    std::cout << "unexpected stream parameters" << std::endl;
+    return 1.0f;
+  }
+
+  std::vector<float> state(state_size, 99.0f);
+  std::vector<float> working_buffer(working_buffer_size);
+
+  // the packed filter is packed with MlasGemmPackB for NHWC and must be aligned
+  const size_t alignment = MlasGetPreferredBufferAlignment();
+  std::vector<uint8_t> packed_buffer(MlasConvPackFilterSize(&parameters.Conv) + alignment);
+  float* packed = reinterpret_cast<float*>((uintptr_t(packed_buffer.data()) + alignment - 1) & ~(alignment - 1));
+  const float* conv_filter = filter.data();
+
+  if (s.packed_filter) {
+    MlasConvPackFilter(&parameters.Conv, filter.data(), packed);
+    parameters.Conv.FilterIsPacked = true;
+    conv_filter = packed;
+  }
+
+  std::vector<float> chunk_input(size_t(in_channels) * s.chunk * width);
+  std::vector<float> chunk_output(size_t(out_channels) * s.chunk * out_width);
+  std::vector<float> output(expected.size());
+
+  float diff = 0.0f;
+
+  for (int pass = 0; pass < 2; ++pass) {
+    MlasConvStreamReset(&parameters, state.data());
+    std::fill(output.begin(), output.end(), 0.0f);
+
+    for (int t = 0; t < s.frames; t += s.chunk) {
+      copy_frames(input.data(), s.frames, t, chunk_input.data(), s.chunk, 0, s.chunk, in_channels, width, s.nhwc);
+      MlasConvStream(&parameters, chunk_input.data(), conv_filter, bias.data(), state.data(), working_buffer.data(),
+                     chunk_output.data(), tp);
+      copy_frames(chunk_output.data(), s.chunk, 0, output.data(), s.frames, t, s.chunk, out_channels, out_width,
+                  s.nhwc);
+    }
+
+    diff = std::max(diff, get_max_diff(expected.data(), output.data(), int(output.size())));
+  }
+
+  return diff;
+}
+
+int main() {
+  int failures = 0;
+  const float tolerance = 1e-4f;
+
+  const stream_shape shapes[] = {
+      // 1D dilated convolution, a frame and a few frames per call
+      {1, 1, 48, 48, 40, 1, 0, 3, 1, 2, 0, 1, false, false},
+      {1, 1, 48, 32, 40, 4, 0, 3, 1, 2, 0, 1, false, true},
+      // 2D convolution over time and frequency, as in test_conv2d
+      {2, 1, 48, 48, 20, 1, 40, 2, 3, 1, 1, 1, false, false},
+      // depthwise convolution with fewer frames per call than the history
+      {2, 16, 1, 1, 24, 3, 17, 3, 3, 2, 1, 1, false, false},
+      // NHWC convolution with a strided frequency dimension
+      {2, 2, 8, 12, 18, 2, 21, 3, 3, 1, 1, 2, true, false},
+      {2, 1, 24, 16, 12, 1, 9, 2, 1, 3, 0, 1, true, true},
+  };
+
+  for (size_t threads : {1, 3}) {
+    MLAS_THREADPOOL* tp = MlasCreateThreadPool(threads);
+
+    float diff = 0.0f;
+    for (const stream_shape& s : shapes) diff = std::max(diff, run_stream(tp, s));
+
+    std::cout << "threads " << threads << ", stream: " << diff << std::endl;
+
+    if (diff > tolerance) failures++;
+
+    MlasDestroyThreadPool(tp);
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "common.h"
+
+struct transpose_shape {
+  int dimensions;
+  int batch;
+  int groups;
+  int channels;  // input channels per group
+  int filters;   // output channels per group
+  int input[3];
+  int kernel[3];
+  int stride[3];
+  int dilation[3];
+  int pad_begin[3];
+  int pad_end[3];
+  int output_padding[3];
+  bool bias;
+};
+
+// Computes the transposed convolution by scattering each input element
+// times the filter to the output tensor.
+static void reference_conv_transpose(const transpose_shape& s, const int* output, const float* input,
+                                     const float* filter, const float* bias, float* result) {
+  int input_size = 1, output_size = 1, kernel_size = 1;
+  for (int d = 0; d < s.dimensions; ++d) {
+    input_size *= s.input[d];
+    output_size *= output[d];
+    kernel_size *= s.kernel[d];
+  }
+
+  for (int n = 0; n < s.batch; ++n) {
+    for (int g = 0; g < s.groups; ++g) {
+      float* out = result + size_t(n * s.groups + g) * s.filters * output_size;
+      for (int f = 0; f < s.filters; ++f) {
+        std::fill_n(out + size_t(f) * output_size, output_size, bias ? bias[g * s.filters + f] : 0.0f);
+      }
+      for (int c = 0; c < s.channels; ++c) {
+        const float* in = input + (size_t(n * s.groups + g) * s.channels + c) * input_size;
+        for (int i = 0; i < input_size; ++i) {
+          for (int f = 0; f < s.filters; ++f) {
+            const float* w = filter + (size_t(g * s.channels + c) * s.filters + f) * kernel_size;
+            for (int k = 0; k < kernel_size; ++k) {
+              int o = 0, ii = i, kk = k, in_stride = input_size, k_stride = kernel_size;
+              bool inside = true;
+              for (int d = 0; d < s.dimensions; ++d) {
+                in_stride /= s.input[d];
+                k_stride /= s.kernel[d];
+                const int x = ii / in_stride, kx = kk / k_stride;
+                ii %= in_stride;
+                kk %= k_stride;
+                const int ox = x * s.stride[d] - s.pad_begin[d] + kx * s.dilation[d];
+                if (ox < 0 || ox >= output[d]) inside = false;
+                o = o * output[d] + ox;
+              }
+              if (inside) out[size_t(f) * output_size + o] += in[i] * w[k];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+static float run_conv_transpose(MLAS_THREADPOOL* tp, const transpose_shape& s) {
+  int output[3];
+  int input_size = 1, output_size = 1, kernel_size = 1;
+  for (int d = 0; d < s.dimensions; ++d) {
+    output[d] = (s.input[d] - 1) * s.stride[d] - s.pad_begin[d] - s.pad_end[d] + (s.kernel[d] - 1) * s.dilation[d] +
+                1 + s.output_padding[d];
+    input_size *= s.input[d];
+    output_size *= output[d];
+    kernel_size *= s.kernel[d];
+  }
+
+  std::vector<float> input(size_t(s.batch) * s.groups * s.channels * input_size);
+  std::vector<float> filter(size_t(s.groups) * s.channels * s.filters * kernel_size);
+  std::vector<float> bias(size_t(s.groups) * s.filters);
+
+  fill_pattern(input, 13, -0.5f);
+  fill_pattern(filter, 7, -0.5f);
+  fill_pattern(bias, 3);
+
+  const float* bias_data = s.bias ? bias.data() : nullptr;
+
+  std::vector<float> expected(size_t(s.batch) * s.groups * s.filters * output_size);
+  reference_conv_transpose(s, output, input.data(), filter.data(), bias_data, expected.data());
+
+  int64_t input_shape[3], kernel_shape[3], dilation_shape[3], padding[6], stride_shape[3], output_shape[3];
+  for (int d = 0; d < s.dimensions; ++d) {
+    input_shape[d] = s.input[d];
+    kernel_shape[d] = s.kernel[d];
+    dilation_shape[d] = s.dilation[d];
+    padding[d] = s.pad_begin[d];
+    padding[d + s.dimensions] = s.pad_end[d];
+    stride_shape[d] = s.stride[d];
+    output_shape[d] = output[d];
+  }
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+
+  MLAS_CONV_TRANSPOSE_PARAMETERS parameters;
+  size_t working_buffer_size;
+
+  MlasConvTransposePrepare(&parameters, s.dimensions, s.batch, s.groups, s.channels, input_shape, kernel_shape,
+                           dilation_shape, padding, stride_shape, output_shape, s.filters, &activation,
+                           &working_buffer_size, tp);
+
+  std::vector<float> working_buffer(working_buffer_size);
+  std::vector<float> result(expected.size(), 99.0f);
+
+  MlasConvTranspose(&parameters, input.data(), filter.data(), bias_data, working_buffer.data(), result.data(), tp);
+
+  return get_max_diff(expected.data(), result.data(), int(result.size()));
+}
+
+int main() {
+  int failures = 0;
+  const float tolerance = 1e-4f;
+
+  const transpose_shape shapes[] = {
+      // 1D upsampling by the stride, with and without padding
+      {1, 2, 1, 16, 8, {37}, {4}, {2}, {1}, {1}, {1}, {0}, true},
+      {1, 1, 2, 6, 5, {20}, {3}, {3}, {2}, {0}, {2}, {1}, false},
+      // 2D unit stride, which accumulates with vectors
+      {2, 1, 1, 8, 12, {9, 23}, {3, 3}, {1, 1}, {1, 1}, {1, 1}, {1, 1}, {0, 0}, true},
+      // 2D strided and dilated, with output padding and groups
+      {2, 2, 3, 4, 3, {7, 11}, {3, 5}, {2, 3}, {2, 1}, {1, 2}, {0, 1}, {1, 2}, true},
+      // 2D depthwise with a kernel equal to the stride
+      {2, 1, 8, 1, 1, {6, 10}, {2, 2}, {2, 2}, {1, 1}, {0, 0}, {0, 0}, {0, 0}, false},
+      // 3D with mixed strides
+      {3, 1, 1, 5, 4, {3, 5, 6}, {3, 2, 3}, {1, 2, 2}, {1, 1, 2}, {1, 0, 1}, {1, 1, 0}, {0, 1, 1}, true},
+      {3, 2, 2, 3, 2, {4, 3, 9}, {2, 3, 3}, {2, 1, 1}, {1, 2, 1}, {0, 1, 1}, {0, 1, 1}, {1, 0, 0}, true},
+  };
+
+  for (size_t threads : {1, 3}) {
+    MLAS_THREADPOOL* tp = MlasCreateThreadPool(threads);
+
+    float diff = 0.0f;
+    for (const transpose_shape& s : shapes) diff = std::max(diff, run_conv_transpose(tp, s));
+
+    std::cout << "threads " << threads << ", conv transpose: " << diff << std::endl;
+
+    if (diff > tolerance) failures++;
+
+    MlasDestroyThreadPool(tp);
+  }
+
+  return failures == 0 ? 0 : 1;
+}
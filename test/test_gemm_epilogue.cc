@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "common.h"
+
+// Runs a GEMM with a fused bias and residual epilogue on the thread pool,
+// optionally with packed A and B, and returns the max abs diff against the
+// reference implementation.
+static float run_gemm_epilogue(MLAS_THREADPOOL* tp, int m, int n, int k, bool trans_a, bool packed_a, bool packed_b,
+                               MLAS_SGEMM_BIAS_KIND bias_kind) {
+  std::vector<float> A(size_t(m) * k);
+  std::vector<float> At(size_t(k) * m);
+  std::vector<float> B(size_t(k) * n);
+  std::vector<float> bias(bias_kind == MlasSgemmBiasPerRow ? m : n);
+  std::vector<float> residual(size_t(m) * (n + 3));
+  std::vector<float> C0(size_t(m) * n);
+  std::vector<float> C1(size_t(m) * n, 1.0f);
+
+  fill_pattern(A, 13, -0.5f);
+  fill_pattern(B, 7, -0.5f);
+  for (size_t i = 0; i < bias.size(); ++i) bias[i] = float(i % 5) - 2.0f;
+  for (size_t i = 0; i < residual.size(); ++i) residual[i] = float(i % 3);
+
+  for (int i = 0; i < m; ++i)
+    for (int p = 0; p < k; ++p) At[size_t(p) * m + i] = A[size_t(i) * k + p];
+
+  sgemm_ref(A.data(), B.data(), C0.data(), m, n, k);
+
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < n; ++j) {
+      C0[size_t(i) * n + j] += bias[bias_kind == MlasSgemmBiasPerRow ? i : j] + residual[size_t(i) * (n + 3) + j];
+    }
+  }
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+
+  MLAS_SGEMM_EPILOGUE epilogue;
+  epilogue.Bias = bias.data();
+  epilogue.BiasKind = bias_kind;
+  epilogue.Activation = &activation;
+  epilogue.Residual = residual.data();
+  epilogue.ldr = n + 3;
+
+  // the packed buffer must be aligned for the kernels
+  const size_t alignment = MlasGetPreferredBufferAlignment();
+  std::vector<uint8_t> packed_buffer(packed_b ? MlasGemmPackBSize(n, k) + alignment : 0);
+  void* packed = reinterpret_cast<void*>((uintptr_t(packed_buffer.data()) + alignment - 1) & ~(alignment - 1));
+
+  MLAS_SGEMM_DATA_PARAMS data;
+  data.A = trans_a ? At.data() : A.data();
+  data.lda = trans_a ? m : k;
+  data.B = B.data();
+  data.ldb = n;
+  data.C = C1.data();
+  data.ldc = n;
+  data.Epilogue = &epilogue;
+
+  if (packed_b) {
+    MlasGemmPackB(CblasNoTrans, n, k, B.data(), n, packed);
+    data.B = static_cast<const float*>(packed);
+    data.BIsPacked = true;
+  }
+
+  std::vector<float> packed_A(packed_a ? MlasGemmPackASize(m, k) / sizeof(float) : 0);
+
+  if (packed_a) {
+    MlasGemmPackA(trans_a ? CblasTrans : CblasNoTrans, m, k, data.A, data.lda, packed_A.data());
+    data.A = packed_A.data();
+    data.AIsPacked = true;
+  }
+
+  MlasGemmBatch(trans_a ? CblasTrans : CblasNoTrans, CblasNoTrans, m, n, k, &data, 1, tp);
+
+  return get_max_diff(C0.data(), C1.data(), int(C0.size()));
+}
+
+int main() {
+  const float tolerance = 1e-3f;
+  int failures = 0;
+
+  for (size_t threads : {1, 3}) {
+    MLAS_THREADPOOL* tp = MlasCreateThreadPool(threads);
+
+    float diff_epilogue = std::max({run_gemm_epilogue(tp, 130, 300, 70, false, false, false, MlasSgemmBiasPerRow),
+                                    run_gemm_epilogue(tp, 130, 300, 300, true, false, false, MlasSgemmBiasPerColumn),
+                                    run_gemm_epilogue(tp, 97, 260, 600, false, false, true, MlasSgemmBiasPerColumn),
+                                    run_gemm_epilogue(tp, 1, 100, 64, false, false, false, MlasSgemmBiasPerColumn)});
+
+    float diff_packed_a = std::max({run_gemm_epilogue(tp, 130, 300, 70, false, true, false, MlasSgemmBiasPerRow),
+                                    run_gemm_epilogue(tp, 75, 200, 700, true, true, false, MlasSgemmBiasPerRow),
+                                    run_gemm_epilogue(tp, 97, 260, 600, false, true, true, MlasSgemmBiasPerColumn)});
+
+    std::cout << "threads " << threads << ": epilogue " << diff_epilogue << ", packed a: " << diff_packed_a
+              << std::endl;
+
+    if (diff_epilogue > tolerance || diff_packed_a > tolerance) failures++;
+
+    MlasDestroyThreadPool(tp);
+  }
+
+  return failures == 0 ? 0 : 1;
+}
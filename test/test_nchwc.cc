@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "common.h"
+
+struct conv_shape {
+  int batch;
+  int groups;
+  int channels;  // per group
+  int filters;   // per group
+  int height;
+  int width;
+  int kernel;
+  int stride;
+  int dilation;
+  int pads[4];  // top, left, bottom, right
+  bool relu;
+};
+
+// Reorders a NCHW tensor to NCHWc.
+static std::vector<float> to_nchwc(const float* src, int batch, int channels, size_t spatial, int bs) {
+  std::vector<float> dst(size_t(batch) * channels * spatial);
+  for (int n = 0; n < batch; ++n) {
+    for (int c = 0; c < channels; ++c) {
+      for (size_t p = 0; p < spatial; ++p) {
+        dst[((size_t(n) * (channels / bs) + c / bs) * spatial + p) * bs + c % bs] =
+            src[(size_t(n) * channels + c) * spatial + p];
+      }
+    }
+  }
+  return dst;
+}
+
+// Runs the NCHWc convolution for the shape on the thread pool, optionally
+// accumulating into an existing output, and returns the max abs diff against
+// the reference implementation.
+static float run_nchwc_conv(MLAS_THREADPOOL* tp, const conv_shape& s, bool zero_mode) {
+  const conv2d_shape shape = {s.batch, s.groups, s.channels, s.filters, s.height, s.width, s.kernel, s.kernel,
+                              s.stride, s.dilation, {s.pads[0], s.pads[1], s.pads[2], s.pads[3]}};
+
+  const int bs = int(MlasNchwcGetBlockSize());
+  const int out_h = conv2d_output_height(shape);
+  const int out_w = conv2d_output_width(shape);
+  const int in_channels = s.groups * s.channels;
+  const int out_channels = s.groups * s.filters;
+  const size_t kernel_size = size_t(s.kernel) * s.kernel;
+  const size_t out_size = size_t(out_h) * out_w;
+
+  std::vector<float> input(size_t(s.batch) * in_channels * s.height * s.width);
+  std::vector<float> filter(size_t(out_channels) * s.channels * kernel_size);
+  std::vector<float> bias(out_channels);
+  std::vector<float> output0(size_t(s.batch) * out_channels * out_size);
+
+  fill_pattern(input, 13, -0.5f);
+  fill_pattern(filter, 7, -0.5f);
+  fill_pattern(bias, 3, -0.3f);
+  if (!zero_mode) {
+    fill_pattern(output0, 5);
+  }
+
+  std::vector<float> output1 = to_nchwc(output0.data(), s.batch, out_channels, out_size, bs);
+
+  conv2d_ref(shape, input.data(), filter.data(), bias.data(), 1.0f, output0.data());
+  if (s.relu) {
+    for (float& out : output0) out = std::max(out, 0.0f);
+  }
+
+  // a NCHW input is used when a group has fewer channels than a block,
+  // except for depthwise convolutions
+  const bool depthwise = (s.channels == 1 && s.filters == 1);
+  const bool nchw_input = (s.channels < bs && !depthwise);
+
+  if (!nchw_input) {
+    input = to_nchwc(input.data(), s.batch, in_channels, size_t(s.height) * s.width, bs);
+  }
+
+  // filters are OIHWBiBo for a NCHWc input, else OIHWBo
+  std::vector<float> blocked_filter(filter.size());
+  const int blocks = out_channels / bs;
+
+  for (int ob = 0; ob < blocks; ++ob) {
+    for (int o = 0; o < bs; ++o) {
+      for (int c = 0; c < s.channels; ++c) {
+        for (size_t k = 0; k < kernel_size; ++k) {
+          size_t dst;
+          if (nchw_input || depthwise) {
+            dst = ((size_t(ob) * s.channels + c) * kernel_size + k) * bs + o;
+          } else {
+            dst = (((size_t(ob) * (s.channels / bs) + c / bs) * kernel_size + k) * bs + c % bs) * bs + o;
+          }
+          blocked_filter[dst] = filter[((size_t(ob) * bs + o) * s.channels + c) * kernel_size + k];
+        }
+      }
+    }
+  }
+
+  const int64_t input_shape[] = {s.batch, in_channels, s.height, s.width};
+  const int64_t kernel_shape[] = {s.kernel, s.kernel};
+  const int64_t dilation_shape[] = {s.dilation, s.dilation};
+  const int64_t padding[] = {s.pads[0], s.pads[1], s.pads[2], s.pads[3]};
+  const int64_t stride_shape[] = {s.stride, s.stride};
+  const int64_t output_shape[] = {s.batch, out_channels, out_h, out_w};
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = s.relu ? MlasReluActivation : MlasIdentityActivation;
+
+  MlasNchwcConv(input_shape, kernel_shape, dilation_shape, padding, stride_shape, output_shape, size_t(s.groups),
+                input.data(), blocked_filter.data(), bias.data(), output1.data(), &activation, zero_mode, tp);
+
+  std::vector<float> expected = to_nchwc(output0.data(), s.batch, out_channels, out_size, bs);
+
+  return get_max_diff(expected.data(), output1.data(), int(expected.size()));
+}
+
+int main() {
+  const float tolerance = 1e-3f;
+  int failures = 0;
+
+  const conv_shape shapes[] = {
+      // NCHWc input: a single filter set, then a partial second filter set
+      {1, 1, 16, 24, 14, 15, 3, 1, 1, {1, 1, 1, 1}, false},
+      {2, 1, 16, 40, 17, 13, 3, 2, 2, {2, 1, 0, 3}, true},
+      // grouped NCHWc input
+      {1, 2, 8, 16, 9, 11, 5, 1, 1, {2, 2, 2, 2}, true},
+      // pointwise, including a second batch of input channels
+      {2, 1, 136, 32, 7, 9, 1, 1, 1, {0, 0, 0, 0}, false},
+      {1, 1, 16, 16, 10, 10, 1, 2, 1, {0, 0, 0, 0}, true},
+      // depthwise
+      {2, 24, 1, 1, 12, 13, 3, 1, 1, {1, 1, 1, 1}, false},
+      {1, 16, 1, 1, 11, 11, 3, 2, 1, {0, 1, 1, 0}, true},
+      // NCHW input, as for the first layer of a model
+      {1, 1, 3, 16, 23, 23, 7, 2, 1, {3, 3, 3, 3}, true},
+  };
+
+  for (size_t threads : {1, 3}) {
+    MLAS_THREADPOOL* tp = MlasCreateThreadPool(threads);
+
+    for (size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); ++i) {
+      float diff = std::max(run_nchwc_conv(tp, shapes[i], true), run_nchwc_conv(tp, shapes[i], false));
+
+      std::cout << "threads " << threads << ", shape " << i << ": " << diff << std::endl;
+
+      if (diff > tolerance) failures++;
+    }
+
+    MlasDestroyThreadPool(tp);
+  }
+
+  return failures == 0 ? 0 : 1;
+}
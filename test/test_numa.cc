@@ -0,0 +1,76 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "common.h"
+
+// Packs B with the placement, runs the GEMM on the thread pool and returns
+// the max abs diff against the reference implementation.
+static float run_packed_gemm(MLAS_THREADPOOL* tp, MLAS_NUMA_PLACEMENT placement, int m, int n, int k) {
+  std::vector<float> A(size_t(m) * k);
+  std::vector<float> B(size_t(k) * n);
+  std::vector<float> C0(size_t(m) * n);
+  std::vector<float> C1(size_t(m) * n);
+
+  fill_pattern(A, 13, -0.5f);
+  fill_pattern(B, 7, -0.5f);
+
+  sgemm_ref(A.data(), B.data(), C0.data(), m, n, k);
+
+  // the packed buffer must be aligned for the kernels
+  const size_t alignment = MlasGetPreferredBufferAlignment();
+  std::vector<uint8_t> buffer(MlasGemmPackBSize(n, k, placement) + alignment);
+  void* packed = reinterpret_cast<void*>((uintptr_t(buffer.data()) + alignment - 1) & ~(alignment - 1));
+
+  MlasGemmPackB(CblasNoTrans, n, k, B.data(), n, packed, placement);
+
+  MLAS_SGEMM_DATA_PARAMS data;
+  data.A = A.data();
+  data.lda = k;
+  data.B = static_cast<const float*>(packed);
+  data.C = C1.data();
+  data.ldc = n;
+  data.BIsPacked = true;
+  data.BNumaPlacement = placement;
+
+  MlasGemmBatch(CblasNoTrans, CblasNoTrans, m, n, k, &data, 1, tp);
+
+  return get_max_diff(C0.data(), C1.data(), int(C0.size()));
+}
+
+int main() {
+  // simulate two NUMA nodes, so that the pool assigns its threads to both
+  // nodes and replicated buffers hold two copies
+  setenv("MLAS_NUMA_NODES", "2", 1);
+
+  const float tolerance = 1e-3f;
+  int failures = 0;
+
+  if (MlasGemmPackBSize(300, 200, MlasNumaPlacementReplicate) < 2 * MlasGemmPackBSize(300, 200)) {
+    std::cout << "replicated buffer does not hold a copy per node" << std::endl;
+    failures++;
+  }
+
+  for (size_t threads : {1, 2, 5}) {
+    MLAS_THREADPOOL* tp = MlasCreateThreadPool(threads);
+
+    float diff_default = run_packed_gemm(tp, MlasNumaPlacementDefault, 256, 300, 200);
+    float diff_interleave = run_packed_gemm(tp, MlasNumaPlacementInterleave, 256, 300, 200);
+    float diff_replicate = run_packed_gemm(tp, MlasNumaPlacementReplicate, 256, 300, 200);
+    float diff_small = run_packed_gemm(tp, MlasNumaPlacementReplicate, 7, 5, 3);
+
+    std::cout << "threads " << threads << ": default " << diff_default << ", interleave " << diff_interleave
+              << ", replicate " << diff_replicate << ", small " << diff_small << std::endl;
+
+    if (diff_default > tolerance || diff_interleave > tolerance || diff_replicate > tolerance ||
+        diff_small > tolerance) {
+      failures++;
+    }
+
+    MlasDestroyThreadPool(tp);
+  }
+
+  return failures == 0 ? 0 : 1;
+}
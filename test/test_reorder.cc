@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "common.h"
+
+static std::vector<float> make_buffer(size_t size) {
+  std::vector<float> buffer(size);
+  for (size_t i = 0; i < size; ++i) buffer[i] = float(i % 97) - 48.0f;
+  return buffer;
+}
+
+// Reorders NCHW to NCHWc and back, and NCHWc to NHWC and back, and returns
+// the max abs diff against the reference layouts.
+static float run_reorder_tensor(MLAS_THREADPOOL* tp, int batch, int channels, int height, int width) {
+  const int bs = int(MlasNchwcGetBlockSize());
+  const int blocks = (channels + bs - 1) / bs;
+  const size_t spatial = size_t(height) * width;
+
+  std::vector<float> nchw = make_buffer(size_t(batch) * channels * spatial);
+  std::vector<float> expected_nchwc(size_t(batch) * blocks * bs * spatial, 0.0f);
+  std::vector<float> expected_nhwc(nchw.size());
+
+  for (int n = 0; n < batch; ++n) {
+    for (int c = 0; c < channels; ++c) {
+      for (size_t p = 0; p < spatial; ++p) {
+        float v = nchw[(size_t(n) * channels + c) * spatial + p];
+        expected_nchwc[((size_t(n) * blocks + c / bs) * spatial + p) * bs + c % bs] = v;
+        expected_nhwc[(size_t(n) * spatial + p) * channels + c] = v;
+      }
+    }
+  }
+
+  const int64_t shape[] = {batch, channels, height, width};
+
+  // fill with garbage so that the zero padding is checked
+  std::vector<float> nchwc(expected_nchwc.size(), 99.0f);
+  MlasReorderInputNchw(shape, nchw.data(), nchwc.data(), tp);
+  float diff = get_max_diff(expected_nchwc.data(), nchwc.data(), int(nchwc.size()));
+
+  std::vector<float> output(nchw.size(), 99.0f);
+  MlasReorderOutputNchw(shape, nchwc.data(), output.data(), tp);
+  diff = std::max(diff, get_max_diff(nchw.data(), output.data(), int(output.size())));
+
+  std::fill(output.begin(), output.end(), 99.0f);
+  MlasReorderOutputNhwc(shape, nchwc.data(), output.data(), tp);
+  diff = std::max(diff, get_max_diff(expected_nhwc.data(), output.data(), int(output.size())));
+
+  // reorder the NHWC tensor back to NCHWc in two segments of rows
+  std::fill(nchwc.begin(), nchwc.end(), 99.0f);
+  for (int n = 0; n < batch; ++n) {
+    const float* s = expected_nhwc.data() + size_t(n) * spatial * channels;
+    float* d = nchwc.data() + size_t(n) * blocks * bs * spatial;
+    size_t rows = spatial / 3;
+    MlasReorderInputNhwc(s, d, size_t(channels), rows, spatial);
+    MlasReorderInputNhwc(s + rows * channels, d + rows * bs, size_t(channels), spatial - rows, spatial);
+  }
+  diff = std::max(diff, get_max_diff(expected_nchwc.data(), nchwc.data(), int(nchwc.size())));
+
+  return diff;
+}
+
+// Reorders an OIHW filter to OIHWBiBo and OIHWBo and returns the max abs diff
+// against the reference layouts.
+static float run_reorder_filter(int outputs, int inputs, int kernel) {
+  const int bs = int(MlasNchwcGetBlockSize());
+  const int oblocks = (outputs + bs - 1) / bs;
+  const int iblocks = (inputs + bs - 1) / bs;
+  const size_t ksize = size_t(kernel) * kernel;
+
+  std::vector<float> filter = make_buffer(size_t(outputs) * inputs * ksize);
+  std::vector<float> expected_bibo(size_t(oblocks) * iblocks * ksize * bs * bs, 0.0f);
+  std::vector<float> expected_bo(size_t(oblocks) * inputs * ksize * bs, 0.0f);
+
+  for (int o = 0; o < outputs; ++o) {
+    for (int i = 0; i < inputs; ++i) {
+      for (size_t k = 0; k < ksize; ++k) {
+        float v = filter[(size_t(o) * inputs + i) * ksize + k];
+        expected_bibo[(((size_t(o / bs) * iblocks + i / bs) * ksize + k) * bs + i % bs) * bs + o % bs] = v;
+        expected_bo[((size_t(o / bs) * inputs + i) * ksize + k) * bs + o % bs] = v;
+      }
+    }
+  }
+
+  const int64_t shape[] = {outputs, inputs, kernel, kernel};
+
+  std::vector<float> bibo(expected_bibo.size(), 99.0f);
+  MlasReorderFilterOIHWBiBo(shape, filter.data(), bibo.data());
+  float diff = get_max_diff(expected_bibo.data(), bibo.data(), int(bibo.size()));
+
+  std::vector<float> bo(expected_bo.size(), 99.0f);
+  MlasReorderFilterOIHWBo(shape, filter.data(), bo.data());
+  diff = std::max(diff, get_max_diff(expected_bo.data(), bo.data(), int(bo.size())));
+
+  return diff;
+}
+
+int main() {
+  int failures = 0;
+
+  for (size_t threads : {1, 3}) {
+    MLAS_THREADPOOL* tp = MlasCreateThreadPool(threads);
+
+    // full blocks, a partial block, fewer channels than a block, and a
+    // tensor large enough to be partitioned across the threads
+    float diff = std::max(run_reorder_tensor(tp, 1, 16, 7, 9), run_reorder_tensor(tp, 2, 21, 5, 6));
+    diff = std::max(diff, run_reorder_tensor(tp, 3, 3, 11, 13));
+    diff = std::max(diff, run_reorder_tensor(tp, 2, 37, 64, 65));
+
+    std::cout << "threads " << threads << ", tensor reorder: " << diff << std::endl;
+
+    if (diff != 0.0f) failures++;
+
+    MlasDestroyThreadPool(tp);
+  }
+
+  float diff = std::max(run_reorder_filter(16, 16, 3), run_reorder_filter(20, 13, 3));
+  diff = std::max(diff, run_reorder_filter(24, 1, 5));
+  diff = std::max(diff, run_reorder_filter(40, 136, 1));
+
+  std::cout << "filter reorder: " << diff << std::endl;
+
+  if (diff != 0.0f) failures++;
+
+  return failures == 0 ? 0 : 1;
+}
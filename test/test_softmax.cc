@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "common.h"
+
+static void reference_softmax(const float* input, float* output, size_t n, size_t d, bool log_softmax) {
+  for (size_t i = 0; i < n; ++i) {
+    const float* x = input + i * d;
+    float* y = output + i * d;
+
+    double maximum = *std::max_element(x, x + d);
+    double sum = 0.0;
+    for (size_t j = 0; j < d; ++j) sum += std::exp(x[j] - maximum);
+
+    for (size_t j = 0; j < d; ++j) {
+      y[j] = log_softmax ? float(x[j] - maximum - std::log(sum)) : float(std::exp(x[j] - maximum) / sum);
+    }
+  }
+}
+
+// Returns the max abs diff of the routine against the reference. The rows
+// have different maximums so that a row is not normalized with the maximum
+// of another row or segment.
+static float run_softmax(MLAS_THREADPOOL* tp, size_t n, size_t d, bool log_softmax) {
+  std::vector<float> input(n * d);
+  std::vector<float> expected(input.size());
+  std::vector<float> output(input.size(), 99.0f);
+
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = float(int((i * 7919) % 4001) - 2000) * 0.01f + float(i / d % 5) * 30.0f;
+  }
+
+  reference_softmax(input.data(), expected.data(), n, d, log_softmax);
+
+  MlasComputeSoftmax(input.data(), output.data(), n, d, log_softmax, tp);
+
+  return get_max_diff(expected.data(), output.data(), int(output.size()));
+}
+
+int main() {
+  int failures = 0;
+
+  struct {
+    size_t n;
+    size_t d;
+  } shapes[] = {
+      // the vector remainders of short rows
+      {3, 1},
+      {5, 7},
+      {4, 33},
+      {2, 1000},
+      // enough rows to parallelize over rows
+      {64, 2049},
+      // fewer rows than threads, which splits the rows in segments
+      {1, 200003},
+      {2, 50257},
+  };
+
+  for (size_t threads : {1, 3}) {
+    MLAS_THREADPOOL* tp = MlasCreateThreadPool(threads);
+
+    for (bool log_softmax : {false, true}) {
+      float diff = 0.0f;
+      for (const auto& s : shapes) diff = std::max(diff, run_softmax(tp, s.n, s.d, log_softmax));
+
+      std::cout << "threads " << threads << (log_softmax ? ", log softmax: " : ", softmax: ") << diff << std::endl;
+
+      // the log softmax is compared in absolute terms for outputs as large
+      // as -40, which is within a few ulp
+      if (diff > (log_softmax ? 2e-5f : 1e-6f)) failures++;
+    }
+
+    MlasDestroyThreadPool(tp);
+  }
+
+  return failures == 0 ? 0 : 1;
+}
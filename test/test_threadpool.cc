@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "../inc/mlas.h"
+#include "common.h"
+
+// Runs a batch of GEMMs on the thread pool and returns the max abs diff
+// against the reference implementation.
+static float run_gemm_batch(MLAS_THREADPOOL* tp, int m, int n, int k, int batch) {
+  std::vector<float> A(size_t(batch) * m * k);
+  std::vector<float> B(size_t(batch) * k * n);
+  std::vector<float> C0(size_t(batch) * m * n);
+  std::vector<float> C1(size_t(batch) * m * n);
+
+  fill_pattern(A, 13, -0.5f);
+  fill_pattern(B, 7, -0.5f);
+
+  std::vector<MLAS_SGEMM_DATA_PARAMS> data(batch);
+
+  for (int b = 0; b < batch; ++b) {
+    sgemm_ref(&A[size_t(b) * m * k], &B[size_t(b) * k * n], &C0[size_t(b) * m * n], m, n, k);
+
+    data[b].A = &A[size_t(b) * m * k];
+    data[b].lda = k;
+    data[b].B = &B[size_t(b) * k * n];
+    data[b].ldb = n;
+    data[b].C = &C1[size_t(b) * m * n];
+    data[b].ldc = n;
+  }
+
+  MlasGemmBatch(CblasNoTrans, CblasNoTrans, m, n, k, data.data(), batch, tp);
+
+  return get_max_diff(C0.data(), C1.data(), int(C0.size()));
+}
+
+// Chains two asynchronous GEMMs, D = (A * B) * E, and returns the max abs
+// diff against the reference implementation.
+static float run_gemm_async(MLAS_THREADPOOL* tp, int m, int n, int k) {
+  std::vector<float> A(size_t(m) * k);
+  std::vector<float> B(size_t(k) * n);
+  std::vector<float> E(size_t(n) * n);
+  std::vector<float> C(size_t(m) * n);
+  std::vector<float> D0(size_t(m) * n);
+  std::vector<float> D1(size_t(m) * n);
+
+  fill_pattern(A, 13, -0.5f);
+  fill_pattern(B, 7, -0.5f);
+  fill_pattern(E, 5, -0.5f);
+
+  sgemm_ref(A.data(), B.data(), C.data(), m, n, k);
+  sgemm_ref(C.data(), E.data(), D0.data(), m, n, n);
+  std::fill(C.begin(), C.end(), 0.0f);
+
+  MLAS_SGEMM_DATA_PARAMS first;
+  first.A = A.data();
+  first.lda = k;
+  first.B = B.data();
+  first.ldb = n;
+  first.C = C.data();
+  first.ldc = n;
+
+  MLAS_SGEMM_DATA_PARAMS second;
+  second.A = C.data();
+  second.lda = n;
+  second.B = E.data();
+  second.ldb = n;
+  second.C = D1.data();
+  second.ldc = n;
+
+  MLAS_TASK* task1 = MlasGemmBatchAsync(CblasNoTrans, CblasNoTrans, m, n, k, &first, 1, tp);
+  MLAS_TASK* task2 = MlasGemmBatchAsync(CblasNoTrans, CblasNoTrans, m, n, n, &second, 1, tp, task1);
+
+  // the second task keeps its predecessor alive
+  MlasReleaseTask(task1);
+
+  MlasWaitTask(task2);
+
+  if (!MlasIsTaskComplete(task2)) return 1e9f;
+
+  MlasReleaseTask(task2);
+
+  return get_max_diff(D0.data(), D1.data(), int(D0.size()));
+}
+
+// Packs matrix B on the thread pool and returns whether the packed buffer is
+// identical to the buffer packed on a single thread.
+static bool run_pack_b(MLAS_THREADPOOL* tp, CBLAS_TRANSPOSE trans, size_t n, size_t k) {
+  const size_t ldb = (trans == CblasNoTrans) ? n : k;
+
+  std::vector<float> B(n * k);
+  for (size_t i = 0; i < B.size(); ++i) B[i] = float(i % 11) - 5.0f;
+
+  const size_t size = MlasGemmPackBSize(n, k) / sizeof(float);
+  std::vector<float> packed0(size);
+  std::vector<float> packed1(size);
+
+  MlasGemmPackB(trans, n, k, B.data(), ldb, packed0.data());
+  MlasGemmPackB(trans, n, k, B.data(), ldb, packed1.data(), tp);
+
+  return packed0 == packed1;
+}
+
+int main() {
+  const float tolerance = 1e-3f;
+  int failures = 0;
+
+  // explicit pools of various sizes, including the single threaded case
+  for (size_t threads : {1, 2, 4, 7}) {
+    MLAS_THREADPOOL* tp = MlasCreateThreadPool(threads);
+
+    float diff = run_gemm_batch(tp, 256, 320, 96, 1);
+    float diff_batch = run_gemm_batch(tp, 33, 70, 40, 5);
+    // A and B both exceed the L2 cache, so the GEMM is split as a 2D grid
+    float diff_2d = run_gemm_batch(tp, 200, 224, 3000, 1);
+
+    float diff_async = run_gemm_async(tp, 150, 96, 80);
+
+    bool pack_ok = run_pack_b(tp, CblasNoTrans, 1000, 700) && run_pack_b(tp, CblasTrans, 1000, 700) &&
+                   run_pack_b(tp, CblasNoTrans, 3001, 530) && run_pack_b(tp, CblasTrans, 77, 9000);
+
+    std::cout << "threads " << threads << ": " << diff << ", batch: " << diff_batch
+              << ", 2d: " << diff_2d << ", async: " << diff_async << ", pack: " << (pack_ok ? "ok" : "mismatch")
+              << std::endl;
+
+    if (diff > tolerance || diff_batch > tolerance || diff_2d > tolerance || diff_async > tolerance || !pack_ok) {
+      failures++;
+    }
+
+    MlasDestroyThreadPool(tp);
+  }
+
+  // default pool shared by concurrent callers
+  std::vector<float> diffs(4);
+  std::vector<std::thread> callers;
+
+  for (size_t i = 0; i < diffs.size(); ++i) {
+    callers.emplace_back([&diffs, i]() { diffs[i] = run_gemm_batch(nullptr, 128, 200, 64, 2); });
+  }
+
+  for (auto& caller : callers) caller.join();
+
+  for (float diff : diffs) {
+    std::cout << "default pool: " << diff << std::endl;
+    if (diff > tolerance) failures++;
+  }
+
+  // asynchronous operation on the default pool
+  float diff_async = run_gemm_async(nullptr, 64, 48, 32);
+  std::cout << "default pool async: " << diff_async << std::endl;
+  if (diff_async > tolerance) failures++;
+
+  return failures == 0 ? 0 : 1;
+}